@@ -0,0 +1,100 @@
+// Hex dump microbenchmark: the encoder in shared/hex against the implementations it replaced.
+//
+//   - ostringstream : hex_dump before the encoder (std::setw(2) per byte)
+//   - snprintf      : the "%02X " loop Hook_Win32 used for injected sends
+//   - table         : shared::hex, 256-entry table only
+//   - encode        : shared::hex::encode (SIMD level ARKAN_HEX_SIMD of this build)
+//
+// Each case formats the same random packets into a caller buffer and reports ns/packet and MB/s
+// of input.
+//
+// usage: bench_hex [payload=64] [iterations=2000000]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "shared/hex/Hex.hpp"
+
+namespace hex = arkan::relay::shared::hex;
+
+namespace
+{
+
+std::size_t legacy_ostringstream(std::span<const std::byte> in, char* out)
+{
+  std::ostringstream oss;
+  oss << std::hex << std::uppercase << std::setfill('0');
+  for (std::byte b : in) oss << std::setw(2) << std::to_integer<unsigned>(b) << ' ';
+  const std::string s = oss.str();
+  std::memcpy(out, s.data(), s.size());
+  return s.size();
+}
+
+std::size_t legacy_snprintf(std::span<const std::byte> in, char* out)
+{
+  std::size_t p = 0;
+  for (std::byte b : in) p += std::snprintf(out + p, 4, "%02X ", std::to_integer<unsigned>(b));
+  return p;
+}
+
+std::size_t table(std::span<const std::byte> in, char* out)
+{
+  hex::detail::encode_scalar(in.data(), in.size(), out);
+  return hex::encoded_size(in.size());
+}
+
+std::size_t simd(std::span<const std::byte> in, char* out)
+{
+  return hex::encode(in, out);
+}
+
+template <class F>
+void run(const char* name, F f, const std::vector<std::byte>& data, std::size_t payload,
+         std::size_t iterations)
+{
+  std::vector<char> out(hex::encoded_size(payload) + 1);
+  const std::size_t packets = data.size() / payload;
+  std::size_t sink = 0;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i)
+  {
+    const std::span<const std::byte> in(data.data() + (i % packets) * payload, payload);
+    sink += f(in, out.data());
+    sink += static_cast<unsigned char>(out[i % out.size()]);
+  }
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::printf("  %-14s %8.1f ns/packet %9.1f MB/s   (%zu)\n", name, s * 1e9 / iterations,
+              payload * static_cast<double>(iterations) / s / 1e6, sink % 10);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t payload = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+  const std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000000;
+  if (payload == 0) return 1;
+
+  std::vector<std::byte> data(payload * 256);
+  std::mt19937 rng(42);
+  for (auto& b : data) b = static_cast<std::byte>(rng() & 0xFF);
+
+  std::printf("hex dump: payload=%zu iterations=%zu ARKAN_HEX_SIMD=%d\n", payload, iterations,
+              ARKAN_HEX_SIMD);
+  run("ostringstream", legacy_ostringstream, data, payload, iterations / 10);
+  run("snprintf", legacy_snprintf, data, payload, iterations / 10);
+  run("table", table, data, payload, iterations);
+  run("encode", simd, data, payload, iterations);
+  return 0;
+}
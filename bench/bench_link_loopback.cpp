@@ -0,0 +1,219 @@
+// Loopback benchmark for the Kore link write path.
+//
+// Pushes a burst of 'R' frames through KoreLink_Asio to a local sink that parses the R/S/K
+// envelope, and reports frames/s plus writes (≈ send syscalls) per frame for:
+//   - legacy : one write per frame (write batch limit = 1, the pre-ring behaviour)
+//   - gather : every queued frame handed to one gathered write
+// and, for frames arriving one at a time (the I/O thread idles between them), the p50/p99
+// emit -> write latency with the I/O thread blocking vs. busy-polling:
+//   - block  : the pool worker sleeps in the completion queue between frames
+//   - spin   : the pool worker busy-polls for 500us before sleeping
+//
+// usage: bench_link_loopback [frames=200000] [payload=64]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "application/ports/ILogger.hpp"
+#include "infrastructure/link/KoreLink_Asio.hpp"
+#include "infrastructure/net/IoPool.hpp"
+
+using tcp = boost::asio::ip::tcp;
+using arkan::relay::infrastructure::link::KoreLink_Asio;
+
+namespace
+{
+
+struct NullLogger : arkan::relay::application::ports::ILogger
+{
+  using LogLevel = arkan::relay::application::ports::LogLevel;
+  void init(const arkan::relay::domain::Settings&) override {}
+  void app(LogLevel, const std::string&) override {}
+  void sock(LogLevel, std::string_view) override {}
+};
+
+// Accepts one connection and counts complete frames until `expect` were seen.
+class SinkServer
+{
+ public:
+  uint16_t start(std::size_t expect)
+  {
+    expect_ = expect;
+    tcp::endpoint ep{boost::asio::ip::make_address("127.0.0.1"), 0};
+    acceptor_.open(ep.protocol());
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor_.bind(ep);
+    acceptor_.listen();
+    th_ = std::thread([this] { run_(); });
+    return acceptor_.local_endpoint().port();
+  }
+
+  void join()
+  {
+    if (th_.joinable()) th_.join();
+  }
+
+  std::size_t frames() const
+  {
+    return frames_.load(std::memory_order_acquire);
+  }
+
+ private:
+  void run_()
+  {
+    try
+    {
+      tcp::socket s(io_);
+      acceptor_.accept(s);
+
+      std::vector<std::byte> buf(1 << 20);
+      std::size_t have = 0;
+      while (frames_.load(std::memory_order_relaxed) < expect_)
+      {
+        have += s.read_some(boost::asio::buffer(buf.data() + have, buf.size() - have));
+
+        std::size_t off = 0;
+        std::size_t n = 0;
+        while (have - off >= 3)
+        {
+          const std::size_t len = std::to_integer<std::size_t>(buf[off + 1]) |
+                                  (std::to_integer<std::size_t>(buf[off + 2]) << 8);
+          if (have - off < 3 + len) break;
+
+          // a fragment run counts once, on its last fragment; keepalive probes not at all
+          const bool partial = (buf[off] == std::byte{'F'} && len >= 2 &&
+                                !(std::to_integer<uint8_t>(buf[off + 4]) & 0x02)) ||
+                               buf[off] == std::byte{'K'};
+          off += 3 + len;
+          if (!partial) ++n;
+        }
+        std::memmove(buf.data(), buf.data() + off, have - off);
+        have -= off;
+        frames_.fetch_add(n, std::memory_order_release);
+      }
+    }
+    catch (...)
+    {
+    }
+  }
+
+  boost::asio::io_context io_;
+  tcp::acceptor acceptor_{io_};
+  std::thread th_;
+  std::size_t expect_{0};
+  std::atomic<std::size_t> frames_{0};
+};
+
+void run_case(const char* name, std::size_t batch_limit, std::size_t frames, std::size_t payload)
+{
+  SinkServer sink;
+  const uint16_t port = sink.start(frames);
+
+  NullLogger log;
+  KoreLink_Asio link(log);
+  link.set_write_batch_limit(batch_limit);
+
+  // measure the write path, not load shedding: the whole burst must reach the sink
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.queue.max_bytes = 0;
+  opt.queue.ttl = std::chrono::milliseconds(0);
+  opt.handshake.enabled = false;  // the sink does not answer 'H'
+  link.set_options(opt);
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+
+  // wait for the link to come up (first frame round-trips through the sink)
+  std::vector<std::byte> p(payload, std::byte{0x42});
+  link.send_frame('R', p);
+  while (sink.frames() < 1) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  const auto before = link.stats();
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 1; i < frames; ++i) link.send_frame('R', p);
+  sink.join();
+  while (link.stats().frames_written < frames) std::this_thread::yield();
+  const auto t1 = std::chrono::steady_clock::now();
+  const auto after = link.stats();
+
+  const double secs = std::chrono::duration<double>(t1 - t0).count();
+  // logical frames: a jumbo payload leaves as several 'F' frames but counts once
+  const double sent = static_cast<double>(frames - 1);
+  const double writes = static_cast<double>(after.writes - before.writes);
+
+  std::printf("%-7s frames=%zu payload=%zu  %10.0f frames/s  %8.1f MB/s  %.4f writes/frame\n",
+              name, frames, payload, sent / secs, sent * payload / secs / 1e6,
+              sent > 0 ? writes / sent : 0.0);
+
+  link.close();
+}
+
+// Frames sent one by one with a gap, so every frame has to wake the I/O thread (or find it
+// still spinning)
+void run_latency_case(const char* name, int spin_us, std::size_t frames, std::size_t payload)
+{
+  SinkServer sink;
+  const uint16_t port = sink.start(frames);
+
+  arkan::relay::infrastructure::net::IoPoolOptions po;
+  po.spin = std::chrono::microseconds(spin_us);
+  arkan::relay::infrastructure::net::IoPool pool(po);
+
+  NullLogger log;
+  KoreLink_Asio link(log, pool);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.handshake.enabled = false;  // the sink does not answer 'H'
+  link.set_options(opt);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+
+  std::vector<std::byte> p(payload, std::byte{0x42});
+  link.send_frame('R', p);
+  while (sink.frames() < 1) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  for (std::size_t i = 1; i < frames; ++i)
+  {
+    const auto next = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+    link.send_frame('R', p);
+    while (std::chrono::steady_clock::now() < next) std::this_thread::yield();
+  }
+  sink.join();
+
+  const auto st = link.stats();
+  std::printf("%-7s frames=%zu payload=%zu  emit->write p50=%llu us  p99=%llu us\n", name, frames,
+              payload, (unsigned long long)st.emit_to_write_p50_us,
+              (unsigned long long)st.emit_to_write_p99_us);
+
+  link.close();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const std::size_t payload = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+
+  run_case("legacy", 1, frames, payload);
+  run_case("gather", 0, frames, payload);
+
+  // payloads past the 65535-byte envelope limit travel as 'F' fragment runs
+  run_case("jumbo", 0, (std::max<std::size_t>)(frames / 500, 2), 256 * 1024);
+
+  // wakeup latency: frames trickle in 200us apart
+  const std::size_t trickle = (std::min<std::size_t>)(frames, 5000);
+  run_latency_case("block", 0, trickle, payload);
+  run_latency_case("spin", 500, trickle, payload);
+  return 0;
+}
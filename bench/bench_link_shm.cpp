@@ -0,0 +1,291 @@
+// Shared-memory vs loopback TCP benchmark for the Kore link.
+//
+// Runs the same two workloads over KoreLink_Shm and KoreLink_Asio against an in-process Kore
+// stand-in that parses the R/S/K envelope:
+//   - rtt        : one 'R' frame at a time, echoed back by the peer; reports p50/p99 round trip
+//   - throughput : a one-way burst of 'R' frames; reports frames/s and MB/s
+//
+// usage: bench_link_shm [frames=200000] [payload=64] [pings=20000]
+
+#include <algorithm>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "application/ports/ILogger.hpp"
+#include "infrastructure/link/FrameReader.hpp"
+#include "infrastructure/link/KoreLink_Asio.hpp"
+#include "infrastructure/link/KoreLink_Shm.hpp"
+#include "infrastructure/link/ShmChannel.hpp"
+
+using tcp = boost::asio::ip::tcp;
+using arkan::relay::application::ports::IKoreLink;
+using arkan::relay::infrastructure::link::FrameReader;
+using arkan::relay::infrastructure::link::KoreLink_Asio;
+using arkan::relay::infrastructure::link::KoreLink_Shm;
+using arkan::relay::infrastructure::link::ShmChannel;
+
+namespace
+{
+
+constexpr uint16_t kShmPort = 47199;
+
+struct NullLogger : arkan::relay::application::ports::ILogger
+{
+  using LogLevel = arkan::relay::application::ports::LogLevel;
+  void init(const arkan::relay::domain::Settings&) override {}
+  void app(LogLevel, const std::string&) override {}
+  void sock(LogLevel, std::string_view) override {}
+};
+
+// Counts complete 'R' frames in a byte stream; echoes them back when asked to.
+std::size_t count_frames(FrameReader& reader, std::vector<std::byte>* echo)
+{
+  std::size_t n = 0;
+  char kind = 0;
+  std::span<const std::byte> p;
+  while (reader.next(kind, p))
+  {
+    if (kind != 'R') continue;
+    ++n;
+    if (echo)
+    {
+      const std::size_t at = echo->size();
+      echo->resize(at + 3 + p.size());
+      (*echo)[at] = std::byte{'R'};
+      (*echo)[at + 1] = static_cast<std::byte>(p.size() & 0xFF);
+      (*echo)[at + 2] = static_cast<std::byte>((p.size() >> 8) & 0xFF);
+      if (!p.empty()) std::memcpy(echo->data() + at + 3, p.data(), p.size());
+    }
+  }
+  return n;
+}
+
+// Kore stand-in over loopback TCP
+class TcpPeer
+{
+ public:
+  uint16_t start(bool echo)
+  {
+    echo_ = echo;
+    tcp::endpoint ep{boost::asio::ip::make_address("127.0.0.1"), 0};
+    acceptor_.open(ep.protocol());
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor_.bind(ep);
+    acceptor_.listen();
+    th_ = std::thread([this] { run_(); });
+    return acceptor_.local_endpoint().port();
+  }
+
+  void stop()
+  {
+    running_ = false;
+    boost::system::error_code ec;
+    socket_.shutdown(tcp::socket::shutdown_both, ec);
+    socket_.close(ec);
+    acceptor_.close(ec);
+    if (th_.joinable()) th_.join();
+  }
+
+  std::size_t frames() const
+  {
+    return frames_.load(std::memory_order_acquire);
+  }
+
+ private:
+  void run_()
+  {
+    try
+    {
+      acceptor_.accept(socket_);
+      socket_.set_option(tcp::no_delay(true));
+
+      FrameReader reader;
+      std::vector<std::byte> out;
+      while (running_)
+      {
+        const auto buf = reader.prepare();
+        reader.commit(socket_.read_some(buf));
+        out.clear();
+        frames_.fetch_add(count_frames(reader, echo_ ? &out : nullptr),
+                          std::memory_order_release);
+        if (!out.empty()) boost::asio::write(socket_, boost::asio::buffer(out));
+      }
+    }
+    catch (...)
+    {
+    }
+  }
+
+  boost::asio::io_context io_;
+  tcp::acceptor acceptor_{io_};
+  tcp::socket socket_{io_};
+  std::thread th_;
+  std::atomic<bool> running_{true};
+  bool echo_{false};
+  std::atomic<std::size_t> frames_{0};
+};
+
+// Kore stand-in on the shared-memory segment
+class ShmPeer
+{
+ public:
+  uint16_t start(bool echo)
+  {
+    echo_ = echo;
+    ShmChannel::remove(KoreLink_Shm::segment_name(kShmPort));
+    chan_.open(KoreLink_Shm::segment_name(kShmPort), ShmChannel::Role::kore);
+    th_ = std::thread([this] { run_(); });
+    return kShmPort;
+  }
+
+  void stop()
+  {
+    running_ = false;
+    chan_.wake();
+    if (th_.joinable()) th_.join();
+    chan_.close();
+    ShmChannel::remove(KoreLink_Shm::segment_name(kShmPort));
+  }
+
+  std::size_t frames() const
+  {
+    return frames_.load(std::memory_order_acquire);
+  }
+
+ private:
+  void run_()
+  {
+    FrameReader reader;
+    std::vector<std::byte> out;
+    while (running_)
+    {
+      const auto buf = reader.prepare();
+      const std::size_t n =
+          chan_.read(std::span<std::byte>(static_cast<std::byte*>(buf.data()), buf.size()));
+      if (n == 0)
+      {
+        chan_.wait(std::chrono::milliseconds(100));
+        continue;
+      }
+      reader.commit(n);
+      out.clear();
+      frames_.fetch_add(count_frames(reader, echo_ ? &out : nullptr), std::memory_order_release);
+      while (!out.empty() && running_ && !chan_.write(out)) std::this_thread::yield();
+    }
+  }
+
+  ShmChannel chan_;
+  std::thread th_;
+  std::atomic<bool> running_{true};
+  bool echo_{false};
+  std::atomic<std::size_t> frames_{0};
+};
+
+std::unique_ptr<IKoreLink> make_link(bool shm, NullLogger& log, uint16_t port)
+{
+  std::unique_ptr<IKoreLink> link;
+  if (shm)
+    link = std::make_unique<KoreLink_Shm>(log);
+  else
+    link = std::make_unique<KoreLink_Asio>(log);
+
+  // measure the transport, not load shedding
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.queue.max_bytes = 0;
+  opt.queue.ttl = std::chrono::milliseconds(0);
+  link->set_options(opt);
+
+  link->set_candidate_ports({port});
+  link->connect("127.0.0.1", port);
+  return link;
+}
+
+template <class Peer>
+void run_rtt(const char* name, bool shm, std::size_t pings, std::size_t payload)
+{
+  Peer peer;
+  const uint16_t port = peer.start(true);
+
+  NullLogger log;
+  std::atomic<std::size_t> echoed{0};
+  auto link = make_link(shm, log, port);
+  link->on_frame([&](char k, std::span<const std::byte>)
+                 { if (k == 'R') echoed.fetch_add(1, std::memory_order_release); });
+
+  // wait for the link to come up (first frame round-trips through the peer)
+  std::vector<std::byte> p(payload, std::byte{0x42});
+  link->send_frame('R', p);
+  while (echoed.load(std::memory_order_acquire) < 1)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  std::vector<double> us;
+  us.reserve(pings);
+  for (std::size_t i = 0; i < pings; ++i)
+  {
+    const std::size_t want = echoed.load(std::memory_order_relaxed) + 1;
+    const auto t0 = std::chrono::steady_clock::now();
+    link->send_frame('R', p);
+    while (echoed.load(std::memory_order_acquire) < want) std::this_thread::yield();
+    us.push_back(
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+  }
+  std::sort(us.begin(), us.end());
+
+  std::printf("%-4s rtt        pings=%zu payload=%zu  p50=%8.1f us  p99=%8.1f us\n", name, pings,
+              payload, us[us.size() / 2], us[us.size() * 99 / 100]);
+
+  link->close();
+  peer.stop();
+}
+
+template <class Peer>
+void run_throughput(const char* name, bool shm, std::size_t frames, std::size_t payload)
+{
+  Peer peer;
+  const uint16_t port = peer.start(false);
+
+  NullLogger log;
+  auto link = make_link(shm, log, port);
+
+  std::vector<std::byte> p(payload, std::byte{0x42});
+  link->send_frame('R', p);
+  while (peer.frames() < 1) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 1; i < frames; ++i) link->send_frame('R', p);
+  while (peer.frames() < frames) std::this_thread::yield();
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double secs = std::chrono::duration<double>(t1 - t0).count();
+  const double sent = static_cast<double>(frames - 1);
+  std::printf("%-4s throughput frames=%zu payload=%zu  %10.0f frames/s  %8.1f MB/s\n", name,
+              frames, payload, sent / secs, sent * (3 + payload) / secs / 1e6);
+
+  link->close();
+  peer.stop();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const std::size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+  const std::size_t payload = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+  const std::size_t pings = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20000;
+
+  run_rtt<TcpPeer>("tcp", false, pings, payload);
+  run_rtt<ShmPeer>("shm", true, pings, payload);
+  run_throughput<TcpPeer>("tcp", false, frames, payload);
+  run_throughput<ShmPeer>("shm", true, frames, payload);
+  return 0;
+}
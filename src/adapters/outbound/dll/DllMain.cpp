@@ -32,28 +32,34 @@
 #define NOMINMAX
 #include <fcntl.h>
 #include <io.h>
-#include <spdlog/spdlog.h>
 #include <windows.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <cwchar>
 #include <iostream>
 #include <memory>
 #include <string>
 
+#include "application/ports/IFlightRecorder.hpp"
 #include "application/ports/IFrameCodec.hpp"
 #include "application/ports/IHook.hpp"
 #include "application/ports/IKoreLink.hpp"
 #include "application/ports/ILogger.hpp"
 #include "application/services/BridgeService.hpp"
 #include "domain/Settings.hpp"
+#include "infrastructure/codec/FrameCodec_Lz.hpp"
 #include "infrastructure/codec/FrameCodec_Noop.hpp"
 #include "infrastructure/config/Config_Toml.hpp"
 #include "infrastructure/hook/win32/Hook_Win32.hpp"
 #include "infrastructure/link/KoreLink_Asio.hpp"
+#include "infrastructure/link/KoreLink_Shm.hpp"
+#include "infrastructure/logging/FlightRecorder.hpp"
 #include "infrastructure/logging/Logger_Spdlog.hpp"
+#include "infrastructure/net/IoPool.hpp"
 
 using namespace arkan::relay;
 
@@ -64,6 +70,10 @@ static HANDLE g_thread = nullptr;
 static HANDLE g_stop = nullptr;
 static bool g_allocConsole = false;
 
+// Flight recorder of the running relay (null when off or not started yet), for crash/console dumps
+static std::atomic<application::ports::IFlightRecorder*> g_recorder{nullptr};
+static LPTOP_LEVEL_EXCEPTION_FILTER g_prevFilter = nullptr;
+
 // -------------------------------------------------------------------------------------------------
 // EnsureConsole_New
 // - Always create a brand-new console window for the DLL (never reuse parent's).
@@ -157,6 +167,15 @@ static void EnsureConsole_New()
   ShowWindow(GetConsoleWindow(), SW_SHOW);
 }
 
+// -------------------------------------------------------------------------------------------------
+// DumpFlight: write the flight recorder to <logsDir> (no-op when it is off)
+// - FlightRecorder::dump only uses the stack and stdio, so this may run inside exception filters.
+// -------------------------------------------------------------------------------------------------
+static void DumpFlight(const char* reason)
+{
+  if (auto* rec = g_recorder.load(std::memory_order_acquire)) rec->dump(reason);
+}
+
 // -------------------------------------------------------------------------------------------------
 // CrashFilter: log SEH faults to DebugView/Debugger
 // -------------------------------------------------------------------------------------------------
@@ -166,9 +185,31 @@ static LONG WINAPI CrashFilter(EXCEPTION_POINTERS* ep)
   std::snprintf(buf, sizeof(buf), "ArkanRelay: CRASH code=0x%08lX at=%p\r\n",
                 ep->ExceptionRecord->ExceptionCode, ep->ExceptionRecord->ExceptionAddress);
   OutputDebugStringA(buf);
+  DumpFlight("crash");
   return EXCEPTION_EXECUTE_HANDLER;
 }
 
+// -------------------------------------------------------------------------------------------------
+// UnhandledFilter: crashes on the game's threads (hooked send/recv run there)
+// - Dumps the flight recorder, then leaves the decision to the filter that was installed before.
+// -------------------------------------------------------------------------------------------------
+static LONG WINAPI UnhandledFilter(EXCEPTION_POINTERS* ep)
+{
+  DumpFlight("crash");
+  return g_prevFilter ? g_prevFilter(ep) : EXCEPTION_CONTINUE_SEARCH;
+}
+
+// -------------------------------------------------------------------------------------------------
+// ConsoleCtrl: Ctrl+Break in the relay console dumps the flight recorder
+// - Handled (TRUE) so it does not end the game; anything else goes to the default handler.
+// -------------------------------------------------------------------------------------------------
+static BOOL WINAPI ConsoleCtrl(DWORD type)
+{
+  if (type != CTRL_BREAK_EVENT) return FALSE;
+  DumpFlight("break");
+  return TRUE;
+}
+
 // -------------------------------------------------------------------------------------------------
 // RunRelayCore: main worker function executed on our thread
 // -------------------------------------------------------------------------------------------------
@@ -193,30 +234,98 @@ static DWORD RunRelayCore()
   infrastructure::logging::Logger_Spdlog logger;
   logger.init(s);
 
-  // Force aggressive flushing so logs show up immediately in the console
-  spdlog::flush_on(spdlog::level::info);
-  spdlog::flush_every(std::chrono::milliseconds(200));
-
   logger.app(application::ports::LogLevel::info, "Arkan Relay (DLL) starting...");
 
   // --- Infrastructure ---
   logger.app(application::ports::LogLevel::debug, "Creating link/codec/hook...");
-  infrastructure::link::KoreLink_Asio link(logger);
-  infrastructure::codec::FrameCodec_Noop codec;
+
+  // shared I/O workers; outlives the link and the bridge (declared before them)
+  infrastructure::net::IoPoolOptions pool_opt;
+  pool_opt.threads = static_cast<std::size_t>(s.relay.ioThreads);
+  pool_opt.cpus = s.relay.ioCpus;
+  pool_opt.spin = std::chrono::microseconds(s.relay.ioSpinUs);
+  pool_opt.high_priority = s.relay.ioHighPriority;
+  infrastructure::net::IoPool io_pool(pool_opt);
+  logger.app(application::ports::LogLevel::info,
+             "I/O pool: " + std::to_string(io_pool.size()) + " thread(s)" +
+                 (s.relay.ioCpus.empty() ? "" : ", pinned") +
+                 (s.relay.ioSpinUs > 0 ? ", busy-poll " + std::to_string(s.relay.ioSpinUs) + "us"
+                                       : "") +
+                 (s.relay.ioHighPriority ? ", high priority" : ""));
+
+  std::unique_ptr<application::ports::IKoreLink> link;
+  if (s.kore.transport == "shm")
+  {
+    logger.app(application::ports::LogLevel::info, "Kore transport: shared memory");
+    link = std::make_unique<infrastructure::link::KoreLink_Shm>(logger, s.kore.shm_ring_bytes);
+  }
+  else
+  {
+    if (s.kore.transport != "tcp")
+      logger.app(application::ports::LogLevel::warn,
+                 "Unknown kore.transport '" + s.kore.transport + "', using tcp");
+    link = std::make_unique<infrastructure::link::KoreLink_Asio>(logger, io_pool);
+  }
+  std::unique_ptr<application::ports::IFrameCodec> codec;
+  if (s.relay.framing == "lz")
+  {
+    auto lz = std::make_unique<infrastructure::codec::FrameCodec_Lz>(s.relay.compressMin);
+    if (!s.relay.dictionary.empty() && !lz->load_dictionary(s.relay.dictionary))
+      logger.app(application::ports::LogLevel::warn,
+                 "Cannot read relay.dictionary '" + s.relay.dictionary + "'; compressing without");
+    codec = std::move(lz);
+  }
+  else
+  {
+    if (s.relay.framing != "none")
+      logger.app(application::ports::LogLevel::warn,
+                 "Unknown relay.framing '" + s.relay.framing + "', using none");
+    codec = std::make_unique<infrastructure::codec::FrameCodec_Noop>();
+  }
   infrastructure::hook::Hook_Win32 hook(logger, s);
 
+  // --- Flight recorder ---
+  // dumped on a Kore 'D' frame, on Ctrl+Break, when the named event below is signaled, or on crash
+  std::unique_ptr<infrastructure::logging::FlightRecorder> recorder;
+  HANDLE dumpEvent = nullptr;
+  if (s.flightRecorder)
+  {
+    recorder = std::make_unique<infrastructure::logging::FlightRecorder>(
+        s.flightRecorderBytes, s.flightRecorderSeconds, s.logsDir);
+    g_recorder.store(recorder.get(), std::memory_order_release);
+    g_prevFilter = SetUnhandledExceptionFilter(UnhandledFilter);
+    SetConsoleCtrlHandler(ConsoleCtrl, TRUE);
+
+    wchar_t name[64];
+    std::swprintf(name, 64, L"Local\\ArkanRelay.Dump.%lu", GetCurrentProcessId());
+    dumpEvent = CreateEventW(nullptr, FALSE, FALSE, name);
+
+    logger.app(application::ports::LogLevel::info,
+               "Flight recorder: " + std::to_string(recorder->capacity() >> 10) + " KiB, last " +
+                   std::to_string(s.flightRecorderSeconds) +
+                   " s; dump with Ctrl+Break or event Local\\ArkanRelay.Dump." +
+                   std::to_string(GetCurrentProcessId()));
+  }
+
   // --- Service ---
   logger.app(application::ports::LogLevel::debug, "Wiring BridgeService...");
-  auto bridge =
-      std::make_unique<application::services::BridgeService>(hook, link, codec, logger, s);
+  auto bridge = std::make_unique<application::services::BridgeService>(hook, *link, *codec, logger,
+                                                                       s, recorder.get());
 
   logger.app(application::ports::LogLevel::info, "Bridge starting (will install hook)...");
   bridge->start();
 
-  // --- Wait for shutdown ---
+  // --- Wait for shutdown (serving dump requests meanwhile) ---
   if (g_stop)
   {
-    WaitForSingleObject(g_stop, INFINITE);
+    HANDLE waits[2] = {g_stop, dumpEvent};
+    const DWORD count = dumpEvent ? 2 : 1;
+    while (WaitForMultipleObjects(count, waits, FALSE, INFINITE) == WAIT_OBJECT_0 + 1)
+    {
+      const bool ok = recorder->dump("event");
+      logger.app(ok ? application::ports::LogLevel::info : application::ports::LogLevel::warn,
+                 ok ? "Flight recorder dumped" : "Flight recorder dump failed");
+    }
   }
 
   // --- Teardown ---
@@ -224,6 +333,14 @@ static DWORD RunRelayCore()
   bridge->stop();
   logger.app(application::ports::LogLevel::info, "Bridge stopped. Bye.");
 
+  if (recorder)
+  {
+    SetConsoleCtrlHandler(ConsoleCtrl, FALSE);
+    SetUnhandledExceptionFilter(g_prevFilter);
+    g_recorder.store(nullptr, std::memory_order_release);
+    if (dumpEvent) CloseHandle(dumpEvent);
+  }
+
   return 0;
 }
 
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace arkan::relay::application::ports
+{
+
+// What a flight recorder entry holds
+enum class FlightEvent : uint8_t
+{
+  send = 'S',         // client -> server packet (wire bytes)
+  recv = 'R',         // server -> client packet
+  inject_send = 's',  // Kore -> server packet injected by the relay
+  inject_recv = 'r',  // Kore -> client packet injected by the relay
+  state = 'T',        // checksum/session state transition (text)
+  note = 'N',         // anything else worth having in a dump (text)
+};
+
+// Always-on in-memory record of recent traffic, written to a file on demand
+struct IFlightRecorder
+{
+  virtual ~IFlightRecorder() = default;
+
+  // Any thread, never blocks
+  virtual void record(FlightEvent e, std::span<const std::byte> bytes) = 0;
+
+  // Writes what is still in memory to a new file; `reason` ends up in its name and header
+  virtual bool dump(const char* reason) = 0;
+};
+
+}  // namespace arkan::relay::application::ports
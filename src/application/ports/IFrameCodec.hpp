@@ -20,6 +20,20 @@ struct IFrameCodec
   {
     return std::vector<std::byte>(payload.begin(), payload.end());
   }
+
+  // Wire compression ('Z' frames). compress() appends the compressed form of `payload` to
+  // `out` and returns true, or returns false (out untouched) when the payload should go out
+  // as-is: below the size threshold, incompressible, or no compressor configured.
+  virtual bool compress(std::span<const std::byte> /*payload*/, std::vector<std::byte>& /*out*/)
+  {
+    return false;
+  }
+
+  // Inverse of compress(): replaces `out` with the original payload; false if malformed.
+  virtual bool decompress(std::span<const std::byte> /*block*/, std::vector<std::byte>& /*out*/)
+  {
+    return false;
+  }
 };
 
 }  // namespace arkan::relay::application::ports
@@ -1,11 +1,14 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <span>
 #ifdef _WIN32
 #include <winsock2.h>
 #endif
 
+#include "application/ports/IFlightRecorder.hpp"
+
 namespace arkan::relay::application::ports
 {
 
@@ -18,6 +21,9 @@ struct IHook
   std::function<void(Bytes)> on_send;
   std::function<void(Bytes)> on_recv;
 
+  // Flight recorder for emitted packets and checksum state transitions (optional)
+  IFlightRecorder* recorder{nullptr};
+
   virtual bool install() = 0;
   virtual void uninstall() = 0;
 
@@ -30,6 +36,12 @@ struct IHook
   virtual void emit_recv(Bytes) = 0;
   virtual void notify_socket(SOCKET s) = 0;
 
+  // Socket of the packet being emitted (for logs); 0 when unknown
+  virtual uint64_t socket_id() const
+  {
+    return 0;
+  }
+
   virtual ~IHook() = default;
 };
 
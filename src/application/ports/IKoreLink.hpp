@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -19,6 +20,126 @@ struct ReconnectPolicy
   double jitter_p{0.2};
 };
 
+// What to throw away when the outgoing queue is over its cap
+enum class ShedPolicy
+{
+  drop_oldest,  // make room by dropping the oldest queued frames (lowest-priority lane first)
+  drop_newest,  // refuse the incoming frame
+  drop_class,   // drop queued frames of the listed opcodes first, then as drop_oldest
+};
+
+// Bounds on frames queued for Kore but not yet written (0 = no limit)
+struct QueueLimits
+{
+  std::size_t max_bytes{8u << 20};
+  std::size_t max_frames{0};
+  std::chrono::milliseconds ttl{3000};  // older queued frames are dropped, never sent late
+  ShedPolicy policy{ShedPolicy::drop_oldest};
+  std::vector<uint16_t> shed_opcodes;  // drop_class: sheddable RO opcodes
+};
+
+// Version/feature exchange on connect ('H' frames). The relay announces what it can speak and
+// uses only what Kore announces back (and its options turn on); a Kore that does not answer
+// within `timeout` is spoken to in the original R/S/K envelope. Off = every configured feature
+// is used blindly, as for a Kore build that knows the features but not 'H'.
+struct HandshakeOptions
+{
+  bool enabled{true};
+  std::chrono::milliseconds timeout{1000};
+  uint32_t features{0};  // offered on top of the link's own (e.g. 'Z' when a codec is configured)
+};
+
+// Send-path priority lanes. Frames of different lanes may be reordered; frames of the same
+// lane never are, so opcodes that depend on each other belong in the same lane.
+enum class Lane : uint8_t
+{
+  control,      // link protocol frames (non-'R' kinds) and the opcodes mapped here
+  interactive,  // packets the bots react to
+  bulk,         // inventory/map-load floods and other throughput traffic
+};
+inline constexpr std::size_t kLaneCount = 3;
+
+struct LaneOptions
+{
+  Lane fallback{Lane::interactive};  // lane of 'R' opcodes not listed below
+  std::vector<std::pair<uint16_t, Lane>> opcodes;
+  std::array<unsigned, kLaneCount> weights{8, 4, 1};  // share of each write, by Lane
+};
+
+// Micro-batching of outgoing frames. With a window, a write waits up to `window` for more
+// frames (or until `max_bytes` are queued) and runs of frames go out as one 'B' frame, so Kore
+// wakes and parses once per batch. Only used where Kore announced 'B' (see HandshakeOptions).
+struct BatchOptions
+{
+  std::chrono::microseconds window{0};  // 0 = off: write as soon as frames are queued
+  std::size_t max_bytes{16 * 1024};     // flush early once this much is queued
+};
+
+// Keepalive probes ('K' frames Kore echoes back) measure the link RTT and detect a silent peer.
+// A probe goes out every `interval` (stretched while traffic flows both ways); an unanswered
+// one is retried sooner, down to `min_interval`, until the peer has been silent for
+// `dead_after` and the connection is dropped. Detection arms once the peer has echoed a probe,
+// so a Kore that does not echo is never dropped for it.
+struct KeepaliveOptions
+{
+  std::chrono::milliseconds interval{5000};
+  std::chrono::milliseconds min_interval{250};
+  std::chrono::milliseconds dead_after{15000};  // 0 = never drop a silent peer
+};
+
+// Delivery across reconnects. With a buffer, every connection numbers the frames it writes ('Q'),
+// Kore acknowledges the ones it has processed ('A'), and frames still unacknowledged when a
+// connection drops are written again: first thing once it is back or, with another pool
+// connection up, on that one right away. Frames that no longer fit the buffer are evicted
+// unacknowledged. Only used where Kore announced 'Q'/'A'.
+struct ReplayOptions
+{
+  std::size_t buffer_bytes{0};  // per connection; 0 = off
+};
+
+// Disk spill for long Kore outages. Frames the queue has no room for (see QueueLimits) go to a
+// journal of memory-mapped segment files in `dir` instead of being shed, and so does every frame
+// after them until the journal is empty again, so order is kept. While a connection is up the
+// journal is fed back into the queue at up to `drain_rate` bytes per second.
+struct SpillOptions
+{
+  std::string dir;                       // empty = off
+  std::size_t segment_bytes{16u << 20};  // size of one segment file
+  std::size_t max_bytes{1u << 30};       // disk cap; past it frames are shed as usual
+  std::size_t drain_rate{4u << 20};      // bytes per second
+};
+
+// Link tuning (transport-specific knobs; implementations ignore what they do not support)
+struct LinkOptions
+{
+  // Live connections kept to the candidate ports. 1 = single connection with failover on
+  // error; N > 1 = active-active pool (all candidate ports must reach the same Kore).
+  std::size_t pool_size{1};
+  // Connect attempts a (re)connecting connection starts at once, each on its own claimable
+  // candidate port; the first to complete is kept and the others are dropped. 1 = one port
+  // per attempt, the next one after a failure and a backoff.
+  std::size_t connect_race{1};
+  HandshakeOptions handshake{};
+  QueueLimits queue{};
+  LaneOptions lanes{};
+  BatchOptions batch{};
+  KeepaliveOptions keepalive{};
+  ReplayOptions replay{};
+  SpillOptions spill{};
+};
+
+// Link-owned memory reserved for one outgoing frame payload (see IKoreLink::reserve)
+struct FrameReservation
+{
+  std::span<std::byte> payload;  // caller writes exactly payload.size() bytes here
+  void* handle{nullptr};         // implementation-owned
+
+  explicit operator bool() const noexcept
+  {
+    return handle != nullptr;
+  }
+};
+
 struct IKoreLink
 {
   virtual ~IKoreLink() = default;
@@ -29,10 +150,26 @@ struct IKoreLink
 
   virtual void send_frame(char kind, std::span<const std::byte> payload) = 0;
 
+  // Zero-copy producer path: reserve room for a `len`-byte payload, fill it, then commit().
+  // An empty reservation means "not available right now"; fall back to send_frame().
+  virtual FrameReservation reserve(char /*kind*/, std::size_t /*len*/)
+  {
+    return {};
+  }
+  virtual void commit(FrameReservation& /*r*/) {}
+
   virtual void on_frame(std::function<void(char, std::span<const std::byte>)> cb) = 0;
 
+  // Envelope features Kore agreed to use ('H' feature bits); a transport without a handshake
+  // reports all of them and leaves the choice to configuration
+  virtual uint32_t peer_features() const
+  {
+    return 0xFFFFFFFFu;
+  }
+
   virtual void set_candidate_ports(std::vector<uint16_t> /*ports*/) {}
   virtual void set_reconnect_policy(const ReconnectPolicy& /*p*/) {}
+  virtual void set_options(const LinkOptions& /*o*/) {}
 };
 
 }  // namespace arkan::relay::application::ports
@@ -1,21 +1,21 @@
 #pragma once
 
+#include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 
+#include "application/ports/LogRecord.hpp"
 #include "domain/Settings.hpp"
 
 namespace arkan::relay::application::ports
 {
 
-enum class LogLevel
+// Direction of a client packet on the socket channel
+enum class PacketDir : uint8_t
 {
-  trace,
-  debug,
-  info,
-  warn,
-  err,
-  critical,
-  off
+  send = 'S',  // client -> server
+  recv = 'R',  // server -> client
 };
 
 struct ILogger
@@ -24,6 +24,42 @@ struct ILogger
   virtual void init(const arkan::relay::domain::Settings& s) = 0;
   virtual void app(LogLevel level, const std::string& msg) = 0;
   virtual void sock(LogLevel level, std::string_view msg) = 0;
+
+  // Whether a socket-channel line at `level` would be written at all: a single branch, so hot
+  // paths can skip building messages nobody reads
+  virtual bool enabled(LogLevel /*level*/) const
+  {
+    return true;
+  }
+
+  // Socket-channel line formatted later (see LogRecord). Default: formatted right away.
+  virtual void sock_deferred(const LogRecord& r)
+  {
+    std::string line;
+    r.format(line);
+    sock(r.level, line);
+  }
+
+  // sockf(level, "conn#{} wrote {} bytes", id, n): nothing is built when `level` is off; the
+  // arguments are captured by value and formatted off the calling thread
+  template <class... Args>
+  void sockf(LogLevel level, const char* fmt, const Args&... args)
+  {
+    if (!enabled(level)) return;
+    LogRecord r(level, fmt);
+    (r.add(args), ...);
+    sock_deferred(r);
+  }
+
+  // One client packet on `socket`. Default: a "SEND → AA BB ..." / "RECV ← ..." line at info;
+  // a logger may store packets in binary instead
+  virtual void sock_packet(PacketDir dir, uint64_t /*socket*/, std::span<const std::byte> bytes)
+  {
+    if (dir == PacketDir::send)
+      sockf(LogLevel::info, "SEND \xE2\x86\x92 {}", LogHex{bytes});
+    else
+      sockf(LogLevel::info, "RECV \xE2\x86\x90 {}", LogHex{bytes});
+  }
 };
 
 }  // namespace arkan::relay::application::ports
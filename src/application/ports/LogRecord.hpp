@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "shared/hex/Hex.hpp"
+
+namespace arkan::relay::application::ports
+{
+
+enum class LogLevel
+{
+  trace,
+  debug,
+  info,
+  warn,
+  err,
+  critical,
+  off
+};
+
+// Argument wrapper: bytes rendered as "AA BB CC " (at most `max` of them, then
+// "...(N bytes total)"), like shared::hex::hex_dump
+struct LogHex
+{
+  std::span<const std::byte> data;
+  std::size_t max{64};
+};
+
+// -----------------------------------------------------------------------------
+// LogRecord
+//  - One log line whose formatting is deferred: the format string and its
+//    arguments are captured by value into fixed inline storage, so building a
+//    record never allocates. The logger formats it later, on its own thread.
+//  - Placeholders are "{}" ("{{" and "}}" for literal braces). Strings and
+//    LogHex bytes are copied; past kMaxArgs arguments or kInlineBytes of
+//    copied data the rest is cut (marked with "~").
+//  - `fmt` must outlive the record (a string literal).
+// -----------------------------------------------------------------------------
+class LogRecord
+{
+ public:
+  static constexpr std::size_t kMaxArgs = 8;
+  static constexpr std::size_t kInlineBytes = 200;
+
+  LogRecord() = default;
+  LogRecord(LogLevel lvl, const char* format)
+      : level(lvl), fmt(format), time(std::chrono::system_clock::now())
+  {
+  }
+
+  LogLevel level{LogLevel::info};
+  const char* fmt{""};
+  std::chrono::system_clock::time_point time{};
+  uint32_t suppressed{0};  // lines of the same site dropped by rate limiting before this one
+
+  template <class T>
+  void add(const T& v)
+  {
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (std::is_same_v<U, LogHex>)
+      add_hex(v);
+    else if constexpr (std::is_same_v<U, char>)
+      push(Type::chr, static_cast<uint64_t>(static_cast<unsigned char>(v)));
+    else if constexpr (std::is_same_v<U, bool>)
+      add_str(v ? "true" : "false");
+    else if constexpr (std::is_floating_point_v<U>)
+    {
+      uint64_t bits = 0;
+      const double d = static_cast<double>(v);
+      std::memcpy(&bits, &d, sizeof(bits));
+      push(Type::f64, bits);
+    }
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+      push(Type::i64, static_cast<uint64_t>(static_cast<int64_t>(v)));
+    else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>)
+      push(Type::u64, static_cast<uint64_t>(v));
+    else
+      add_str(std::string_view(v));
+  }
+
+  // Appends the formatted line to `out`
+  void format(std::string& out) const
+  {
+    std::size_t next = 0;
+    for (const char* p = fmt; *p; ++p)
+    {
+      if ((p[0] == '{' && p[1] == '{') || (p[0] == '}' && p[1] == '}'))
+      {
+        out.push_back(*p++);
+        continue;
+      }
+      if (p[0] == '{' && p[1] == '}')
+      {
+        if (next < nargs_)
+          append_arg(out, args_[next]);
+        else if (truncated_)
+          out.push_back('~');
+        ++next;
+        ++p;
+        continue;
+      }
+      out.push_back(*p);
+    }
+    if (suppressed)
+    {
+      char b[48];
+      const int n = std::snprintf(b, sizeof(b), " (+%u similar suppressed)", suppressed);
+      if (n > 0) out.append(b, (std::min)(static_cast<std::size_t>(n), sizeof(b) - 1));
+    }
+  }
+
+ private:
+  enum class Type : uint8_t
+  {
+    i64,
+    u64,
+    f64,
+    chr,
+    str,
+    hex,
+  };
+
+  struct Arg
+  {
+    Type type{Type::u64};
+    uint16_t off{0};   // str/hex: bytes in inline_
+    uint16_t len{0};
+    uint64_t value{0};  // hex: total size of the original data
+  };
+
+  void push(Type t, uint64_t value, uint16_t off = 0, uint16_t len = 0)
+  {
+    if (nargs_ == kMaxArgs)
+    {
+      truncated_ = true;
+      return;
+    }
+    args_[nargs_++] = Arg{t, off, len, value};
+  }
+
+  std::size_t copy_in(const void* p, std::size_t n)
+  {
+    n = (std::min)(n, kInlineBytes - used_);
+    if (n) std::memcpy(inline_.data() + used_, p, n);
+    used_ += n;
+    return n;
+  }
+
+  void add_str(std::string_view s)
+  {
+    const auto off = static_cast<uint16_t>(used_);
+    const std::size_t n = copy_in(s.data(), s.size());
+    push(Type::str, n < s.size() ? 1 : 0, off, static_cast<uint16_t>(n));
+  }
+
+  void add_hex(const LogHex& h)
+  {
+    const std::size_t take = h.max > 0 ? (std::min)(h.max, h.data.size()) : h.data.size();
+    const auto off = static_cast<uint16_t>(used_);
+    const std::size_t n = copy_in(h.data.data(), take);
+    push(Type::hex, h.data.size(), off, static_cast<uint16_t>(n));
+  }
+
+  void append_arg(std::string& out, const Arg& a) const
+  {
+    char b[32];
+    int n = 0;
+    switch (a.type)
+    {
+      case Type::i64:
+        n = std::snprintf(b, sizeof(b), "%lld", static_cast<long long>(a.value));
+        break;
+      case Type::u64:
+        n = std::snprintf(b, sizeof(b), "%llu", static_cast<unsigned long long>(a.value));
+        break;
+      case Type::f64:
+      {
+        double d = 0.0;
+        std::memcpy(&d, &a.value, sizeof(d));
+        n = std::snprintf(b, sizeof(b), "%g", d);
+        break;
+      }
+      case Type::chr:
+        out.push_back(static_cast<char>(a.value));
+        return;
+      case Type::str:
+        out.append(reinterpret_cast<const char*>(inline_.data() + a.off), a.len);
+        if (a.value) out.push_back('~');
+        return;
+      case Type::hex:
+      {
+        const std::size_t at = out.size();
+        out.resize(at + shared::hex::encoded_size(a.len));
+        shared::hex::encode(std::span<const std::byte>(inline_.data() + a.off, a.len),
+                            out.data() + at);
+        if (a.len < a.value)
+          n = std::snprintf(b, sizeof(b), "...(%llu bytes total)",
+                            static_cast<unsigned long long>(a.value));
+        break;
+      }
+    }
+    if (n > 0) out.append(b, (std::min)(static_cast<std::size_t>(n), sizeof(b) - 1));
+  }
+
+  std::array<Arg, kMaxArgs> args_{};
+  std::array<std::byte, kInlineBytes> inline_{};
+  uint8_t nargs_{0};
+  uint16_t used_{0};
+  bool truncated_{false};
+};
+
+}  // namespace arkan::relay::application::ports
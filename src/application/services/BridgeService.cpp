@@ -1,12 +1,17 @@
 #include "application/services/BridgeService.hpp"
 
 #include <chrono>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "domain/protocol/Envelope.hpp"
+
+using arkan::relay::application::ports::FlightEvent;
 using arkan::relay::application::ports::LogLevel;
 using Bytes = arkan::relay::application::ports::IHook::Bytes;
+namespace env = arkan::relay::domain::protocol::envelope;
 
 namespace arkan::relay::application::services
 {
@@ -28,9 +33,12 @@ void BridgeService::start()
   if (running_) return;
 
   // ---- Hook - Kore ----------------------------------------------------------
+  // the hook records what it emits; injections are recorded below
+  hook_.recorder = recorder_;
+
   hook_.on_send = [this](Bytes b)
   {
-    log_.sock(LogLevel::info, "SEND \xE2\x86\x92 " + shared::hex::hex_dump(b));
+    log_.sock_packet(ports::PacketDir::send, hook_.socket_id(), b);
 
     // link_.send_frame('S', b);
   };
@@ -38,49 +46,36 @@ void BridgeService::start()
   hook_.on_recv = [this](Bytes b)
   {
     // console summary
-    log_.sock(LogLevel::info, "RECV \xE2\x86\x90 " + shared::hex::hex_dump(b));
-    // forward as 'R' frame to Kore
-    link_.send_frame('R', b);
+    log_.sock_packet(ports::PacketDir::recv, hook_.socket_id(), b);
+    // large packets go out compressed when a codec is configured and Kore agreed to 'Z'
+    // (opcode kept in the clear)
+    if (b.size() >= 2 && (link_.peer_features() & env::kFeatCompress))
+    {
+      zbuf_.assign(b.begin(), b.begin() + 2);
+      zbuf_.push_back(static_cast<std::byte>(env::kRecv));
+      if (codec_.compress(b, zbuf_))
+      {
+        link_.send_frame(env::kCompressed, zbuf_);
+        return;
+      }
+    }
+
+    // forward as 'R' frame to Kore, straight into link-owned memory when possible
+    if (auto r = link_.reserve('R', b.size()))
+    {
+      std::memcpy(r.payload.data(), b.data(), b.size());
+      link_.commit(r);
+    }
+    else
+    {
+      link_.send_frame('R', b);
+    }
   };
 
   // ---- Kore - client ----------------------------------------------
   // -------- Kore → client ---------------------------------------------------
-  link_.on_frame(
-      [this](char kind, std::span<const std::byte> payload)
-      {
-        auto hex_len = std::to_string(payload.size());
-
-        switch (kind)
-        {
-          case 'S':
-          {
-            const bool ok = hook_.try_inject_send(payload);
-            if (ok)
-              log_.sock(LogLevel::debug, "Kore→client inject S (" + hex_len + " bytes) ok");
-            else
-              log_.sock(LogLevel::warn,
-                        "Kore→client inject S (" + hex_len + " bytes) failed (no socket yet?)");
-            break;
-          }
-          case 'R':
-          {
-            const bool ok = hook_.try_inject_recv(payload);
-            if (ok)
-              log_.sock(LogLevel::debug, "Kore→client inject R (" + hex_len + " bytes) ok");
-            else
-              log_.sock(LogLevel::warn,
-                        "Kore→client inject R (" + hex_len + " bytes) failed (no socket yet?)");
-            break;
-          }
-          case 'K':
-            log_.sock(LogLevel::trace, "Kore keepalive");
-            break;
-
-          default:
-            log_.sock(LogLevel::warn, std::string("Unknown frame kind: ") + kind);
-            break;
-        }
-      });
+  link_.on_frame([this](char kind, std::span<const std::byte> payload)
+                 { on_kore_frame(kind, payload); });
 
   // ---- Install hook before connecting --------------------------------------
   if (!hook_.install())
@@ -110,6 +105,71 @@ void BridgeService::start()
   pol.jitter_p = cfg_.kore.reconnect.jitter_p;
   link_.set_reconnect_policy(pol);
 
+  // Connection pool (all candidate ports must lead to the same Kore instance)
+  ports::LinkOptions opt;
+  opt.pool_size = cfg_.kore.pool_size;
+  opt.connect_race = cfg_.kore.connect_race;
+
+  // Version/feature exchange ('Z' is offered only with a codec configured)
+  opt.handshake.enabled = cfg_.kore.handshake.enabled;
+  opt.handshake.timeout = std::chrono::milliseconds(cfg_.kore.handshake.timeout_ms);
+  if (cfg_.relay.framing == "lz") opt.handshake.features |= env::kFeatCompress;
+
+  // Outgoing queue bounds / load shedding
+  const auto& q = cfg_.kore.queue;
+  opt.queue.max_bytes = q.max_bytes;
+  opt.queue.max_frames = q.max_frames;
+  opt.queue.ttl = std::chrono::milliseconds(q.ttl_ms);
+  opt.queue.shed_opcodes = q.shed_opcodes;
+  if (q.policy == "drop_newest")
+    opt.queue.policy = ports::ShedPolicy::drop_newest;
+  else if (q.policy == "drop_class")
+    opt.queue.policy = ports::ShedPolicy::drop_class;
+  else if (q.policy == "drop_oldest")
+    opt.queue.policy = ports::ShedPolicy::drop_oldest;
+  else
+    log_.app(LogLevel::warn, "Unknown [kore.queue] policy '" + q.policy + "'; using drop_oldest");
+
+  // Priority lanes (opcode -> lane)
+  const auto& ln = cfg_.kore.lanes;
+  if (ln.fallback == "control")
+    opt.lanes.fallback = ports::Lane::control;
+  else if (ln.fallback == "bulk")
+    opt.lanes.fallback = ports::Lane::bulk;
+  else if (ln.fallback == "interactive")
+    opt.lanes.fallback = ports::Lane::interactive;
+  else
+    log_.app(LogLevel::warn,
+             "Unknown [kore.lanes] default '" + ln.fallback + "'; using interactive");
+  for (uint16_t op : ln.control) opt.lanes.opcodes.emplace_back(op, ports::Lane::control);
+  for (uint16_t op : ln.interactive) opt.lanes.opcodes.emplace_back(op, ports::Lane::interactive);
+  for (uint16_t op : ln.bulk) opt.lanes.opcodes.emplace_back(op, ports::Lane::bulk);
+  for (std::size_t i = 0; i < opt.lanes.weights.size() && i < ln.weights.size(); ++i)
+    opt.lanes.weights[i] = ln.weights[i];
+
+  // Micro-batching ('B' envelopes, where Kore announced them)
+  opt.batch.window = std::chrono::microseconds(cfg_.kore.batch.window_us);
+  opt.batch.max_bytes = cfg_.kore.batch.max_bytes;
+
+  // Keepalive probes (RTT, dead-peer detection)
+  opt.keepalive.interval = std::chrono::milliseconds(cfg_.kore.keepalive.interval_ms);
+  opt.keepalive.min_interval = std::chrono::milliseconds(cfg_.kore.keepalive.min_interval_ms);
+  opt.keepalive.dead_after = std::chrono::milliseconds(cfg_.kore.keepalive.dead_after_ms);
+
+  // Sequencing and replay after reconnect ('Q'/'A', where Kore announced them)
+  opt.replay.buffer_bytes = cfg_.kore.replay.buffer_bytes;
+
+  // Disk spill of overflow frames during long outages
+  if (cfg_.kore.spill.enabled)
+  {
+    opt.spill.dir = cfg_.logsDir + "/spill";
+    opt.spill.segment_bytes = cfg_.kore.spill.segment_bytes;
+    opt.spill.max_bytes = cfg_.kore.spill.max_bytes;
+    opt.spill.drain_rate = cfg_.kore.spill.drain_bytes_per_sec;
+  }
+
+  link_.set_options(opt);
+
   // Provide full candidate list (round-robin + backoff handled by link)
   link_.set_candidate_ports(ports);
 
@@ -119,6 +179,83 @@ void BridgeService::start()
   log_.app(LogLevel::info, "BridgeService started.");
 }
 
+void BridgeService::on_kore_frame(char kind, std::span<const std::byte> payload)
+{
+  switch (kind)
+  {
+    case 'S':
+    {
+      if (recorder_) recorder_->record(FlightEvent::inject_send, payload);
+      const bool ok = hook_.try_inject_send(payload);
+      if (ok)
+        log_.sockf(LogLevel::debug, "Kore→client inject S ({} bytes) ok", payload.size());
+      else
+        log_.sockf(LogLevel::warn, "Kore→client inject S ({} bytes) failed (no socket yet?)",
+                   payload.size());
+      break;
+    }
+    case 'R':
+    {
+      if (recorder_) recorder_->record(FlightEvent::inject_recv, payload);
+      const bool ok = hook_.try_inject_recv(payload);
+      if (ok)
+        log_.sockf(LogLevel::debug, "Kore→client inject R ({} bytes) ok", payload.size());
+      else
+        log_.sockf(LogLevel::warn, "Kore→client inject R ({} bytes) failed (no socket yet?)",
+                   payload.size());
+      break;
+    }
+    case 'K':
+      log_.sock(LogLevel::trace, "Kore keepalive");
+      break;
+
+    case 'B':
+    {
+      // micro-batch: many injections in one frame, delivered in order
+      const bool ok = domain::protocol::envelope::for_each_subframe(
+          payload, [this](char k, std::span<const std::byte> p) { on_kore_frame(k, p); });
+      if (!ok)
+        log_.sockf(LogLevel::warn, "Kore batch ({} bytes) malformed; rest dropped", payload.size());
+      break;
+    }
+
+    case 'Z':
+    {
+      // compressed S/R: [opcode16][inner kind][codec block]
+      const char inner = payload.size() >= env::kCompressedPrefix
+                             ? static_cast<char>(std::to_integer<unsigned char>(payload[2]))
+                             : char{0};
+      if ((inner != env::kSend && inner != env::kRecv) ||
+          !codec_.decompress(payload.subspan(env::kCompressedPrefix), unz_))
+      {
+        log_.sockf(LogLevel::warn, "Kore compressed frame ({} bytes) undecodable", payload.size());
+        break;
+      }
+      on_kore_frame(inner, unz_);
+      break;
+    }
+
+    case env::kDump:
+    {
+      // flight recorder dump requested by Kore (e.g. right after it noticed a desync)
+      if (!recorder_)
+      {
+        log_.app(LogLevel::warn, "Kore asked for a flight recorder dump; recorder is off");
+        break;
+      }
+      const bool ok = recorder_->dump("kore");
+      log_.app(ok ? LogLevel::info : LogLevel::warn,
+               ok ? "Flight recorder dumped (requested by Kore)"
+                  : "Flight recorder dump requested by Kore failed");
+      break;
+    }
+
+    default:
+      log_.sockf(LogLevel::warn, "Unknown frame kind: {}", kind);
+      break;
+  }
+}
+
 void BridgeService::stop()
 {
   if (!running_) return;
@@ -1,4 +1,8 @@
 #pragma once
+#include <span>
+#include <vector>
+
+#include "application/ports/IFlightRecorder.hpp"
 #include "application/ports/IFrameCodec.hpp"
 #include "application/ports/IHook.hpp"
 #include "application/ports/IKoreLink.hpp"
@@ -13,8 +17,9 @@ class BridgeService
 {
  public:
   BridgeService(ports::IHook& hook, ports::IKoreLink& link, ports::IFrameCodec& codec,
-                ports::ILogger& logger, const domain::Settings& s)
-      : hook_(hook), link_(link), codec_(codec), log_(logger), cfg_(s)
+                ports::ILogger& logger, const domain::Settings& s,
+                ports::IFlightRecorder* recorder = nullptr)
+      : hook_(hook), link_(link), codec_(codec), log_(logger), cfg_(s), recorder_(recorder)
   {
   }
 
@@ -22,12 +27,20 @@ class BridgeService
   void stop();
 
  private:
+  // Kore -> client: one frame ('B' batches are unpacked into their sub-frames)
+  void on_kore_frame(char kind, std::span<const std::byte> payload);
+
   ports::IHook& hook_;
   ports::IKoreLink& link_;
   ports::IFrameCodec& codec_;
   ports::ILogger& log_;
   const domain::Settings& cfg_;
+  ports::IFlightRecorder* recorder_;  // optional: packets, injections, state transitions
   bool running_{false};
+
+  // codec scratch: zbuf_ on the hook thread (client -> Kore), unz_ on the link thread
+  std::vector<std::byte> zbuf_;
+  std::vector<std::byte> unz_;
 };
 
 }  // namespace arkan::relay::application::services
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -18,20 +19,93 @@ struct Settings
     double jitter_p{0.2};
   };
 
+  // 'H' version/feature exchange on connect (enabled = false: use configured features blindly)
+  struct Handshake
+  {
+    bool enabled{true};
+    int timeout_ms{1000};  // then Kore gets the original R/S/K envelope
+  };
+
+  // Outgoing queue bounds while Kore is slow/unreachable (0 = no limit)
+  struct Queue
+  {
+    std::size_t max_bytes{8u << 20};
+    std::size_t max_frames{0};
+    int ttl_ms{3000};
+    std::string policy{"drop_oldest"};  // drop_oldest | drop_newest | drop_class
+    std::vector<uint16_t> shed_opcodes;  // drop_class: opcodes shed first
+  };
+
+  // Send-path priority lanes: RO opcodes mapped to control / interactive / bulk
+  struct Lanes
+  {
+    std::string fallback{"interactive"};  // lane of opcodes not listed
+    std::vector<uint16_t> control;
+    std::vector<uint16_t> interactive;
+    std::vector<uint16_t> bulk;
+    std::vector<unsigned> weights{8, 4, 1};  // control, interactive, bulk
+  };
+
+  // Micro-batching of relay -> Kore frames into 'B' envelopes (window_us = 0: off)
+  struct Batch
+  {
+    int window_us{0};
+    std::size_t max_bytes{16 * 1024};
+  };
+
+  // RTT-measuring keepalive probes and dead-peer detection (dead_after_ms = 0: never drop)
+  struct Keepalive
+  {
+    int interval_ms{5000};
+    int min_interval_ms{250};
+    int dead_after_ms{15000};
+  };
+
+  // Sequence numbers, acks from Kore and replay after reconnect (buffer_bytes = 0: off)
+  struct Replay
+  {
+    std::size_t buffer_bytes{0};
+  };
+
+  // Overflow frames journaled under <logsDir>/spill during long outages, fed back after reconnect
+  struct Spill
+  {
+    bool enabled{false};
+    std::size_t segment_bytes{16u << 20};
+    std::size_t max_bytes{1u << 30};
+    std::size_t drain_bytes_per_sec{4u << 20};
+  };
+
   struct Kore
   {
     std::string host{"127.0.0.1"};
     std::vector<uint16_t> ports{5293, 5294, 5295};
+    std::size_t pool_size{1};  // live connections (1 = single connection with failover)
+    std::size_t connect_race{1};  // ports tried at once per (re)connect
+    std::string transport{"tcp"};        // tcp | shm (shared memory, same host only)
+    std::size_t shm_ring_bytes{1u << 20};  // shm: bytes per direction
     Reconnect reconnect{};
+    Handshake handshake{};
+    Queue queue{};
+    Lanes lanes{};
+    Batch batch{};
+    Keepalive keepalive{};
+    Replay replay{};
+    Spill spill{};
   } kore;
 
   struct Relay
   {
-    int ioThreads{2};
+    int ioThreads{2};           // workers of the shared I/O pool (Kore link, timers)
+    std::vector<int> ioCpus;    // worker i is pinned to ioCpus[i % size] (empty = no pinning)
+    int ioSpinUs{0};            // busy-poll budget before a worker blocks (0 = always block)
+    bool ioHighPriority{false};  // raise the I/O workers' thread priority
     std::size_t recvBuffer{65536};
     std::size_t sendBuffer{65536};
     std::size_t maxSessions{512};
-    std::string framing{"none"};
+    std::string framing{"none"};    // none | lz (compress large 'R' payloads as 'Z' frames)
+    std::size_t compressMin{256};  // lz: smaller payloads are sent as-is
+    std::string dictionary;        // lz: raw dictionary file shared with Kore (optional)
   } relay;
 
   // Console / Logs
@@ -41,6 +115,12 @@ struct Settings
   std::string logsDir{"logs"};
   std::string appLogFilename{"relay_app.log"};
   std::string socketLogFilename{"relay_socket.log"};
+  std::string socketLogFormat{"text"};  // text | binary (packets as records in <stem>-N.pkt)
+  uint32_t socketSampleEvery{1};         // info/debug socket lines: keep 1 in N per message site
+  uint32_t socketRateLimit{20};          // warn+ socket lines per message site per second (0 = off)
+  bool flightRecorder{true};             // last packets/state kept in memory, dumped on demand
+  std::size_t flightRecorderBytes{8u << 20};
+  uint32_t flightRecorderSeconds{60};    // dumps leave out older entries (0 = all in memory)
   std::string configPath{"arkan-relay.toml"};
 
   std::optional<std::string> fnSeedAddr;
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace arkan::relay::domain::protocol::envelope
+{
+
+// Relay <-> Kore envelope: [kind][len16 LE][payload]
+inline constexpr std::size_t kHeaderSize = 3;
+inline constexpr std::size_t kMaxPayload = 0xFFFF;
+
+// ---- Frame kinds ----
+inline constexpr char kRecv = 'R';        // server -> client packet
+inline constexpr char kSend = 'S';        // client -> server packet
+inline constexpr char kKeepalive = 'K';   // link keepalive (empty) or RTT probe (see below)
+inline constexpr char kBatch = 'B';       // payload is a run of complete non-'B' frames
+inline constexpr char kCompressed = 'Z';  // payload is [opcode16][inner kind][codec block]
+inline constexpr char kFragment = 'F';    // payload is [inner kind][flags][chunk]
+inline constexpr char kSequence = 'Q';    // relay -> Kore: numbering of the frames that follow
+inline constexpr char kAck = 'A';         // Kore -> relay: [seq32 LE] cumulative acknowledgement
+inline constexpr char kCredit = 'C';      // Kore -> relay: flow-control grant (see below)
+inline constexpr char kHello = 'H';       // both ways: protocol version and features (see below)
+inline constexpr char kDump = 'D';        // Kore -> relay: write the flight recorder to a file
+
+// 'H': [version16 LE][features32 LE][max_frame32 LE], the relay's first frame on every connection.
+// A Kore that answers with its own 'H' gets the features both sides list; until it answers (and
+// for good if it never does) the relay speaks the original R/S/K envelope only. max_frame is the
+// largest logical payload the sender accepts (0 = no stated limit). Bytes past these fields are
+// for later versions and are ignored.
+inline constexpr std::size_t kHelloSize = 10;
+inline constexpr uint16_t kHelloVersion = 1;
+
+// 'H' feature bits
+inline constexpr uint32_t kFeatBatch = 1u << 0;       // 'B' batches
+inline constexpr uint32_t kFeatCompress = 1u << 1;    // 'Z' frames (same codec/dictionary)
+inline constexpr uint32_t kFeatSequence = 1u << 2;    // 'Q'/'A' numbering and replay
+inline constexpr uint32_t kFeatFragments = 1u << 3;   // 'F' runs (payloads over kMaxPayload)
+inline constexpr uint32_t kFeatTimestamps = 1u << 4;  // timestamped 'K' probes, echoed back
+inline constexpr uint32_t kFeatCredit = 1u << 5;      // 'C' grants
+inline constexpr uint32_t kFeatAll = 0xFFFFFFFFu;
+
+// 'K' probe: [seq32 LE][sent_us64 LE]. The receiver echoes it back unchanged; an empty 'K' is
+// a plain keepalive and needs no answer.
+inline constexpr std::size_t kKeepaliveProbe = 12;
+
+// 'Q': [session32 LE][stream16 LE][next_seq32 LE], sent first on every (re)connected connection
+// when sequencing is on. Every frame written after it on that connection is numbered, starting at
+// next_seq: all kinds except 'K', 'Q' and 'B' itself (each 'B' sub-frame and each 'F' fragment
+// counts as one). A stream (session + connection id) already seen resumes where the relay's
+// unacknowledged frames start, so frames up to the last one Kore processed arrive again and are
+// to be skipped; a next_seq past that means frames were lost. Kore acknowledges with 'A'.
+inline constexpr std::size_t kSequenceSize = 10;
+inline constexpr std::size_t kAckSize = 4;
+
+// 'C': [bytes32 LE][frames32 LE], credit Kore adds to the connection it arrives on (0 = no grant
+// in that unit). A unit is unlimited until Kore first grants in it; from then on the relay writes
+// queued frames on that connection only while it has credit left in the unit. Credit resets with
+// the connection.
+inline constexpr std::size_t kCreditSize = 8;
+
+// 'Z' keeps the packet opcode in the clear so lanes and load shedding still see it
+inline constexpr std::size_t kCompressedPrefix = 3;
+
+// 'F' frames carry one logical frame larger than kMaxPayload as a run of consecutive fragments
+// (same connection, nothing interleaved); the receiver concatenates the chunks.
+inline constexpr std::size_t kFragmentPrefix = 2;
+inline constexpr std::size_t kMaxFragmentChunk = kMaxPayload - kFragmentPrefix;
+inline constexpr uint8_t kFragFirst = 0x01;
+inline constexpr uint8_t kFragLast = 0x02;
+inline constexpr std::size_t kMaxLogicalFrame = 16u << 20;  // reassembly cap
+
+// Calls fn(kind, payload) for every sub-frame of a 'B' payload, in order.
+// Returns false if the payload ends in a truncated sub-frame or nests a batch (sub-frames
+// before the bad one have already been delivered).
+template <class Fn>
+bool for_each_subframe(std::span<const std::byte> batch, Fn&& fn)
+{
+  std::size_t off = 0;
+  while (off < batch.size())
+  {
+    if (batch.size() - off < kHeaderSize) return false;
+
+    const char kind = static_cast<char>(std::to_integer<unsigned char>(batch[off]));
+    const std::size_t len = std::to_integer<std::size_t>(batch[off + 1]) |
+                            (std::to_integer<std::size_t>(batch[off + 2]) << 8);
+    if (kind == kBatch || batch.size() - off - kHeaderSize < len) return false;
+
+    fn(kind, batch.subspan(off + kHeaderSize, len));
+    off += kHeaderSize + len;
+  }
+  return true;
+}
+
+// Splits a logical frame into its 'F' run: calls fn(head, chunk) for every fragment, where
+// `head` is the complete 5-byte prefix ([F][len16][kind][flags]) to write before `chunk`.
+template <class Fn>
+void for_each_fragment(char kind, std::span<const std::byte> payload, Fn&& fn)
+{
+  for (std::size_t off = 0; off < payload.size();)
+  {
+    const std::size_t n = (std::min)(kMaxFragmentChunk, payload.size() - off);
+    uint8_t flags = 0;
+    if (off == 0) flags |= kFragFirst;
+    if (off + n == payload.size()) flags |= kFragLast;
+
+    const std::size_t len = kFragmentPrefix + n;
+    const std::array<std::byte, kHeaderSize + kFragmentPrefix> head{
+        static_cast<std::byte>(kFragment), static_cast<std::byte>(len & 0xFF),
+        static_cast<std::byte>((len >> 8) & 0xFF), static_cast<std::byte>(kind),
+        static_cast<std::byte>(flags)};
+    fn(std::span<const std::byte>(head), payload.subspan(off, n));
+    off += n;
+  }
+}
+
+}  // namespace arkan::relay::domain::protocol::envelope
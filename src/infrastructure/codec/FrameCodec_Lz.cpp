@@ -0,0 +1,258 @@
+#include "infrastructure/codec/FrameCodec_Lz.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace arkan::relay::infrastructure::codec
+{
+
+namespace
+{
+constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+constexpr std::size_t kMaxOffset = 0xFFFF;
+
+uint32_t read32(const std::byte* p)
+{
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+uint32_t hash4(uint32_t v, unsigned bits)
+{
+  return (v * 2654435761u) >> (32 - bits);
+}
+
+uint32_t fnv1a(std::span<const std::byte> s)
+{
+  uint32_t h = 2166136261u;
+  for (std::byte b : s) h = (h ^ std::to_integer<uint32_t>(b)) * 16777619u;
+  return h == 0 ? 1 : h;  // 0 means "no dictionary" on the wire
+}
+
+void put_u16(std::vector<std::byte>& out, std::size_t v)
+{
+  out.push_back(static_cast<std::byte>(v & 0xFF));
+  out.push_back(static_cast<std::byte>((v >> 8) & 0xFF));
+}
+
+void put_ext(std::vector<std::byte>& out, std::size_t v)
+{
+  while (v >= 255)
+  {
+    out.push_back(std::byte{255});
+    v -= 255;
+  }
+  out.push_back(static_cast<std::byte>(v));
+}
+
+bool get_ext(std::span<const std::byte> in, std::size_t& ip, std::size_t& v)
+{
+  for (;;)
+  {
+    if (ip >= in.size()) return false;
+    const auto b = std::to_integer<std::size_t>(in[ip++]);
+    v += b;
+    if (b != 255) return true;
+  }
+}
+}  // namespace
+
+// -------------------- ctor/dictionary --------------------
+FrameCodec_Lz::FrameCodec_Lz(std::size_t min_bytes)
+    : min_bytes_(min_bytes), dict_table_(std::size_t{1} << kHashBits, kEmpty)
+{
+}
+
+void FrameCodec_Lz::set_dictionary(std::span<const std::byte> dict)
+{
+  if (dict.size() > kMaxDictionary) dict = dict.last(kMaxDictionary);
+  dict_.assign(dict.begin(), dict.end());
+  dict_id_ = dict_.empty() ? 0 : fnv1a(dict_);
+
+  dict_table_.assign(std::size_t{1} << kHashBits, kEmpty);
+  for (std::size_t p = 0; p + kMinMatch <= dict_.size(); ++p)
+    dict_table_[hash4(read32(dict_.data() + p), kHashBits)] = static_cast<uint32_t>(p);
+
+  // the dictionary stays at the front of the window; payloads are copied in behind it
+  window_.assign(dict_.begin(), dict_.end());
+}
+
+bool FrameCodec_Lz::load_dictionary(const std::string& path)
+{
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+
+  std::vector<char> raw((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+  set_dictionary(std::span<const std::byte>(reinterpret_cast<const std::byte*>(raw.data()),
+                                            raw.size()));
+  return true;
+}
+
+// -------------------- encode --------------------
+bool FrameCodec_Lz::compress(std::span<const std::byte> payload, std::vector<std::byte>& out)
+{
+  const std::size_t n = payload.size();
+  if (n < min_bytes_ || n < kMinMatch || n > 0xFFFF) return false;
+
+  const std::size_t dsize = dict_.size();
+  window_.resize(dsize + n);
+  std::memcpy(window_.data() + dsize, payload.data(), n);
+  table_ = dict_table_;
+
+  const std::size_t start = out.size();
+  put_u16(out, n);
+  for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::byte>((dict_id_ >> (8 * i)) & 0xFF));
+
+  const std::byte* w = window_.data();
+  const std::size_t end = dsize + n;
+  std::size_t ip = dsize, anchor = dsize;
+
+  auto emit = [&](std::size_t lit_end, std::size_t offset, std::size_t mlen)
+  {
+    const std::size_t lit = lit_end - anchor;
+    const std::size_t mcode = mlen ? mlen - kMinMatch : 0;
+    out.push_back(static_cast<std::byte>(((std::min<std::size_t>)(lit, 15) << 4) |
+                                         (std::min<std::size_t>)(mcode, 15)));
+    if (lit >= 15) put_ext(out, lit - 15);
+    out.insert(out.end(), w + anchor, w + lit_end);
+    if (mlen == 0) return;
+    put_u16(out, offset);
+    if (mcode >= 15) put_ext(out, mcode - 15);
+  };
+
+  while (ip + kMinMatch <= end)
+  {
+    const uint32_t seq = read32(w + ip);
+    uint32_t& slot = table_[hash4(seq, kHashBits)];
+    const uint32_t cand = slot;
+    slot = static_cast<uint32_t>(ip);
+
+    if (cand == kEmpty || ip - cand > kMaxOffset || read32(w + cand) != seq)
+    {
+      ++ip;
+      continue;
+    }
+
+    std::size_t len = kMinMatch;
+    while (ip + len < end && w[cand + len] == w[ip + len]) ++len;
+
+    emit(ip, ip - cand, len);
+    ip += len;
+    anchor = ip;
+  }
+  emit(end, 0, 0);
+
+  // not worth a 'Z' frame: the caller sends the payload as-is
+  if (out.size() - start >= n)
+  {
+    out.resize(start);
+    return false;
+  }
+  return true;
+}
+
+// -------------------- decode --------------------
+bool FrameCodec_Lz::decompress(std::span<const std::byte> in, std::vector<std::byte>& out)
+{
+  if (in.size() < kBlockHeader) return false;
+
+  const std::size_t raw =
+      std::to_integer<std::size_t>(in[0]) | (std::to_integer<std::size_t>(in[1]) << 8);
+  uint32_t id = 0;
+  for (int i = 0; i < 4; ++i) id |= std::to_integer<uint32_t>(in[2 + i]) << (8 * i);
+  if (id != 0 && id != dict_id_) return false;  // peer primed with another dictionary
+  const std::size_t dsize = id != 0 ? dict_.size() : 0;
+
+  out.resize(raw);
+  std::size_t ip = kBlockHeader, op = 0;
+  while (ip < in.size())
+  {
+    const auto token = std::to_integer<std::size_t>(in[ip++]);
+
+    std::size_t lit = token >> 4;
+    if (lit == 15 && !get_ext(in, ip, lit)) return false;
+    if (lit > in.size() - ip || lit > raw - op) return false;
+    if (lit) std::memcpy(out.data() + op, in.data() + ip, lit);
+    ip += lit;
+    op += lit;
+    if (ip == in.size()) break;  // last sequence carries literals only
+
+    if (in.size() - ip < 2) return false;
+    const std::size_t offset =
+        std::to_integer<std::size_t>(in[ip]) | (std::to_integer<std::size_t>(in[ip + 1]) << 8);
+    ip += 2;
+    std::size_t mlen = token & 15;
+    if (mlen == 15 && !get_ext(in, ip, mlen)) return false;
+    mlen += kMinMatch;
+    if (offset == 0 || offset > op + dsize || mlen > raw - op) return false;
+
+    // byte by byte: matches may overlap their own output or start in the dictionary
+    for (std::size_t k = 0; k < mlen; ++k, ++op)
+      out[op] = op >= offset ? out[op - offset] : dict_[dsize - (offset - op)];
+  }
+  return op == raw;
+}
+
+// -------------------- dictionary training --------------------
+std::vector<std::byte> FrameCodec_Lz::train(const std::vector<std::vector<std::byte>>& samples,
+                                            std::size_t max_size)
+{
+  constexpr std::size_t kGram = 8;
+  constexpr std::size_t kSegment = 32;
+  max_size = (std::min)(max_size, kMaxDictionary);
+
+  auto gram_at = [](const std::byte* p)
+  {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  };
+
+  // how often each 8-byte sequence occurs across the capture
+  std::unordered_map<uint64_t, uint32_t> freq;
+  for (const auto& s : samples)
+    for (std::size_t p = 0; p + kGram <= s.size(); ++p) ++freq[gram_at(s.data() + p)];
+
+  // score half-overlapping segments by the repeats they contain
+  struct Segment
+  {
+    uint64_t score;
+    const std::byte* data;
+  };
+  std::vector<Segment> segs;
+  for (const auto& s : samples)
+  {
+    for (std::size_t p = 0; p + kSegment <= s.size(); p += kSegment / 2)
+    {
+      uint64_t score = 0;
+      for (std::size_t g = p; g + kGram <= p + kSegment; ++g)
+        score += freq[gram_at(s.data() + g)] - 1;
+      if (score != 0) segs.push_back({score, s.data() + p});
+    }
+  }
+  std::stable_sort(segs.begin(), segs.end(),
+                   [](const Segment& a, const Segment& b) { return a.score > b.score; });
+
+  // best segments first, skipping duplicates, then reversed so the best end up last
+  std::unordered_set<std::string> seen;
+  std::vector<const Segment*> picked;
+  for (const auto& sg : segs)
+  {
+    if ((picked.size() + 1) * kSegment > max_size) break;
+    if (seen.emplace(reinterpret_cast<const char*>(sg.data), kSegment).second)
+      picked.push_back(&sg);
+  }
+
+  std::vector<std::byte> dict;
+  dict.reserve(picked.size() * kSegment);
+  for (auto it = picked.rbegin(); it != picked.rend(); ++it)
+    dict.insert(dict.end(), (*it)->data, (*it)->data + kSegment);
+  return dict;
+}
+
+}  // namespace arkan::relay::infrastructure::codec
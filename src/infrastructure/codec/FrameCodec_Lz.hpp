@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "application/ports/IFrameCodec.hpp"
+
+namespace arkan::relay::infrastructure::codec
+{
+
+// -----------------------------------------------------------------------------
+// FrameCodec_Lz
+//  - Dependency-free LZ77 codec (LZ4-style sequences) for 'Z' frames.
+//  - Optionally primed with a raw dictionary: matches may reach back into its
+//    last 64 KiB, so even short, repetitive RO packets (inventory lists, map
+//    loads) compress well. Both peers must load the same dictionary; its id is
+//    carried in every block and checked on decode.
+//  - Payloads shorter than `min_bytes`, or that would not shrink, are left as-is.
+//  - compress() uses per-instance scratch (one producing thread); decompress()
+//    only reads the dictionary and may run concurrently on another thread.
+//
+// Block layout: [raw_len16 LE][dict_id32 LE (0 = none)][sequences...]
+//   sequence = [token: lit_len<<4 | (match_len-4)][lit_len ext][literals]
+//              [offset16 LE][match_len ext]        (the last one has no match)
+//   ext bytes: while the nibble is 15, add bytes (255 means "more follows").
+// -----------------------------------------------------------------------------
+class FrameCodec_Lz final : public arkan::relay::application::ports::IFrameCodec
+{
+ public:
+  static constexpr std::size_t kBlockHeader = 6;
+  static constexpr std::size_t kMaxDictionary = 64 * 1024;
+
+  explicit FrameCodec_Lz(std::size_t min_bytes = 256);
+
+  // Primes both directions with `dict` (only its last 64 KiB are used)
+  void set_dictionary(std::span<const std::byte> dict);
+  bool load_dictionary(const std::string& path);
+  uint32_t dictionary_id() const
+  {
+    return dict_id_;
+  }
+
+  // IFrameCodec
+  bool compress(std::span<const std::byte> payload, std::vector<std::byte>& out) override;
+  bool decompress(std::span<const std::byte> block, std::vector<std::byte>& out) override;
+
+  // Builds a dictionary from captured payloads: the most frequently repeated
+  // segments, most valuable last (closest to the data, cheapest offsets).
+  static std::vector<std::byte> train(const std::vector<std::vector<std::byte>>& samples,
+                                      std::size_t max_size = kMaxDictionary);
+
+ private:
+  static constexpr unsigned kHashBits = 12;
+  static constexpr std::size_t kMinMatch = 4;
+
+  std::size_t min_bytes_;
+  std::vector<std::byte> dict_;
+  uint32_t dict_id_{0};
+  std::vector<uint32_t> dict_table_;  // hash -> position, prefilled from the dictionary
+  std::vector<uint32_t> table_;       // scratch copy used by compress()
+  std::vector<std::byte> window_;     // scratch: dictionary + payload, back to back
+};
+
+}  // namespace arkan::relay::infrastructure::codec
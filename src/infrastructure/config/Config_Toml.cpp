@@ -33,6 +33,16 @@ static std::string join_ports(const std::vector<uint16_t>& v)
   return oss.str();
 }
 
+static void read_u16_array(const toml::array* arr, std::vector<uint16_t>& out)
+{
+  if (!arr) return;
+  out.clear();
+  for (auto& e : *arr)
+  {
+    if (auto v = e.value<int64_t>()) out.push_back(static_cast<uint16_t>(*v));
+  }
+}
+
 static void ensure_non_empty_ports(std::vector<uint16_t>& ports)
 {
   if (!ports.empty()) return;
@@ -63,7 +73,13 @@ void Config_Toml::write_default(const fs::path& path, Settings& s)
   out << "saveSocketLog     = " << (s.saveSocketLog ? "true" : "false") << "\n";
   out << "logsDir           = \"" << kDefaultLogsDir << "\"\n";
   out << "appLogFilename    = \"" << kDefaultAppLog << "\"\n";
-  out << "socketLogFilename = \"" << kDefaultSocketLog << "\"\n\n";
+  out << "socketLogFilename = \"" << kDefaultSocketLog << "\"\n";
+  out << "socketLogFormat   = \"text\"\n";
+  out << "sampleEvery       = 1\n";
+  out << "rateLimit         = 20\n";
+  out << "flightRecorder    = true\n";
+  out << "flightRecorderBytes = 8388608\n";
+  out << "flightRecorderSeconds = 60\n\n";
 
   // [kore]
   // prefer values already in Settings, otherwise use defaults
@@ -72,14 +88,71 @@ void Config_Toml::write_default(const fs::path& path, Settings& s)
 
   out << "[kore]\n";
   out << "host  = \"" << s.kore.host << "\"\n";
-  out << "ports = [" << join_ports(s.kore.ports) << "]\n\n";
+  out << "ports = [" << join_ports(s.kore.ports) << "]\n";
+  out << "pool_size = " << s.kore.pool_size << "\n";
+  out << "connect_race = " << s.kore.connect_race << "\n";
+  out << "transport = \"" << s.kore.transport << "\"\n";
+  out << "shm_ring_bytes = " << s.kore.shm_ring_bytes << "\n\n";
 
   // [kore.reconnect] (defaults)
   out << "[kore.reconnect]\n";
   out << "initial_ms = 500\n";
   out << "max_ms     = 30000\n";
   out << "backoff    = 2.0\n";
-  out << "jitter_p   = 0.2\n";
+  out << "jitter_p   = 0.2\n\n";
+
+  // [kore.handshake] (defaults)
+  out << "[kore.handshake]\n";
+  out << "enabled    = true\n";
+  out << "timeout_ms = 1000\n\n";
+
+  // [kore.queue] (defaults)
+  out << "[kore.queue]\n";
+  out << "max_bytes    = 8388608\n";
+  out << "max_frames   = 0\n";
+  out << "ttl_ms       = 3000\n";
+  out << "policy       = \"drop_oldest\"\n";
+  out << "shed_opcodes = []\n\n";
+
+  // [kore.lanes] (defaults)
+  out << "[kore.lanes]\n";
+  out << "default     = \"interactive\"\n";
+  out << "control     = []\n";
+  out << "interactive = []\n";
+  out << "bulk        = []\n";
+  out << "weights     = [8, 4, 1]\n\n";
+
+  // [kore.batch] (defaults)
+  out << "[kore.batch]\n";
+  out << "window_us = 0\n";
+  out << "max_bytes = 16384\n\n";
+
+  // [kore.keepalive] (defaults)
+  out << "[kore.keepalive]\n";
+  out << "interval_ms     = 5000\n";
+  out << "min_interval_ms = 250\n";
+  out << "dead_after_ms   = 15000\n\n";
+
+  // [kore.replay] (defaults)
+  out << "[kore.replay]\n";
+  out << "buffer_bytes = 0\n\n";
+
+  // [kore.spill] (defaults)
+  out << "[kore.spill]\n";
+  out << "enabled             = false\n";
+  out << "segment_bytes       = 16777216\n";
+  out << "max_bytes           = 1073741824\n";
+  out << "drain_bytes_per_sec = 4194304\n\n";
+
+  // [relay] (defaults)
+  out << "[relay]\n";
+  out << "ioThreads   = 2\n";
+  out << "ioCpus      = []\n";
+  out << "ioSpinUs    = 0\n";
+  out << "ioHighPriority = false\n";
+  out << "framing     = \"none\"\n";
+  out << "compressMin = 256\n";
+  out << "dictionary  = \"\"\n";
 
   out.close();
 
@@ -141,6 +214,16 @@ Settings Config_Toml::load_or_create(const std::string& configPath)
     if (auto v = (*log)["logsDir"].value<std::string>()) s.logsDir = *v;
     if (auto v = (*log)["appLogFilename"].value<std::string>()) s.appLogFilename = *v;
     if (auto v = (*log)["socketLogFilename"].value<std::string>()) s.socketLogFilename = *v;
+    if (auto v = (*log)["socketLogFormat"].value<std::string>()) s.socketLogFormat = *v;
+    if (auto v = (*log)["sampleEvery"].value<int64_t>(); v && *v > 0)
+      s.socketSampleEvery = static_cast<uint32_t>(*v);
+    if (auto v = (*log)["rateLimit"].value<int64_t>(); v && *v >= 0)
+      s.socketRateLimit = static_cast<uint32_t>(*v);
+    if (auto v = (*log)["flightRecorder"].value<bool>()) s.flightRecorder = *v;
+    if (auto v = (*log)["flightRecorderBytes"].value<int64_t>(); v && *v > 0)
+      s.flightRecorderBytes = static_cast<std::size_t>(*v);
+    if (auto v = (*log)["flightRecorderSeconds"].value<int64_t>(); v && *v >= 0)
+      s.flightRecorderSeconds = static_cast<uint32_t>(*v);
   }
 
   if (s.logsDir.empty()) s.logsDir = kDefaultLogsDir;
@@ -162,6 +245,15 @@ Settings Config_Toml::load_or_create(const std::string& configPath)
         if (auto p = e.value<int64_t>()) s.kore.ports.push_back(static_cast<uint16_t>(*p));
       }
     }
+
+    if (auto v = (*k)["pool_size"].value<int64_t>(); v && *v > 0)
+      s.kore.pool_size = static_cast<std::size_t>(*v);
+    if (auto v = (*k)["connect_race"].value<int64_t>(); v && *v > 0)
+      s.kore.connect_race = static_cast<std::size_t>(*v);
+
+    if (auto v = (*k)["transport"].value<std::string>()) s.kore.transport = *v;
+    if (auto v = (*k)["shm_ring_bytes"].value<int64_t>(); v && *v > 0)
+      s.kore.shm_ring_bytes = static_cast<std::size_t>(*v);
   }
 
   // fallback defaults if not provided
@@ -190,6 +282,146 @@ Settings Config_Toml::load_or_create(const std::string& configPath)
     if (auto rt = (*r)["reconnect"].as_table()) read_reconnect(rt);
   }
 
+  // ---------------------------
+  // [kore.handshake]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto hs = (*k)["handshake"].as_table())
+    {
+      if (auto v = (*hs)["enabled"].value<bool>()) s.kore.handshake.enabled = *v;
+      if (auto v = (*hs)["timeout_ms"].value<int64_t>(); v && *v > 0)
+        s.kore.handshake.timeout_ms = static_cast<int>(*v);
+    }
+  }
+
+  // ---------------------------
+  // [kore.queue]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto q = (*k)["queue"].as_table())
+    {
+      if (auto v = (*q)["max_bytes"].value<int64_t>(); v && *v >= 0)
+        s.kore.queue.max_bytes = static_cast<std::size_t>(*v);
+      if (auto v = (*q)["max_frames"].value<int64_t>(); v && *v >= 0)
+        s.kore.queue.max_frames = static_cast<std::size_t>(*v);
+      if (auto v = (*q)["ttl_ms"].value<int64_t>(); v && *v >= 0)
+        s.kore.queue.ttl_ms = static_cast<int>(*v);
+      if (auto v = (*q)["policy"].value<std::string>()) s.kore.queue.policy = *v;
+
+      read_u16_array((*q)["shed_opcodes"].as_array(), s.kore.queue.shed_opcodes);
+    }
+  }
+
+  // ---------------------------
+  // [kore.lanes]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto l = (*k)["lanes"].as_table())
+    {
+      if (auto v = (*l)["default"].value<std::string>()) s.kore.lanes.fallback = *v;
+      read_u16_array((*l)["control"].as_array(), s.kore.lanes.control);
+      read_u16_array((*l)["interactive"].as_array(), s.kore.lanes.interactive);
+      read_u16_array((*l)["bulk"].as_array(), s.kore.lanes.bulk);
+
+      if (auto arr = (*l)["weights"].as_array())
+      {
+        s.kore.lanes.weights.clear();
+        for (auto& e : *arr)
+        {
+          if (auto v = e.value<int64_t>(); v && *v > 0)
+            s.kore.lanes.weights.push_back(static_cast<unsigned>(*v));
+        }
+      }
+    }
+  }
+
+  // ---------------------------
+  // [kore.batch]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto b = (*k)["batch"].as_table())
+    {
+      if (auto v = (*b)["window_us"].value<int64_t>(); v && *v >= 0)
+        s.kore.batch.window_us = static_cast<int>(*v);
+      if (auto v = (*b)["max_bytes"].value<int64_t>(); v && *v > 0)
+        s.kore.batch.max_bytes = static_cast<std::size_t>(*v);
+    }
+  }
+
+  // ---------------------------
+  // [kore.keepalive]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto ka = (*k)["keepalive"].as_table())
+    {
+      if (auto v = (*ka)["interval_ms"].value<int64_t>(); v && *v > 0)
+        s.kore.keepalive.interval_ms = static_cast<int>(*v);
+      if (auto v = (*ka)["min_interval_ms"].value<int64_t>(); v && *v > 0)
+        s.kore.keepalive.min_interval_ms = static_cast<int>(*v);
+      if (auto v = (*ka)["dead_after_ms"].value<int64_t>(); v && *v >= 0)
+        s.kore.keepalive.dead_after_ms = static_cast<int>(*v);
+    }
+  }
+
+  // ---------------------------
+  // [kore.replay]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto rp = (*k)["replay"].as_table())
+    {
+      if (auto v = (*rp)["buffer_bytes"].value<int64_t>(); v && *v >= 0)
+        s.kore.replay.buffer_bytes = static_cast<std::size_t>(*v);
+    }
+  }
+
+  // ---------------------------
+  // [kore.spill]
+  // ---------------------------
+  if (auto k = tbl["kore"].as_table())
+  {
+    if (auto sp = (*k)["spill"].as_table())
+    {
+      if (auto v = (*sp)["enabled"].value<bool>()) s.kore.spill.enabled = *v;
+      if (auto v = (*sp)["segment_bytes"].value<int64_t>(); v && *v > 0)
+        s.kore.spill.segment_bytes = static_cast<std::size_t>(*v);
+      if (auto v = (*sp)["max_bytes"].value<int64_t>(); v && *v >= 0)
+        s.kore.spill.max_bytes = static_cast<std::size_t>(*v);
+      if (auto v = (*sp)["drain_bytes_per_sec"].value<int64_t>(); v && *v > 0)
+        s.kore.spill.drain_bytes_per_sec = static_cast<std::size_t>(*v);
+    }
+  }
+
+  // ---------------------------
+  // [relay]
+  // ---------------------------
+  if (auto r = tbl["relay"].as_table())
+  {
+    if (auto v = (*r)["ioThreads"].value<int64_t>(); v && *v > 0 && *v <= 64)
+      s.relay.ioThreads = static_cast<int>(*v);
+    if (auto arr = (*r)["ioCpus"].as_array())
+    {
+      s.relay.ioCpus.clear();
+      for (auto& e : *arr)
+      {
+        if (auto v = e.value<int64_t>(); v && *v >= 0)
+          s.relay.ioCpus.push_back(static_cast<int>(*v));
+      }
+    }
+    if (auto v = (*r)["ioSpinUs"].value<int64_t>(); v && *v >= 0 && *v <= 1000000)
+      s.relay.ioSpinUs = static_cast<int>(*v);
+    if (auto v = (*r)["ioHighPriority"].value<bool>()) s.relay.ioHighPriority = *v;
+    if (auto v = (*r)["framing"].value<std::string>()) s.relay.framing = *v;
+    if (auto v = (*r)["compressMin"].value<int64_t>(); v && *v >= 0)
+      s.relay.compressMin = static_cast<std::size_t>(*v);
+    if (auto v = (*r)["dictionary"].value<std::string>()) s.relay.dictionary = *v;
+  }
+
   return s;
 }
 
@@ -168,13 +168,21 @@ bool Hook_Win32::try_inject_recv(Bytes b)
 
 void Hook_Win32::emit_send(Bytes b)
 {
+  if (recorder) recorder->record(ports::FlightEvent::send, b);
   if (on_send) on_send(b);
 }
 void Hook_Win32::emit_recv(Bytes b)
 {
+  if (recorder) recorder->record(ports::FlightEvent::recv, b);
   if (on_recv) on_recv(b);
 }
 
+uint64_t Hook_Win32::socket_id() const
+{
+  const SOCKET s = p_->tramp.last_socket.load(std::memory_order_acquire);
+  return s == INVALID_SOCKET ? 0 : static_cast<uint64_t>(s);
+}
+
 void Hook_Win32::notify_socket(SOCKET s)
 {
   p_->tramp.last_socket.store(s, std::memory_order_release);
@@ -195,10 +203,8 @@ void Hook_Win32::requeue_with_backoff(InjectMsg item, const char* reason)
 
   if (item.attempts > MAX_INJECT_ATTEMPTS)
   {
-    char buf[256];
-    std::snprintf(buf, sizeof(buf), "[INJECT][SEND] dropping after max retries (%s) attempts=%u",
-                  reason, static_cast<unsigned>(item.attempts));
-    log_.sock(LogLevel::warn, buf);
+    log_.sockf(LogLevel::warn, "[INJECT][SEND] dropping after max retries ({}) attempts={}",
+               reason, static_cast<unsigned>(item.attempts));
     return;
   }
 
@@ -213,10 +219,8 @@ void Hook_Win32::requeue_with_backoff(InjectMsg item, const char* reason)
 
   // log debug with ms
   const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(delay).count();
-  char lb[256];
-  std::snprintf(lb, sizeof(lb), "[INJECT][SEND] requeued attempts=%u next_in=%lldms (%s)",
-                static_cast<unsigned>(item.attempts), static_cast<long long>(ms), reason);
-  log_.sock(LogLevel::debug, lb);
+  log_.sockf(LogLevel::debug, "[INJECT][SEND] requeued attempts={} next_in={}ms ({})",
+             static_cast<unsigned>(item.attempts), static_cast<long long>(ms), reason);
 }
 
 /* ------------------------ drain / send logic ------------------------ */
@@ -265,7 +269,7 @@ void Hook_Win32::drain_injected_sends_()
           im.next_try = std::chrono::steady_clock::time_point::min();
         inj_send_q_.push_front(std::move(im));
       }
-      log_.sock(LogLevel::warn, "[INJECT][SEND] hook not installed yet -> requeued message");
+      log_.sockf(LogLevel::warn, "[INJECT][SEND] hook not installed yet -> requeued message");
       return;
     }
 
@@ -292,26 +296,11 @@ void Hook_Win32::drain_injected_sends_()
       }
     } guard(p_->tramp.suppress_emit_send);
 
-    // Log short summary & limited hex dump (cheap)
-    {
-      char hexb[3 * HEX_DUMP_LIMIT + 64];
-      size_t p = 0;
-      const size_t take = std::min(HEX_DUMP_LIMIT, to_send.size());
-      for (size_t i = 0; i < take && p + 8 < sizeof(hexb); ++i)
-      {
-        p += std::snprintf(hexb + p, sizeof(hexb) - p, "%02X ", to_send[i]);
-      }
-      if (take < to_send.size())
-        p += std::snprintf(hexb + p, sizeof(hexb) - p, "...(%zu)", to_send.size());
-
-      char buf[512];
-      // convert SOCKET to an integer-sized type safely, then to long long for %lld
-      const auto socket_val = static_cast<intptr_t>(s);
-      std::snprintf(
-          buf, sizeof(buf), "[INJECT][SEND] socket=%lld len=%zu needs_checksum=%d data=%s",
-          static_cast<long long>(socket_val), to_send.size(), (int)im.needs_checksum, hexb);
-      log_.sock(LogLevel::debug, buf);
-    }
+    // Log short summary & limited hex dump (formatted by the logger thread)
+    log_.sockf(LogLevel::debug, "[INJECT][SEND] socket={} len={} needs_checksum={} data={}",
+               static_cast<long long>(static_cast<intptr_t>(s)), to_send.size(),
+               static_cast<int>(im.needs_checksum),
+               ports::LogHex{std::as_bytes(std::span(to_send)), HEX_DUMP_LIMIT});
 
     // call Trampolines::send ONCE for the whole logical message.
     int r = arkan::relay::infrastructure::win32::Trampolines::send(
@@ -320,10 +309,8 @@ void Hook_Win32::drain_injected_sends_()
     if (r == SOCKET_ERROR)
     {
       const int e = WSAGetLastError();
-      char eb[256];
-      std::snprintf(eb, sizeof(eb), "[INJECT][SEND] SOCKET_ERROR wsa=%d wrote=%d/%zu", e, r,
-                    to_send.size());
-      log_.sock(LogLevel::warn, eb);
+      log_.sockf(LogLevel::warn, "[INJECT][SEND] SOCKET_ERROR wsa={} wrote={}/{}", e, r,
+                 to_send.size());
 
       if (e == WSAECONNRESET || e == WSAENOTCONN || e == WSAECONNABORTED || e == WSAESHUTDOWN)
       {
@@ -340,15 +327,13 @@ void Hook_Win32::drain_injected_sends_()
         re.attempts = im.attempts;  // start from original attempts
         requeue_with_backoff(std::move(re), "socket_error");
       }
-      log_.sock(LogLevel::warn, "[INJECT][SEND] send failed -> message requeued");
+      log_.sockf(LogLevel::warn, "[INJECT][SEND] send failed -> message requeued");
     }
     else if (static_cast<size_t>(r) < to_send.size())
     {
       // partial write: requeue the original logical message (avoid partial transformations)
-      char wb[128];
-      std::snprintf(wb, sizeof(wb), "[INJECT][SEND] partial write=%d/%zu -> requeued", r,
-                    to_send.size());
-      log_.sock(LogLevel::warn, wb);
+      log_.sockf(LogLevel::warn, "[INJECT][SEND] partial write={}/{} -> requeued", r,
+                 to_send.size());
 
       InjectMsg re;
       re.data = std::move(im.data);
@@ -359,10 +344,8 @@ void Hook_Win32::drain_injected_sends_()
     else
     {
       // success: all bytes sent
-      char wb[128];
-      std::snprintf(wb, sizeof(wb), "[INJECT][SEND] wrote=%d total=%zu/%zu", r,
-                    static_cast<size_t>(r), to_send.size());
-      log_.sock(LogLevel::info, wb);
+      log_.sockf(LogLevel::info, "[INJECT][SEND] wrote={} total={}/{}", r, static_cast<size_t>(r),
+                 to_send.size());
     }
   }
 }
@@ -56,6 +56,7 @@ class Hook_Win32 : public ports::IHook
   void notify_socket(SOCKET s) override;
   void emit_send(Bytes) override;
   void emit_recv(Bytes) override;
+  uint64_t socket_id() const override;  // last socket seen by the trampolines
 
   // Non-copyable
   Hook_Win32(const Hook_Win32&) = delete;
@@ -4,8 +4,10 @@
 #include <winsock2.h>
 #include <ws2tcpip.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdio>
 #include <mutex>
 #include <span>
 #include <string>
@@ -30,6 +32,7 @@ namespace op = arkan::relay::domain::protocol::op;
 namespace app = arkan::relay::application::services;
 using arkan::relay::infrastructure::net::RecvPipeline;
 using arkan::relay::infrastructure::net::SendPipeline;
+using arkan::relay::application::ports::FlightEvent;
 
 // -----------------------------------------------------------------------------------------------
 // Minimal debug helpers
@@ -111,6 +114,48 @@ static inline void log_hex_buf(const char* tag, const uint8_t* p, size_t n, size
   dbg_str(arkan::relay::shared::hex::make_line(tag, sp, max));
 }
 
+// -----------------------------------------------------------------------------------------------
+// Flight recorder: checksum state transitions (session resets, 1C 0B seen, seed changes).
+// Counter steps are not recorded on their own: every send makes one.
+// -----------------------------------------------------------------------------------------------
+struct SeedSnapshot
+{
+  bool found1c0b;
+  uint32_t low, high;
+};
+
+static inline SeedSnapshot seed_of(const TrampState* S)
+{
+  return {S->found1c0b.load(std::memory_order_relaxed), S->low.load(std::memory_order_relaxed),
+          S->high.load(std::memory_order_relaxed)};
+}
+
+static void record_state(TrampState* S, SOCKET s, const char* what)
+{
+  auto* rec = S->owner ? S->owner->recorder : nullptr;
+  if (!rec) return;
+
+  char b[160];
+  const int n = std::snprintf(b, sizeof(b),
+                              "%s socket=%llu counter=%d found1c0b=%d low=%08X high=%08X", what,
+                              static_cast<unsigned long long>(s),
+                              S->counter.load(std::memory_order_relaxed),
+                              S->found1c0b.load(std::memory_order_relaxed) ? 1 : 0,
+                              S->low.load(std::memory_order_relaxed),
+                              S->high.load(std::memory_order_relaxed));
+  if (n <= 0) return;
+  const std::size_t len = (std::min)(static_cast<std::size_t>(n), sizeof(b) - 1);
+  rec->record(FlightEvent::state, std::as_bytes(std::span<const char>(b, len)));
+}
+
+static inline void record_if_changed(TrampState* S, SOCKET s, const SeedSnapshot& before,
+                                     const char* what)
+{
+  const SeedSnapshot now = seed_of(S);
+  if (now.found1c0b != before.found1c0b || now.low != before.low || now.high != before.high)
+    record_state(S, s, what);
+}
+
 // -----------------------------------------------------------------------------------------------
 // recv()
 // -----------------------------------------------------------------------------------------------
@@ -128,6 +173,7 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
     S->last_socket.store(s, std::memory_order_relaxed);
     S->reset_all_relaxed();
     dbg("[RECV] new socket detected -> reset state\n");
+    record_state(S, s, "[RECV] new socket -> reset");
   }
 
   app::ChecksumState state{S->counter, S->found1c0b, S->low, S->high};
@@ -151,6 +197,7 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
         S->reset_all_relaxed();
         S->last_socket.store(INVALID_SOCKET, std::memory_order_relaxed);
         dbg("[RECV] error -> reset state\n");
+        record_state(S, s, "[RECV] error -> reset");
       }
     }
     else if (r == 0)
@@ -158,6 +205,7 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
       S->reset_all_relaxed();
       S->last_socket.store(INVALID_SOCKET, std::memory_order_relaxed);
       dbg("[RECV] connection closed -> reset state\n");
+      record_state(S, s, "[RECV] connection closed -> reset");
     }
     return r;
   };
@@ -176,7 +224,9 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
   log_hex_buf("[RECV] raw       ", data, n);
 
   bool drop = false;
+  SeedSnapshot before = seed_of(S);
   rpipe.process(std::span<const uint8_t>(data, n), state, drop);
+  record_if_changed(S, s, before, "[RECV] state update");
 
   int drop_guard = 0;
   while (drop)
@@ -184,6 +234,7 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
     dbg("[RECV] C7 0B -> drop & read next\n");
     state.counter.store(0, std::memory_order_relaxed);
     state.found1c0b.store(false, std::memory_order_relaxed);
+    record_state(S, s, "[RECV] C7 0B -> drop");
 
     if (++drop_guard > 8) break;
 
@@ -195,7 +246,9 @@ int WSAAPI Trampolines::recv(SOCKET s, char* buf, int len, int flags)
     log_hex_buf("[RECV] after-drop", data, n);
 
     drop = false;
+    before = seed_of(S);
     rpipe.process(std::span<const uint8_t>(data, n), state, drop);
+    record_if_changed(S, s, before, "[RECV] state update");
   }
 
   return ret;
@@ -218,6 +271,7 @@ int WSAAPI Trampolines::send(SOCKET s, const char* buf, int len, int flags)
     S->last_socket.store(s, std::memory_order_relaxed);
     S->reset_all_relaxed();
     dbg("[SEND] new socket detected -> reset state\n");
+    record_state(S, s, "[SEND] new socket -> reset");
   }
 
   std::lock_guard<std::mutex> lk(S->send_mtx);
@@ -248,7 +302,9 @@ int WSAAPI Trampolines::send(SOCKET s, const char* buf, int len, int flags)
 
   log_hex_buf("[SEND] in        ", data.data(), data.size());
 
+  const SeedSnapshot before = seed_of(S);
   spipe.transform(data, state);
+  record_if_changed(S, s, before, "[SEND] state update");
 
   log_hex_buf("[SEND] out       ", data.data(), data.size());
 
@@ -278,6 +334,7 @@ int WSAAPI Trampolines::send(SOCKET s, const char* buf, int len, int flags)
       S->reset_all_relaxed();
       S->last_socket.store(INVALID_SOCKET, std::memory_order_relaxed);
       dbg("[SEND] error -> reset state\n");
+      record_state(S, s, "[SEND] error -> reset");
     }
   }
   else
@@ -0,0 +1,68 @@
+#include "infrastructure/io/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace arkan::relay::infrastructure::io
+{
+
+#ifdef _WIN32
+std::byte* map_file(const std::string& path, std::size_t size, bool create, void*& handle)
+{
+  HANDLE f = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (f == INVALID_HANDLE_VALUE) return nullptr;
+
+  // a mapping larger than the file extends it (zero-filled)
+  const auto sz = static_cast<unsigned long long>(size);
+  HANDLE m = ::CreateFileMappingA(f, nullptr, PAGE_READWRITE, static_cast<DWORD>(sz >> 32),
+                                  static_cast<DWORD>(sz & 0xFFFFFFFFull), nullptr);
+  ::CloseHandle(f);
+  if (m == nullptr) return nullptr;
+
+  void* p = ::MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, size);
+  if (p == nullptr)
+  {
+    ::CloseHandle(m);
+    return nullptr;
+  }
+  handle = m;
+  return static_cast<std::byte*>(p);
+}
+
+void unmap_file(std::byte* p, std::size_t, void* handle)
+{
+  if (p) ::UnmapViewOfFile(p);
+  if (handle) ::CloseHandle(static_cast<HANDLE>(handle));
+}
+#else
+std::byte* map_file(const std::string& path, std::size_t size, bool create, void*& handle)
+{
+  const int fd = ::open(path.c_str(), create ? (O_CREAT | O_TRUNC | O_RDWR) : O_RDWR, 0600);
+  if (fd < 0) return nullptr;
+  if (create && ::ftruncate(fd, static_cast<off_t>(size)) != 0)
+  {
+    ::close(fd);
+    return nullptr;
+  }
+
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return nullptr;
+  handle = nullptr;
+  return static_cast<std::byte*>(p);
+}
+
+void unmap_file(std::byte* p, std::size_t size, void*)
+{
+  if (p) ::munmap(p, size);
+}
+#endif
+
+}  // namespace arkan::relay::infrastructure::io
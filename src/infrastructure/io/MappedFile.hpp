@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace arkan::relay::infrastructure::io
+{
+
+// -----------------------------------------------------------------------------
+// map_file / unmap_file
+//  - Read/write shared mapping of a whole file. `create` makes (or truncates)
+//    the file and sizes it to `size` bytes, zero-filled.
+//  - Win32: CreateFile + CreateFileMapping (`handle` is the mapping HANDLE).
+//    Elsewhere: open + mmap (tests); `handle` is unused.
+// -----------------------------------------------------------------------------
+std::byte* map_file(const std::string& path, std::size_t size, bool create, void*& handle);
+void unmap_file(std::byte* p, std::size_t size, void* handle);
+
+}  // namespace arkan::relay::infrastructure::io
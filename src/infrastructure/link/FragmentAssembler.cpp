@@ -0,0 +1,69 @@
+#include "infrastructure/link/FragmentAssembler.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace env = arkan::relay::domain::protocol::envelope;
+
+FragmentAssembler::FragmentAssembler(std::size_t max_bytes) : max_bytes_(max_bytes) {}
+
+void FragmentAssembler::reset()
+{
+  if (active_) ++dropped_;
+  active_ = false;
+  done_ = false;
+  buf_.clear();
+}
+
+bool FragmentAssembler::feed(std::span<const std::byte> fragment, char& kind,
+                             std::span<const std::byte>& payload)
+{
+  if (done_)
+  {
+    buf_.clear();
+    done_ = false;
+  }
+  if (fragment.size() < env::kFragmentPrefix)
+  {
+    ++dropped_;
+    return false;
+  }
+
+  const char inner = static_cast<char>(std::to_integer<unsigned char>(fragment[0]));
+  const auto flags = std::to_integer<uint8_t>(fragment[1]);
+  const auto chunk = fragment.subspan(env::kFragmentPrefix);
+
+  if (flags & env::kFragFirst)
+  {
+    if (active_) ++dropped_;  // previous run never finished
+    buf_.clear();
+    kind_ = inner;
+    active_ = true;
+  }
+  else if (!active_ || inner != kind_)
+  {
+    ++dropped_;  // orphan: the start of its run was lost
+    active_ = false;
+    buf_.clear();
+    return false;
+  }
+
+  if (buf_.size() + chunk.size() > max_bytes_)
+  {
+    ++dropped_;
+    active_ = false;
+    buf_.clear();
+    return false;
+  }
+  buf_.insert(buf_.end(), chunk.begin(), chunk.end());
+
+  if (!(flags & env::kFragLast)) return false;
+
+  active_ = false;
+  done_ = true;
+  kind = kind_;
+  payload = buf_;
+  return true;
+}
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "domain/protocol/Envelope.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// FragmentAssembler
+//  - Rebuilds logical frames larger than 65535 bytes from a run of 'F' frames
+//    ([inner kind][flags][chunk], see domain/protocol/Envelope.hpp).
+//  - A run starts with kFragFirst and ends with kFragLast. Fragments outside a
+//    run, a new run cutting an unfinished one, or a run over `max_bytes` are
+//    discarded (counted in dropped()): shedding on the sending side may remove
+//    part of a run and the reader must resynchronize on the next one.
+//  - One instance per connection; not thread-safe.
+// -----------------------------------------------------------------------------
+class FragmentAssembler
+{
+ public:
+  explicit FragmentAssembler(
+      std::size_t max_bytes = arkan::relay::domain::protocol::envelope::kMaxLogicalFrame);
+
+  // Feeds one 'F' payload. Returns true once a logical frame is complete; `payload` stays
+  // valid until the next feed()/reset().
+  bool feed(std::span<const std::byte> fragment, char& kind, std::span<const std::byte>& payload);
+
+  // Forgets a partial run (new connection)
+  void reset();
+
+  uint64_t dropped() const
+  {
+    return dropped_;
+  }
+
+ private:
+  std::size_t max_bytes_;
+  std::vector<std::byte> buf_;
+  char kind_{0};
+  bool active_{false};
+  bool done_{false};  // buf_ holds a frame already handed out
+  uint64_t dropped_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::link
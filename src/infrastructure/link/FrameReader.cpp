@@ -0,0 +1,48 @@
+#include "infrastructure/link/FrameReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace arkan::relay::infrastructure::link
+{
+
+FrameReader::FrameReader(std::size_t capacity) : buf_((std::max)(capacity, 2 * kMaxFrame)) {}
+
+boost::asio::mutable_buffer FrameReader::prepare()
+{
+  if (begin_ == end_)
+  {
+    begin_ = end_ = 0;
+  }
+  else if (buf_.size() - end_ < kMaxFrame)
+  {
+    // move the trailing partial frame to the front (at most one frame long)
+    std::memmove(buf_.data(), buf_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  return boost::asio::buffer(buf_.data() + end_, buf_.size() - end_);
+}
+
+void FrameReader::commit(std::size_t n)
+{
+  end_ = (std::min)(end_ + n, buf_.size());
+}
+
+bool FrameReader::next(char& kind, std::span<const std::byte>& payload)
+{
+  const std::size_t avail = end_ - begin_;
+  if (avail < kHeaderSize) return false;
+
+  const std::byte* p = buf_.data() + begin_;
+  const std::size_t len =
+      std::to_integer<std::size_t>(p[1]) | (std::to_integer<std::size_t>(p[2]) << 8);
+  if (avail < kHeaderSize + len) return false;
+
+  kind = static_cast<char>(std::to_integer<unsigned char>(p[0]));
+  payload = std::span<const std::byte>(p + kHeaderSize, len);
+  begin_ += kHeaderSize + len;
+  return true;
+}
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// FrameReader
+//  - Reusable receive buffer for the [kind][len16][payload] envelope.
+//  - prepare()/commit() bracket one read_some; next() then yields every complete
+//    frame in place (no copy). A trailing partial frame is kept and completed by
+//    the following reads.
+//  - Spans returned by next() stay valid until the next prepare()/reset().
+//  - Not thread-safe: owned by the link strand.
+// -----------------------------------------------------------------------------
+class FrameReader
+{
+ public:
+  static constexpr std::size_t kHeaderSize = 3;
+  static constexpr std::size_t kMaxFrame = kHeaderSize + 0xFFFF;
+  static constexpr std::size_t kDefaultCapacity = 128 * 1024;
+
+  explicit FrameReader(std::size_t capacity = kDefaultCapacity);
+
+  // Free space for the next read (always room for at least one maximum-size frame)
+  boost::asio::mutable_buffer prepare();
+  void commit(std::size_t n);
+
+  // Next complete frame, if any
+  bool next(char& kind, std::span<const std::byte>& payload);
+
+  // Drops buffered bytes (new connection)
+  void reset()
+  {
+    begin_ = end_ = 0;
+  }
+
+  std::size_t buffered() const
+  {
+    return end_ - begin_;
+  }
+
+ private:
+  std::vector<std::byte> buf_;
+  std::size_t begin_{0};  // first unparsed byte
+  std::size_t end_{0};    // one past the last received byte
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,60 @@
+#include "infrastructure/link/FrameStaging.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace
+{
+std::size_t round_pow2(std::size_t v)
+{
+  std::size_t p = 4096;
+  while (p < v) p <<= 1;
+  return p;
+}
+}  // namespace
+
+FrameStaging::FrameStaging(std::size_t capacity)
+    : cap_(round_pow2(capacity)),
+      mask_(cap_ - 1),
+      words_(std::make_unique<uint32_t[]>(cap_ / sizeof(uint32_t)))  // zero-initialized
+{
+}
+
+std::byte* FrameStaging::reserve(std::size_t frame_len) noexcept
+{
+  const std::size_t rec = record_size(frame_len);
+  if (rec > cap_ / 2) return nullptr;
+
+  uint64_t pos = write_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    // a record never wraps: if it does not fit before the end, pad up to the end first
+    const std::size_t phys = static_cast<std::size_t>(pos) & mask_;
+    const std::size_t room = cap_ - phys;
+    const std::size_t total = (rec <= room) ? rec : room + rec;
+
+    if (pos + total - read_.load(std::memory_order_acquire) > cap_) return nullptr;
+
+    if (write_.compare_exchange_weak(pos, pos + total, std::memory_order_acq_rel,
+                                     std::memory_order_relaxed))
+    {
+      std::size_t at = phys;
+      if (total != rec)
+      {
+        state_at(phys).store(kCommitted | kPad | static_cast<uint32_t>(room),
+                             std::memory_order_release);
+        at = 0;
+      }
+      return bytes() + at + kRecordHeader;
+    }
+    // pos reloaded by the failed CAS -> retry
+  }
+}
+
+void FrameStaging::commit(std::byte* frame, std::size_t frame_len) noexcept
+{
+  const auto phys = static_cast<std::size_t>(frame - bytes()) - kRecordHeader;
+  state_at(phys).store(kCommitted | static_cast<uint32_t>(frame_len), std::memory_order_release);
+}
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// FrameStaging
+//  - Bounded, lock-free multi-producer / single-consumer byte ring.
+//  - Producers (game threads) reserve() room for one encoded frame, write it in
+//    place and commit() it; no locks, no allocation.
+//  - The consumer (link strand) drains committed frames in reservation order and
+//    stops at the first reservation that is not committed yet.
+//  - Record layout: [u32 state][u32 unused][frame bytes], 8-byte aligned.
+//    state == 0 -> reserved, kCommitted|len -> ready, kCommitted|kPad|len -> skip.
+// -----------------------------------------------------------------------------
+class FrameStaging
+{
+ public:
+  static constexpr std::size_t kDefaultCapacity = 256 * 1024;
+
+  explicit FrameStaging(std::size_t capacity = kDefaultCapacity);
+
+  // Producer: returns where to write `frame_len` bytes, or nullptr if the ring is full
+  // (or the frame is larger than half the ring). Any thread.
+  std::byte* reserve(std::size_t frame_len) noexcept;
+
+  // Producer: publishes a frame previously returned by reserve(). Any thread.
+  void commit(std::byte* frame, std::size_t frame_len) noexcept;
+
+  // Consumer: hands every committed frame to fn(std::span<const std::byte>). Strand only.
+  template <class Fn>
+  std::size_t drain(Fn&& fn)
+  {
+    std::size_t n = 0;
+    uint64_t rd = read_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      const std::size_t phys = static_cast<std::size_t>(rd) & mask_;
+      const uint32_t s = state_at(phys).load(std::memory_order_acquire);
+      if ((s & kCommitted) == 0) break;
+
+      const std::size_t len = s & kLenMask;
+      const std::size_t rec = (s & kPad) ? len : record_size(len);
+      if ((s & kPad) == 0)
+      {
+        fn(std::span<const std::byte>(bytes() + phys + kRecordHeader, len));
+        ++n;
+      }
+
+      // producers rely on unused memory reading as "not committed"
+      std::memset(bytes() + phys, 0, rec);
+      rd += rec;
+      read_.store(rd, std::memory_order_release);
+    }
+    return n;
+  }
+
+ private:
+  static constexpr uint32_t kCommitted = 0x80000000u;
+  static constexpr uint32_t kPad = 0x40000000u;
+  static constexpr uint32_t kLenMask = 0x3FFFFFFFu;
+  static constexpr std::size_t kRecordHeader = 8;
+
+  static constexpr std::size_t record_size(std::size_t frame_len)
+  {
+    return (kRecordHeader + frame_len + 7) & ~std::size_t{7};
+  }
+
+  std::atomic_ref<uint32_t> state_at(std::size_t phys) const noexcept
+  {
+    return std::atomic_ref<uint32_t>(words_[phys / sizeof(uint32_t)]);
+  }
+
+  std::byte* bytes() const noexcept
+  {
+    return reinterpret_cast<std::byte*>(words_.get());
+  }
+
+  std::size_t cap_;
+  std::size_t mask_;
+  std::unique_ptr<uint32_t[]> words_;  // word storage so record states can be atomic_ref'd
+
+  alignas(64) std::atomic<uint64_t> write_{0};  // producers: next free byte (reservation)
+  alignas(64) std::atomic<uint64_t> read_{0};   // consumer: first byte not yet drained
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// HandlerMemory
+//  - Recycles the storage Asio allocates for one chain of async operations (a
+//    read loop, the write loop, a timer), so steady-state I/O stays off the heap.
+//  - A few blocks, each kept at the largest size it has served; a chain needs
+//    one for its operation and one while a strand hands the completion over.
+//  - Blocks are claimed atomically and may be released from any thread; when
+//    all are busy the request falls back to operator new.
+// -----------------------------------------------------------------------------
+class HandlerMemory
+{
+ public:
+  HandlerMemory() = default;
+  HandlerMemory(const HandlerMemory&) = delete;
+  HandlerMemory& operator=(const HandlerMemory&) = delete;
+
+  ~HandlerMemory()
+  {
+    for (auto& b : blocks_) ::operator delete(b.data);
+  }
+
+  void* allocate(std::size_t size)
+  {
+    for (std::size_t i = 0; i < kBlocks; ++i)
+    {
+      Block& b = blocks_[i];
+      bool busy = false;
+      if (!b.busy.compare_exchange_strong(busy, true, std::memory_order_acquire)) continue;
+
+      if (b.size < size)
+      {
+        ::operator delete(b.data);
+        b.data = nullptr;
+        b.size = 0;
+        try
+        {
+          b.data = static_cast<std::byte*>(::operator new(kHeader + size));
+        }
+        catch (...)
+        {
+          b.busy.store(false, std::memory_order_release);
+          throw;
+        }
+        b.size = size;
+      }
+      *reinterpret_cast<std::size_t*>(b.data) = i;
+      return b.data + kHeader;
+    }
+
+    auto* p = static_cast<std::byte*>(::operator new(kHeader + size));
+    *reinterpret_cast<std::size_t*>(p) = kHeap;
+    return p + kHeader;
+  }
+
+  void deallocate(void* ptr) noexcept
+  {
+    auto* p = static_cast<std::byte*>(ptr) - kHeader;
+    const std::size_t i = *reinterpret_cast<const std::size_t*>(p);
+    if (i == kHeap)
+      ::operator delete(p);
+    else
+      blocks_[i].busy.store(false, std::memory_order_release);
+  }
+
+ private:
+  static constexpr std::size_t kBlocks = 3;
+  static constexpr std::size_t kHeader = alignof(std::max_align_t);  // holds the block index
+  static constexpr std::size_t kHeap = ~std::size_t{0};
+
+  struct Block
+  {
+    std::byte* data{nullptr};
+    std::size_t size{0};
+    std::atomic<bool> busy{false};
+  };
+  std::array<Block, kBlocks> blocks_{};
+};
+
+// Standard allocator over a HandlerMemory (what Asio sees as the handler's allocator)
+template <class T>
+class HandlerAllocator
+{
+ public:
+  using value_type = T;
+
+  explicit HandlerAllocator(HandlerMemory& m) noexcept : mem_(&m) {}
+  template <class U>
+  HandlerAllocator(const HandlerAllocator<U>& o) noexcept : mem_(o.mem_)
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    return static_cast<T*>(mem_->allocate(sizeof(T) * n));
+  }
+  void deallocate(T* p, std::size_t) noexcept
+  {
+    mem_->deallocate(p);
+  }
+
+  template <class U>
+  bool operator==(const HandlerAllocator<U>& o) const noexcept
+  {
+    return mem_ == o.mem_;
+  }
+  template <class U>
+  bool operator!=(const HandlerAllocator<U>& o) const noexcept
+  {
+    return mem_ != o.mem_;
+  }
+
+ private:
+  template <class>
+  friend class HandlerAllocator;
+  HandlerMemory* mem_;
+};
+
+// Completion handler whose operation storage comes from a HandlerMemory
+template <class Handler>
+class MemoryHandler
+{
+ public:
+  using allocator_type = HandlerAllocator<Handler>;
+
+  MemoryHandler(HandlerMemory& m, Handler h) : mem_(&m), h_(std::move(h)) {}
+
+  allocator_type get_allocator() const noexcept
+  {
+    return allocator_type(*mem_);
+  }
+
+  template <class... Args>
+  void operator()(Args&&... args)
+  {
+    h_(std::forward<Args>(args)...);
+  }
+
+ private:
+  HandlerMemory* mem_;
+  Handler h_;
+};
+
+template <class Handler>
+MemoryHandler<std::decay_t<Handler>> with_memory(HandlerMemory& m, Handler&& h)
+{
+  return MemoryHandler<std::decay_t<Handler>>(m, std::forward<Handler>(h));
+}
+
+}  // namespace arkan::relay::infrastructure::link
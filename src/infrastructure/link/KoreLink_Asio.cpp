@@ -1,6 +1,13 @@
 #include "infrastructure/link/KoreLink_Asio.hpp"
 
+#include "domain/protocol/Envelope.hpp"
+
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <future>
+#include <limits>
+#include <utility>
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -24,29 +31,66 @@ void KoreLink_Asio::dbg(const char* s)
 #endif
 }
 
-void KoreLink_Asio::log_connected(uint16_t port) const
+void KoreLink_Asio::log_connected(const Conn& c) const
 {
   char b[192];
-  std::snprintf(b, sizeof(b), "[KoreLink] connected to %s:%u (attempt=%u)\n", host_.c_str(),
-                (unsigned)port, attempt_);
+  std::snprintf(b, sizeof(b), "[KoreLink] conn#%u connected to %s:%u (attempt=%u)\n", c.id,
+                host_.c_str(), (unsigned)c.port, c.attempt);
   log_.sock(arkan::relay::application::ports::LogLevel::info, b);
 }
 
-void KoreLink_Asio::log_switch_port(uint16_t oldp, uint16_t newp) const
+void KoreLink_Asio::log_switch_port(const Conn& c, uint16_t oldp, uint16_t newp) const
 {
   char b[192];
-  std::snprintf(b, sizeof(b), "[KoreLink] reconnect: switching port %u -> %u\n", (unsigned)oldp,
-                (unsigned)newp);
+  std::snprintf(b, sizeof(b), "[KoreLink] conn#%u reconnect: switching port %u -> %u\n", c.id,
+                (unsigned)oldp, (unsigned)newp);
   dbg(b);
 }
 
-void KoreLink_Asio::log_reconnect_in(long long ms) const
+void KoreLink_Asio::log_rtt(const Conn& c, double sample_us) const
+{
+  log_.sockf(arkan::relay::application::ports::LogLevel::debug,
+             "[KoreLink] conn#{} rtt={}us srtt={}us rttvar={}us", c.id,
+             static_cast<uint64_t>(sample_us), static_cast<uint64_t>(srtt_us_),
+             static_cast<uint64_t>(rttvar_us_));
+}
+
+void KoreLink_Asio::log_latency() const
+{
+  char b[160];
+  std::snprintf(b, sizeof(b), "[KoreLink] emit->write p50=%lluus p99=%lluus (samples=%llu)\n",
+                (unsigned long long)emit_to_write_.percentile(50),
+                (unsigned long long)emit_to_write_.percentile(99),
+                (unsigned long long)emit_to_write_.count());
+  log_.sock(arkan::relay::application::ports::LogLevel::info, b);
+}
+
+void KoreLink_Asio::log_reconnect_in(const Conn& c, long long ms) const
 {
   char b[192];
-  std::snprintf(b, sizeof(b), "[KoreLink] reconnect in %lld ms (attempt=%u)\n", ms, attempt_ + 1);
+  std::snprintf(b, sizeof(b), "[KoreLink] conn#%u reconnect in %lld ms (attempt=%u)\n", c.id, ms,
+                c.attempt + 1);
   dbg(b);
 }
 
+void KoreLink_Asio::log_shed()
+{
+  // at most one warning per second while shedding lasts
+  const uint64_t now = now_ms();
+  if (shed_logged_at_ != 0 && now - shed_logged_at_ < 1000) return;
+  shed_logged_at_ = now;
+
+  char b[192];
+  std::snprintf(b, sizeof(b),
+                "[KoreLink] shedding frames: overflow=%llu expired=%llu unsupported=%llu "
+                "(queued=%zu bytes)\n",
+                (unsigned long long)shed_overflow_.load(std::memory_order_relaxed),
+                (unsigned long long)shed_expired_.load(std::memory_order_relaxed),
+                (unsigned long long)shed_unsupported_.load(std::memory_order_relaxed),
+                queued_bytes());
+  log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
+}
+
 // -------------------- xorshift32 (no <random>) --------------------
 uint32_t KoreLink_Asio::xorshift32_(uint32_t& s)
 {
@@ -67,21 +111,40 @@ double KoreLink_Asio::unit_01_(uint32_t& s)
 
 // -------------------- ctor/dtor --------------------
 KoreLink_Asio::KoreLink_Asio(application::ports::ILogger& log)
-    : work_(std::in_place, boost::asio::make_work_guard(io_)),
-      strand_{io_.get_executor()},
-      resolver_(strand_),
-      socket_(strand_),
-      ping_timer_(strand_),
-      reconn_timer_(strand_),
-      log_(log)
+    : KoreLink_Asio(log, std::make_unique<net::IoPool>(1))
 {
-  io_thread_ = std::thread([this] { io_.run(); });
+}
+
+KoreLink_Asio::KoreLink_Asio(application::ports::ILogger& log, net::IoPool& pool)
+    : log_(log), pool_(pool), strand_(pool.make_strand()), resolver_(strand_)
+{
+  apply_lane_map();
+  update_peer_features();
+
+  // tells Kore a restarted relay apart from a reconnecting one
+  uint32_t seed = static_cast<uint32_t>(now_us() ^ reinterpret_cast<uintptr_t>(this));
+  session_ = xorshift32_(seed);
+}
+
+KoreLink_Asio::KoreLink_Asio(application::ports::ILogger& log, std::unique_ptr<net::IoPool> own)
+    : KoreLink_Asio(log, *own)
+{
+  own_pool_ = std::move(own);
 }
 
 KoreLink_Asio::~KoreLink_Asio()
 {
   close();
-  if (io_thread_.joinable()) io_thread_.join();
+
+  // aborted handlers still run on the pool after close(): take the lifetime token away on the
+  // strand, then wait until the last handler holding a copy of it has been destroyed
+  if (pool_.context().stopped()) return;
+  std::promise<std::weak_ptr<void>> last;
+  auto token = last.get_future();
+  boost::asio::post(strand_, [this, &last] { last.set_value(std::exchange(life_, nullptr)); });
+
+  const std::weak_ptr<void> w = token.get();
+  while (!w.expired()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
 // -------------------- config setters --------------------
@@ -91,8 +154,11 @@ void KoreLink_Asio::set_reconnect_policy(const arkan::relay::application::ports:
                     [this, p]
                     {
                       policy_ = p;
-                      cur_delay_ = policy_.initial;
-                      attempt_ = 0;
+                      for (auto& c : conns_)
+                      {
+                        c->cur_delay = policy_.initial;
+                        c->attempt = 0;
+                      }
                     });
 }
 
@@ -108,26 +174,81 @@ void KoreLink_Asio::set_candidate_ports(std::vector<uint16_t> ports)
         std::sort(candidate_ports_.begin(), candidate_ports_.end());
         candidate_ports_.erase(std::unique(candidate_ports_.begin(), candidate_ports_.end()),
                                candidate_ports_.end());
-        port_idx_ = 0;
+        for (auto& c : conns_) c->port_idx = c->id;
       });
 }
 
+void KoreLink_Asio::set_options(const arkan::relay::application::ports::LinkOptions& o)
+{
+  // queue limits, lanes and batching apply right away; pool_size and the replay buffer when the
+  // pool is built (first connect)
+  boost::asio::post(strand_,
+                    [this, o]
+                    {
+                      options_ = o;
+                      update_peer_features();
+                      apply_lane_map();
+                      open_spill();
+                    });
+}
+
+void KoreLink_Asio::set_write_batch_limit(std::size_t max_frames)
+{
+  boost::asio::post(strand_, [this, max_frames] { write_batch_limit_ = max_frames; });
+}
+
+KoreLink_Asio::Stats KoreLink_Asio::stats() const
+{
+  Stats st;
+  st.frames_written = frames_written_.load(std::memory_order_relaxed);
+  st.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  st.writes = writes_.load(std::memory_order_relaxed);
+  st.batches = batches_.load(std::memory_order_relaxed);
+  st.fragmented = fragmented_.load(std::memory_order_relaxed);
+  st.failovers = failovers_.load(std::memory_order_relaxed);
+  st.resolves = resolves_.load(std::memory_order_relaxed);
+  st.hellos = hellos_.load(std::memory_order_relaxed);
+  st.hello_timeouts = hello_timeouts_.load(std::memory_order_relaxed);
+  st.srtt_us = srtt_stat_.load(std::memory_order_relaxed);
+  st.rttvar_us = rttvar_stat_.load(std::memory_order_relaxed);
+  st.rtt_samples = rtt_samples_.load(std::memory_order_relaxed);
+  st.dead_peers = dead_peers_.load(std::memory_order_relaxed);
+  st.acked = acked_.load(std::memory_order_relaxed);
+  st.replayed = replayed_.load(std::memory_order_relaxed);
+  st.replay_evicted = replay_evicted_.load(std::memory_order_relaxed);
+  st.credit_grants = credit_grants_.load(std::memory_order_relaxed);
+  st.credit_stalls = credit_stalls_.load(std::memory_order_relaxed);
+  st.emit_to_write_p50_us = emit_to_write_.percentile(50);
+  st.emit_to_write_p99_us = emit_to_write_.percentile(99);
+  st.emit_to_write_samples = emit_to_write_.count();
+  st.shed_overflow = shed_overflow_.load(std::memory_order_relaxed);
+  st.shed_expired = shed_expired_.load(std::memory_order_relaxed);
+  st.shed_unsupported = shed_unsupported_.load(std::memory_order_relaxed);
+  st.shed_bytes = shed_bytes_.load(std::memory_order_relaxed);
+  st.spilled = spilled_.load(std::memory_order_relaxed);
+  st.unspilled = unspilled_.load(std::memory_order_relaxed);
+  st.spill_queued_bytes = spill_bytes_.load(std::memory_order_relaxed);
+  return st;
+}
+
 // -------------------- public API --------------------
 void KoreLink_Asio::connect(const std::string& host, uint16_t port)
 {
   boost::asio::post(strand_,
                     [this, host, port]
                     {
+                      if (host != host_) host_addrs_.clear();
                       host_ = host;
                       single_port_ = port;
                       closing_ = false;
-                      io_.restart();
-                      if (!work_) work_.emplace(boost::asio::make_work_guard(io_));
-
-                      cur_delay_ = policy_.initial;
-                      attempt_ = 0;
 
-                      start_connect();
+                      ensure_pool();
+                      for (auto& c : conns_)
+                      {
+                        c->cur_delay = policy_.initial;
+                        c->attempt = 0;
+                        start_connect(*c);
+                      }
                     });
 }
 
@@ -137,35 +258,67 @@ void KoreLink_Asio::close()
                     [this]
                     {
                       closing_ = true;
-                      connected_ = false;
-
-                      // release claim if any
-                      port_claim_.release();
+                      if (emit_to_write_.count() != 0) log_latency();
 
-                      ping_timer_.cancel();
-                      reconn_timer_.cancel();
+                      // release claims, stop timers and close every socket
+                      for (auto& c : conns_) teardown(*c);
                       resolver_.cancel();
-
-                      boost::system::error_code ec;
-                      if (socket_.is_open()) socket_.close(ec);
-
-                      if (work_) work_->reset();
-                      io_.stop();
+                      batch_timer_.cancel();
+                      batch_open_ = false;
+                      spill_timer_.cancel();
                     });
 }
 
 // -------------------- helpers --------------------
-uint16_t KoreLink_Asio::current_port_nolock() const
+void KoreLink_Asio::ensure_pool()
 {
-  if (!candidate_ports_.empty())
+  if (!conns_.empty()) return;
+
+  // one connection per distinct port at most: two sockets to the same port gain nothing
+  std::size_t n = (std::max)(options_.pool_size, std::size_t{1});
+  n = (std::min)(n, (std::max)(candidate_ports_.size(), std::size_t{1}));
+
+  conns_.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
   {
-    return candidate_ports_[port_idx_ % candidate_ports_.size()];
+    auto c = std::make_unique<Conn>(strand_, static_cast<unsigned>(i));
+    c->port_idx = i;
+    c->cur_delay = policy_.initial;
+    c->replay.reset(options_.replay.buffer_bytes);
+    conns_.push_back(std::move(c));
+  }
+  pick_.reserve(n);
+
+  if (n > 1)
+  {
+    char b[128];
+    std::snprintf(b, sizeof(b), "[KoreLink] connection pool: %zu connections\n", n);
+    log_.sock(arkan::relay::application::ports::LogLevel::info, b);
   }
-  return single_port_;
 }
 
-// Attempt to claim an available port
-bool KoreLink_Asio::claim_port_for_connect(uint16_t& out_port)
+std::size_t KoreLink_Asio::live_connections() const
+{
+  std::size_t n = 0;
+  for (const auto& c : conns_) n += c->connected ? 1 : 0;
+  return n;
+}
+
+// True if `p` is connected or being connected to by any pool connection
+bool KoreLink_Asio::port_busy(uint16_t p) const
+{
+  return std::any_of(conns_.begin(), conns_.end(),
+                     [&](const auto& o)
+                     {
+                       return o->port == p ||
+                              std::any_of(o->racers.begin(), o->racers.end(),
+                                          [&](const auto& r) { return r->port == p; });
+                     });
+}
+
+// Attempt to claim available ports (skipping ports held by the other pool connections), one
+// per racer, starting at the connection's round-robin cursor
+std::size_t KoreLink_Asio::claim_ports_for_connect(Conn& c, std::size_t want)
 {
   std::vector<uint16_t> try_ports;
   if (!candidate_ports_.empty())
@@ -173,140 +326,281 @@ bool KoreLink_Asio::claim_port_for_connect(uint16_t& out_port)
     const size_t n = candidate_ports_.size();
     for (size_t i = 0; i < n; ++i)
     {
-      try_ports.push_back(candidate_ports_[(port_idx_ + i) % n]);
+      try_ports.push_back(candidate_ports_[(c.port_idx + i) % n]);
     }
   }
   else
   {
-    if (single_port_ == 0) return false;
+    if (single_port_ == 0) return 0;
     try_ports.push_back(single_port_);
   }
 
+  std::size_t claimed = 0;
   for (uint16_t p : try_ports)
   {
+    if (claimed == want) break;
+    if (port_busy(p)) continue;
+
+    if (c.racers.size() == claimed) c.racers.push_back(std::make_unique<Racer>(strand_));
+    Racer& r = *c.racers[claimed];
+
     // release any previous claim in this process before trying
-    port_claim_.release();
+    r.claim->release();
 
-    if (port_claim_.claim(host_, p))
+    if (r.claim->claim(host_, p))
     {
-      // succeeded: set index (if applicable) so round-robin resumes from this port
-      if (!candidate_ports_.empty())
-      {
-        auto it = std::find(candidate_ports_.begin(), candidate_ports_.end(), p);
-        if (it != candidate_ports_.end())
-          port_idx_ = static_cast<std::size_t>(std::distance(candidate_ports_.begin(), it));
-        else
-          port_idx_ = 0;
-      }
-      else
-      {
-        port_idx_ = 0;
-      }
-
-      out_port = p;
+      r.port = p;
+      ++claimed;
       char b[256];
-      std::snprintf(b, sizeof(b), "[KoreLink] port claim acquired for %s:%u (name=%s)\n",
-                    host_.c_str(), (unsigned)p, port_claim_.claimed_name().c_str());
+      std::snprintf(b, sizeof(b), "[KoreLink] conn#%u port claim acquired for %s:%u (name=%s)\n",
+                    c.id, host_.c_str(), (unsigned)p, r.claim->claimed_name().c_str());
       log_.sock(arkan::relay::application::ports::LogLevel::debug, b);
-      return true;
     }
     // failed to claim p -> try next
   }
 
-  // none claimable
-  char b[256];
-  std::snprintf(b, sizeof(b), "[KoreLink] no candidate port could be claimed for host=%s\n",
-                host_.c_str());
-  log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
-  return false;
+  if (claimed == 0)
+  {
+    // none claimable
+    char b[256];
+    std::snprintf(b, sizeof(b),
+                  "[KoreLink] conn#%u: no candidate port could be claimed for host=%s\n", c.id,
+                  host_.c_str());
+    log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
+  }
+  return claimed;
 }
 
 // -------------------- connect/read/write --------------------
-void KoreLink_Asio::start_connect()
+void KoreLink_Asio::start_connect(Conn& c)
 {
   if (closing_) return;
 
-  // pick & claim a port before attempting DNS/connection
-  uint16_t chosen_port = 0;
-  if (!claim_port_for_connect(chosen_port))
+  // pick & claim ports before attempting DNS/connection
+  c.racing = claim_ports_for_connect(c, (std::max)(options_.connect_race, std::size_t{1}));
+  if (c.racing == 0)
   {
     // nothing claimable now — schedule reconnect/backoff so we try again later
-    schedule_reconnect();
+    schedule_reconnect(c);
+    return;
+  }
+
+  // addresses are looked up once per host; numeric hosts never go through the resolver
+  if (host_addrs_.empty())
+  {
+    boost::system::error_code ec;
+    const auto addr = boost::asio::ip::make_address(host_, ec);
+    if (!ec) host_addrs_.push_back(addr);
+  }
+  if (!host_addrs_.empty())
+  {
+    launch_racers(c);
     return;
   }
 
-  // chosen_port now holds the port we will resolve/connect to
+  resolves_.fetch_add(1, std::memory_order_relaxed);
   resolver_.async_resolve(
-      host_, std::to_string(chosen_port),
-      [this, port = chosen_port](const boost::system::error_code& ec,
-                                 tcp::resolver::results_type results)
+      host_, std::string(),
+      [this, &c, gen = c.gen, life = life_](const boost::system::error_code& ec,
+                                            tcp::resolver::results_type results)
       {
-        if (ec)
+        if (gen != c.gen) return;  // closed meanwhile
+        if (ec || results.empty())
         {
-          // release claim so others can use it if resolve fails
-          port_claim_.release();
-          schedule_reconnect();
+          schedule_reconnect(c);
           return;
         }
 
-        boost::asio::async_connect(
-            socket_, results,
-            [this, port](const boost::system::error_code& ec2, const tcp::endpoint&)
-            {
-              if (ec2)
-              {
-                // connection failed -> release claim and reconnect
-                port_claim_.release();
-                schedule_reconnect();
-                return;
-              }
-
-              connected_ = true;
-              log_connected(port);
-
-              // reset attempts/backoff on success
-              attempt_ = 0;
-              cur_delay_ = policy_.initial;
-
-              do_read_header();
-              schedule_ping();
-              flush_sendq();
-            });
+        if (host_addrs_.empty())
+        {
+          for (const auto& e : results)
+          {
+            const auto a = e.endpoint().address();
+            if (std::find(host_addrs_.begin(), host_addrs_.end(), a) == host_addrs_.end())
+              host_addrs_.push_back(a);
+          }
+        }
+        launch_racers(c);
       });
 }
 
-void KoreLink_Asio::schedule_reconnect()
+// Starts one connect per claimed port; on_race_result() keeps the first to complete
+void KoreLink_Asio::launch_racers(Conn& c)
 {
-  connected_ = false;
-  if (closing_) return;
+  for (std::size_t i = 0; i < c.racing; ++i)
+  {
+    Racer& r = *c.racers[i];
+    std::vector<tcp::endpoint> eps;
+    eps.reserve(host_addrs_.size());
+    for (const auto& a : host_addrs_) eps.emplace_back(a, r.port);
+
+    boost::asio::async_connect(
+        r.socket, eps,
+        [this, &c, &r, gen = c.gen, life = life_](const boost::system::error_code& ec,
+                                                  const tcp::endpoint&)
+        {
+          if (gen != c.gen) return;  // closed meanwhile
+          on_race_result(c, r, ec);
+        });
+  }
+
+  // attempts still pending once the deadline passes are closed (and fail with operation_aborted)
+  const auto deadline = connect_timeout();
+  if (deadline.count() == 0) return;
+  c.reconn_timer.expires_after(deadline);
+  c.reconn_timer.async_wait(
+      [this, &c, gen = c.gen, life = life_](const boost::system::error_code& e)
+      {
+        if (e || gen != c.gen || c.connected) return;
+        for (auto& r : c.racers)
+        {
+          boost::system::error_code ignore;
+          if (r->port != 0) r->socket.close(ignore);
+        }
+      });
+}
+
+void KoreLink_Asio::on_race_result(Conn& c, Racer& r, const boost::system::error_code& ec)
+{
+  --c.racing;
+
+  if (ec || c.connected)
+  {
+    // failed, or lost the race: give the port back
+    boost::system::error_code ignore;
+    r.socket.close(ignore);
+    r.claim->release();
+    r.port = 0;
+
+    // a refused connect means the address is fine and nobody listens yet; anything else
+    // (unreachable, timeout, ...) gets the host looked up again on the next attempt
+    if (!c.connected && ec != boost::asio::error::connection_refused) host_addrs_.clear();
+
+    // connection failed everywhere -> release claims and reconnect
+    if (!c.connected && c.racing == 0) schedule_reconnect(c);
+    return;
+  }
+
+  // winner: the connection takes over its socket and claim, the other attempts are dropped
+  c.reconn_timer.cancel();
+  // swapped, not moved: a moved-from socket loses its strand and the racer reuses it next time
+  std::swap(c.socket, r.socket);
+  std::swap(c.port_claim, r.claim);
+  c.port = r.port;
+  r.port = 0;
+  for (auto& o : c.racers)
+  {
+    boost::system::error_code ignore;
+    if (o->port != 0) o->socket.close(ignore);
+  }
 
-  // release claim so others can use the port while we backoff
-  port_claim_.release();
+  // round-robin resumes from this port
+  auto it = std::find(candidate_ports_.begin(), candidate_ports_.end(), c.port);
+  c.port_idx = it != candidate_ports_.end()
+                   ? static_cast<std::size_t>(std::distance(candidate_ports_.begin(), it))
+                   : 0;
+
+  c.connected = true;
+  log_connected(c);
+
+  // reset attempts/backoff on success
+  c.attempt = 0;
+  c.cur_delay = policy_.initial;
+
+  c.reader.reset();
+  c.frags.reset();
+  c.credit_bytes_on = c.credit_frames_on = false;
+  c.credit_bytes = c.credit_frames = 0;
+  do_read(c);
+
+  c.last_rx = c.last_tx = std::chrono::steady_clock::now();
+  c.probe_seq = 0;
+  c.echoes = false;
+  c.ping_every = options_.keepalive.interval;
+  if (options_.handshake.enabled)
+  {
+    send_hello(c);
+    schedule_ping(c);
+  }
+  else
+  {
+    c.features = arkan::relay::domain::protocol::envelope::kFeatAll;
+    update_peer_features();
+    start_session(c);
+  }
+  schedule_spill();
+}
+
+void KoreLink_Asio::teardown(Conn& c)
+{
+  // invalidates pending read/connect handlers of this connection; an in-flight write still
+  // completes (aborted) and releases its send-queue region
+  c.connected = false;
+  ++c.gen;
+  c.port = 0;
+  c.ctl.clear();
+  c.replay_due = false;
+  c.hello_pending = false;
+  c.features = 0;
+  c.max_frame = 0;
+  update_peer_features();
+
+  // release claims so others can use the ports
+  c.port_claim->release();
+  for (auto& r : c.racers)
+  {
+    boost::system::error_code ec;
+    if (r->socket.is_open()) r->socket.close(ec);
+    r->claim->release();
+    r->port = 0;
+  }
+  c.racing = 0;
+
+  c.ping_timer.cancel();
+  c.reconn_timer.cancel();
 
-  // close socket
   boost::system::error_code ec;
-  if (socket_.is_open()) socket_.close(ec);
+  if (c.socket.is_open()) c.socket.close(ec);
+}
+
+void KoreLink_Asio::schedule_reconnect(Conn& c)
+{
+  const bool was_connected = c.connected;
+  const uint16_t oldp = c.port;
+  teardown(c);
+  if (closing_) return;
+
+  if (was_connected && live_connections() > 0)
+  {
+    // the rest of the pool keeps draining the send lanes while this one backs off
+    failovers_.fetch_add(1, std::memory_order_relaxed);
+    char b[192];
+    std::snprintf(b, sizeof(b), "[KoreLink] conn#%u lost (port %u); %zu connection(s) still up\n",
+                  c.id, (unsigned)oldp, live_connections());
+    log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
+  }
+  if (live_connections() > 0) hand_over_unacked(c);
 
   // round-robin - advance to the next candidate port (if any), and log it
   if (!candidate_ports_.empty())
   {
-    const uint16_t oldp = candidate_ports_[port_idx_ % candidate_ports_.size()];
-    port_idx_ = (port_idx_ + 1) % candidate_ports_.size();
-    const uint16_t newp = candidate_ports_[port_idx_];
-    if (newp != oldp) log_switch_port(oldp, newp);
+    const uint16_t from = candidate_ports_[c.port_idx % candidate_ports_.size()];
+    c.port_idx = (c.port_idx + 1) % candidate_ports_.size();
+    const uint16_t to = candidate_ports_[c.port_idx];
+    if (to != from) log_switch_port(c, from, to);
   }
 
   // backoff exponencial + jitter
-  auto next = cur_delay_;
-  if (attempt_ == 0)
+  auto next = c.cur_delay;
+  if (c.attempt == 0)
   {
     next = policy_.initial;
   }
   else
   {
     const long long scaled_ll =
-        static_cast<long long>(std::llround(cur_delay_.count() * policy_.backoff));
-    const long long clamped = std::min(scaled_ll, policy_.max.count());
+        static_cast<long long>(std::llround(c.cur_delay.count() * policy_.backoff));
+    const long long clamped = std::min<long long>(scaled_ll, policy_.max.count());
     next = std::chrono::milliseconds(clamped);
   }
 
@@ -323,191 +617,1205 @@ void KoreLink_Asio::schedule_reconnect()
     next = std::chrono::milliseconds(jittered);
   }
 
-  cur_delay_ = next;
-  log_reconnect_in(static_cast<long long>(cur_delay_.count()));
-  ++attempt_;
+  c.cur_delay = next;
+  log_reconnect_in(c, static_cast<long long>(c.cur_delay.count()));
+  ++c.attempt;
 
-  reconn_timer_.expires_after(cur_delay_);
-  reconn_timer_.async_wait(
-      [this](const boost::system::error_code& e)
+  c.reconn_timer.expires_after(c.cur_delay);
+  c.reconn_timer.async_wait(
+      [this, &c, life = life_](const boost::system::error_code& e)
       {
-        if (!e && !closing_) start_connect();
+        if (!e && !closing_) start_connect(c);
       });
 }
 
-void KoreLink_Asio::schedule_ping()
+// -------------------- handshake --------------------
+// Announces what this relay may use; until Kore answers only control frames go out on the
+// connection, so nothing is written in a form Kore might not read
+void KoreLink_Asio::send_hello(Conn& c)
 {
-  if (closing_ || !connected_) return;
+  namespace env = arkan::relay::domain::protocol::envelope;
+  c.features = 0;
+  c.hello_pending = true;
+  c.hello_at = std::chrono::steady_clock::now();
+
+  const uint32_t feats = own_features();
+  const auto max_frame = static_cast<uint32_t>(env::kMaxLogicalFrame);
+  const auto h = make_header(env::kHello, env::kHelloSize);
+  c.ctl.insert(c.ctl.end(), h.begin(), h.end());
+  const uint16_t version = env::kHelloVersion;
+  for (int i = 0; i < 2; ++i) c.ctl.push_back(static_cast<std::byte>(version >> (8 * i)));
+  for (int i = 0; i < 4; ++i) c.ctl.push_back(static_cast<std::byte>(feats >> (8 * i)));
+  for (int i = 0; i < 4; ++i) c.ctl.push_back(static_cast<std::byte>(max_frame >> (8 * i)));
+
+  flush_sendq();
+}
 
-  ping_timer_.expires_after(std::chrono::milliseconds(5000));
-  ping_timer_.async_wait(
-      [this](const boost::system::error_code& ec)
-      {
-        if (ec || closing_ || !connected_) return;
+void KoreLink_Asio::on_hello(Conn& c, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (payload.size() < env::kHelloSize) return;
+
+  uint16_t version = 0;
+  uint32_t feats = 0, max_frame = 0;
+  for (int i = 0; i < 2; ++i) version |= std::to_integer<uint16_t>(payload[i]) << (8 * i);
+  for (int i = 0; i < 4; ++i) feats |= std::to_integer<uint32_t>(payload[2 + i]) << (8 * i);
+  for (int i = 0; i < 4; ++i) max_frame |= std::to_integer<uint32_t>(payload[6 + i]) << (8 * i);
+
+  // an answer after the timeout is too late: the connection already speaks the original envelope
+  if (version == 0 || !c.hello_pending) return;
+
+  c.hello_pending = false;
+  c.features = own_features() & feats;
+  c.max_frame = max_frame;
+  update_peer_features();
+  hellos_.fetch_add(1, std::memory_order_relaxed);
+
+  char b[160];
+  std::snprintf(b, sizeof(b),
+                "[KoreLink] conn#%u: Kore speaks v%u, features 0x%08x (agreed 0x%08x), "
+                "max frame %u\n",
+                c.id, version, feats, c.features, max_frame);
+  log_.sock(arkan::relay::application::ports::LogLevel::info, b);
 
-        const auto hdr = make_header('K', 0);
-        std::vector<std::byte> buf;
-        buf.reserve(3);
-        buf.insert(buf.end(), hdr.begin(), hdr.end());
-        send_q_.push_back(std::move(buf));
+  start_session(c);
+}
 
-        flush_sendq();
-        schedule_ping();
-      });
+// Everything that waited for the handshake: numbering/replay, keepalive probes, queued frames
+void KoreLink_Asio::start_session(Conn& c)
+{
+  start_sequence(c);
+  // whatever connections still down were keeping for their own reconnect goes out here
+  for (auto& o : conns_)
+    if (o.get() != &c && !o->connected) hand_over_unacked(*o);
+  // first probe right away: the RTT estimate also sizes connect timeouts
+  send_probe(c);
+  schedule_ping(c);
 }
 
-void KoreLink_Asio::send_frame(char kind, std::span<const std::byte> payload)
+// Features the link itself can speak; whether batching and sequencing are actually used is
+// still up to their options
+uint32_t KoreLink_Asio::own_features() const
 {
-  std::vector<std::byte> buf;
+  namespace env = arkan::relay::domain::protocol::envelope;
+  return env::kFeatBatch | env::kFeatSequence | env::kFeatFragments | env::kFeatTimestamps |
+         env::kFeatCredit | options_.handshake.features;
+}
 
-  if (payload.size() > std::numeric_limits<uint16_t>::max())
+// What frames built now may rely on: the features every connection past its handshake agreed
+// to, and the smallest frame limit among them. Nothing is agreed while no connection is up.
+void KoreLink_Asio::update_peer_features()
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  uint32_t feats = env::kFeatAll;
+  uint32_t max_frame = 0;
+  bool any = false;
+  for (const auto& c : conns_)
   {
-    log_.sock(arkan::relay::application::ports::LogLevel::err,
-              "[KoreLink] send_frame: payload too large, rejecting (max 65535)");
+    if (!c->connected || c->hello_pending) continue;
+    any = true;
+    feats &= c->features;
+    if (c->max_frame != 0 && (max_frame == 0 || c->max_frame < max_frame))
+      max_frame = c->max_frame;
+  }
+  if (!any && options_.handshake.enabled) feats = 0;
+  peer_features_.store(feats, std::memory_order_relaxed);
+  peer_max_frame_.store(max_frame, std::memory_order_relaxed);
+}
+
+// -------------------- keepalive / RTT --------------------
+// Wakes when the probe in flight times out, the next probe is due, or the peer would have been
+// silent for dead_after, whichever comes first
+void KoreLink_Asio::schedule_ping(Conn& c)
+{
+  if (closing_ || !c.connected) return;
+
+  const auto& ka = options_.keepalive;
+  auto due = c.probe_at + (c.probe_seq != 0 ? probe_timeout() : c.ping_every);
+  if (c.echoes && ka.dead_after.count() > 0) due = (std::min)(due, c.last_rx + ka.dead_after);
+  if (c.hello_pending) due = c.hello_at + options_.handshake.timeout;
+
+  c.ping_timer.expires_at(due);
+  auto on_timer = [this, &c, gen = c.gen, life = life_](const boost::system::error_code& ec)
+  {
+    if (ec || closing_ || gen != c.gen) return;
+    on_ping(c);
+  };
+  c.ping_timer.async_wait(with_memory(c.ping_mem, std::move(on_timer)));
+}
+
+void KoreLink_Asio::on_ping(Conn& c)
+{
+  const auto& ka = options_.keepalive;
+  const auto now = std::chrono::steady_clock::now();
+
+  if (c.hello_pending)
+  {
+    // a Kore that predates 'H': go on with the features every Kore understands
+    hello_timeouts_.fetch_add(1, std::memory_order_relaxed);
+    char b[160];
+    std::snprintf(b, sizeof(b),
+                  "[KoreLink] conn#%u: no 'H' answer within %lld ms, using the original envelope\n",
+                  c.id, static_cast<long long>(options_.handshake.timeout.count()));
+    log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
+
+    c.hello_pending = false;
+    c.features = 0;
+    c.max_frame = 0;
+    update_peer_features();
+    start_session(c);
+    return;
+  }
+
+  if (c.echoes && ka.dead_after.count() > 0 && now - c.last_rx >= ka.dead_after)
+  {
+    dead_peers_.fetch_add(1, std::memory_order_relaxed);
+    char b[160];
+    std::snprintf(b, sizeof(b), "[KoreLink] conn#%u: peer silent for %lld ms, reconnecting\n",
+                  c.id, static_cast<long long>(ka.dead_after.count()));
+    log_.sock(arkan::relay::application::ports::LogLevel::warn, b);
+    schedule_reconnect(c);
+    return;
+  }
+
+  if (c.probe_seq != 0 && now - c.probe_at >= probe_timeout())
+  {
+    // unanswered: probe again, sooner each time, until an echo comes back or the peer is dead
+    c.ping_every = (std::max)(ka.min_interval, c.ping_every / 2);
+    send_probe(c);
+  }
+  else if (c.probe_seq == 0 && now - c.probe_at >= c.ping_every)
+  {
+    // traffic both ways already proves both ends alive: only refresh the RTT now and then
+    const bool busy = now - c.last_rx < ka.interval && now - c.last_tx < ka.interval;
+    if (!busy || now - c.probe_at >= 4 * ka.interval) send_probe(c);
+  }
+  schedule_ping(c);
+}
+
+// Probes belong to their connection: they must not be picked up by another one. A Kore that
+// did not agree to timestamps gets plain keepalives (no RTT, no silence detection).
+void KoreLink_Asio::send_probe(Conn& c)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  c.probe_at = std::chrono::steady_clock::now();
+  if (!(c.features & env::kFeatTimestamps))
+  {
+    const auto h = make_header(env::kKeepalive, 0);
+    c.ctl.insert(c.ctl.end(), h.begin(), h.end());
+    flush_sendq();
     return;
   }
 
-  const auto h = make_header(kind, payload.size());
+  if (++probe_seq_ == 0) ++probe_seq_;
+  c.probe_seq = probe_seq_;
+
+  const auto us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(c.probe_at.time_since_epoch())
+          .count());
+  const auto h = make_header(env::kKeepalive, env::kKeepaliveProbe);
+  c.ctl.insert(c.ctl.end(), h.begin(), h.end());
+  for (int i = 0; i < 4; ++i) c.ctl.push_back(static_cast<std::byte>(c.probe_seq >> (8 * i)));
+  for (int i = 0; i < 8; ++i) c.ctl.push_back(static_cast<std::byte>(us >> (8 * i)));
+
+  flush_sendq();
+}
+
+// An echoed probe: one RTT sample (RFC 6298 smoothing, shared by the whole pool).
+// Returns false for a plain keepalive.
+bool KoreLink_Asio::on_keepalive(Conn& c, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (payload.size() != env::kKeepaliveProbe) return false;
+
+  uint32_t seq = 0;
+  uint64_t sent_us = 0;
+  for (int i = 0; i < 4; ++i) seq |= std::to_integer<uint32_t>(payload[i]) << (8 * i);
+  for (int i = 0; i < 8; ++i) sent_us |= std::to_integer<uint64_t>(payload[4 + i]) << (8 * i);
+  if (seq == 0 || seq != c.probe_seq) return true;  // late echo of a probe given up on
+
+  const double sample = static_cast<double>(now_us() - sent_us);
+
+  if (rtt_samples_.load(std::memory_order_relaxed) == 0)
+  {
+    srtt_us_ = sample;
+    rttvar_us_ = sample / 2.0;
+  }
+  else
+  {
+    rttvar_us_ += (std::abs(srtt_us_ - sample) - rttvar_us_) / 4.0;
+    srtt_us_ += (sample - srtt_us_) / 8.0;
+  }
+  srtt_stat_.store(static_cast<uint64_t>(srtt_us_), std::memory_order_relaxed);
+  rttvar_stat_.store(static_cast<uint64_t>(rttvar_us_), std::memory_order_relaxed);
+  rtt_samples_.fetch_add(1, std::memory_order_relaxed);
+
+  c.probe_seq = 0;
+  c.echoes = true;
+  c.ping_every = options_.keepalive.interval;
+  log_rtt(c, sample);
+
+  schedule_ping(c);
+  return true;
+}
+
+// -------------------- sequencing / replay --------------------
+// Opens the connection's numbered stream with a 'Q' frame; the frames Kore has not acknowledged
+// yet (written by an earlier connection) are written again right after it
+void KoreLink_Asio::start_sequence(Conn& c)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (!c.replay.enabled() || !(c.features & env::kFeatSequence)) return;
+
+  const uint32_t next = c.replay.first_seq();
+  const auto h = make_header(env::kSequence, env::kSequenceSize);
+  c.ctl.insert(c.ctl.end(), h.begin(), h.end());
+  for (int i = 0; i < 4; ++i) c.ctl.push_back(static_cast<std::byte>(session_ >> (8 * i)));
+  for (int i = 0; i < 2; ++i) c.ctl.push_back(static_cast<std::byte>(c.id >> (8 * i)));
+  for (int i = 0; i < 4; ++i) c.ctl.push_back(static_cast<std::byte>(next >> (8 * i)));
+  c.replay_due = true;
+
+  if (c.replay.empty()) return;
+  char b[192];
+  std::snprintf(b, sizeof(b),
+                "[KoreLink] conn#%u resuming at seq %u: replaying %zu frame(s), %zu bytes "
+                "(evicted unacked so far: %llu)\n",
+                c.id, next, c.replay.frames(), c.replay.bytes(),
+                (unsigned long long)c.replay.evicted());
+  log_.sock(arkan::relay::application::ports::LogLevel::info, b);
+}
+
+void KoreLink_Asio::on_ack(Conn& c, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  // acks are link business even with replay off: nothing is kept, so there is nothing to drop
+  if (payload.size() != env::kAckSize || !c.replay.enabled()) return;
+
+  uint32_t seq = 0;
+  for (int i = 0; i < 4; ++i) seq |= std::to_integer<uint32_t>(payload[i]) << (8 * i);
+  acked_.fetch_add(c.replay.ack(seq), std::memory_order_relaxed);
+}
+
+// A connection that is down while another one is up gives its unacknowledged frames to the
+// pool instead of keeping them for its own reconnect: they go back to the front of the lanes
+// they were queued on and are numbered again by whichever connection writes them. Kore skips
+// repeats within one stream only, so a frame it processed but had not acked yet comes twice.
+void KoreLink_Asio::hand_over_unacked(Conn& c)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (c.replay.empty()) return;
+
+  std::vector<std::byte> kept(c.replay.bytes());
+  std::size_t off = 0;
+  for (const auto& b : c.replay.buffers())
+  {
+    if (b.size() != 0) std::memcpy(kept.data() + off, b.data(), b.size());
+    off += b.size();
+  }
+  const uint32_t first = c.replay.first_seq();
+  c.replay.clear();
+
+  // each frame on its lane; a fragment run whose start was evicted cannot be rebuilt
+  std::array<std::vector<std::byte>, kLanes> moved;
+  std::size_t frames = 0, orphans = 0, lane = 0;
+  bool in_run = false;
+  for (std::size_t at = 0; at + SendRing::kHeaderSize <= kept.size();)
+  {
+    const std::size_t plen = std::to_integer<std::size_t>(kept[at + 1]) |
+                             (std::to_integer<std::size_t>(kept[at + 2]) << 8);
+    const auto frame = std::span<const std::byte>(kept).subspan(at, SendRing::kHeaderSize + plen);
+    at += frame.size();
+
+    const char kind = static_cast<char>(std::to_integer<unsigned char>(frame[0]));
+    const bool fragment = kind == env::kFragment && plen >= env::kFragmentPrefix;
+    const uint8_t flags = fragment ? std::to_integer<uint8_t>(frame[4]) : 0;
+    if (fragment && !(flags & env::kFragFirst) && !in_run)
+    {
+      ++orphans;
+      continue;
+    }
+    if (!fragment || (flags & env::kFragFirst))
+    {
+      const char pkind = fragment ? static_cast<char>(std::to_integer<unsigned char>(frame[3]))
+                                  : kind;
+      const std::size_t op_at = SendRing::kHeaderSize + (fragment ? env::kFragmentPrefix : 0);
+      const bool has_opcode =
+          (pkind == env::kRecv || pkind == env::kCompressed) && frame.size() >= op_at + 2;
+      lane = lane_for(pkind, has_opcode, has_opcode ? opcode_at(frame.subspan(op_at)) : 0);
+    }
+    in_run = fragment && !(flags & env::kFragLast);
+    moved[lane].insert(moved[lane].end(), frame.begin(), frame.end());
+    ++frames;
+  }
+
+  const uint64_t now = now_ms();
+  for (std::size_t i = 0; i < kLanes; ++i)
+    if (!moved[i].empty()) lanes_[i].push_front(moved[i], now);
+  replay_evicted_.fetch_add(orphans, std::memory_order_relaxed);
+
+  char b[192];
+  std::snprintf(b, sizeof(b),
+                "[KoreLink] conn#%u down: %zu unacked frame(s) from seq %u handed to the pool\n",
+                c.id, frames, first);
+  log_.sock(arkan::relay::application::ports::LogLevel::info, b);
+}
+
+// -------------------- flow control --------------------
+// Kore grants credit per connection; writes resume as soon as it arrives
+void KoreLink_Asio::on_credit(Conn& c, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (payload.size() != env::kCreditSize) return;
+
+  uint32_t bytes = 0, frames = 0;
+  for (int i = 0; i < 4; ++i) bytes |= std::to_integer<uint32_t>(payload[i]) << (8 * i);
+  for (int i = 0; i < 4; ++i) frames |= std::to_integer<uint32_t>(payload[4 + i]) << (8 * i);
+  if (bytes != 0)
+  {
+    c.credit_bytes_on = true;
+    c.credit_bytes += bytes;
+  }
+  if (frames != 0)
+  {
+    c.credit_frames_on = true;
+    c.credit_frames += frames;
+  }
+  credit_grants_.fetch_add(1, std::memory_order_relaxed);
+  flush_sendq();
+}
+
+// How long a probe may go unanswered: RTO = SRTT + 4 * RTTVAR, within [min_interval, interval]
+std::chrono::milliseconds KoreLink_Asio::probe_timeout() const
+{
+  const auto& ka = options_.keepalive;
+  if (rtt_samples_.load(std::memory_order_relaxed) == 0) return ka.interval;
+
+  const auto rto = std::chrono::milliseconds(
+      static_cast<long long>((srtt_us_ + 4.0 * rttvar_us_) / 1000.0) + 1);
+  return std::clamp(rto, ka.min_interval, (std::max)(ka.interval, ka.min_interval));
+}
+
+// A connect attempt still pending after several RTTs is abandoned (a SYN to a closed port can
+// otherwise take seconds to fail); 0 = no measurement yet, wait for the OS
+std::chrono::milliseconds KoreLink_Asio::connect_timeout() const
+{
+  if (rtt_samples_.load(std::memory_order_relaxed) == 0) return std::chrono::milliseconds(0);
+
+  const auto t = std::chrono::milliseconds(
+      static_cast<long long>(8.0 * (srtt_us_ + 4.0 * rttvar_us_) / 1000.0));
+  return std::clamp(t, kMinConnectTimeout, kMaxConnectTimeout);
+}
+
+void KoreLink_Asio::send_frame(char kind, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+
+  // over 65535 bytes takes an 'F' run, queued whatever the connections up right now agreed to:
+  // only one whose Kore reads fragments takes it (see admit_front). A connected Kore that stated
+  // a smaller limit caps every frame.
+  const std::size_t peer_max = peer_max_frame_.load(std::memory_order_relaxed);
+  std::size_t max = env::kMaxLogicalFrame;
+  if (peer_max != 0) max = (std::min)(max, peer_max);
+  if (payload.size() > max)
+  {
+    char e[128];
+    std::snprintf(e, sizeof(e), "[KoreLink] send_frame: payload of %zu bytes too large, "
+                  "rejecting (max %zu)", payload.size(), max);
+    log_.sock(arkan::relay::application::ports::LogLevel::err, e);
+    return;
+  }
 
-  log_.sock(arkan::relay::application::ports::LogLevel::info,
-            std::string("[KoreLink] enqueue kind=") + std::string(1, kind) +
-                " len=" + std::to_string(payload.size()));
+  log_.sockf(arkan::relay::application::ports::LogLevel::info,
+             "[KoreLink] enqueue kind={} len={}", kind, payload.size());
 
   if (kind == 'S')
   {
-    log_.sock(
-        arkan::relay::application::ports::LogLevel::warn,
-        std::string("[KoreLink] dropping 'S' frame (forwarding SEND to Kore is disabled). len=") +
-            std::to_string(payload.size()));
+    log_.sockf(arkan::relay::application::ports::LogLevel::warn,
+               "[KoreLink] dropping 'S' frame (forwarding SEND to Kore is disabled). len={}",
+               payload.size());
     return;
   }
 
-  buf.reserve(3 + payload.size());
-  buf.insert(buf.end(), h.begin(), h.end());
-  buf.insert(buf.end(), payload.begin(), payload.end());
+  // same path as reserve()/commit() so frames from both producer APIs keep their order
+  const bool jumbo = payload.size() > env::kMaxPayload;
+  if (auto r = jumbo ? arkan::relay::application::ports::FrameReservation{}
+                     : reserve(kind, payload.size()))
+  {
+    if (!payload.empty()) std::memcpy(r.payload.data(), payload.data(), payload.size());
+    commit(r);
+    return;
+  }
 
+  // staging full (or a jumbo frame): fall back to an owned copy, after whatever was already
+  // staged. reserve() stays closed until the copy is queued so later frames cannot overtake it.
+  fallback_pending_.fetch_add(1, std::memory_order_acq_rel);
   boost::asio::post(strand_,
-                    [this, msg = std::move(buf)]() mutable
+                    [this, kind, body = std::vector<std::byte>(payload.begin(), payload.end())]
                     {
-                      send_q_.push_back(std::move(msg));
+                      drain_staging();
+                      if (body.size() > env::kMaxPayload)
+                        enqueue_fragments(kind, body);
+                      else
+                        enqueue(make_header(kind, body.size()), body);
+                      fallback_pending_.fetch_sub(1, std::memory_order_acq_rel);
                       flush_sendq();
                     });
 }
 
-void KoreLink_Asio::flush_sendq()
+// Splits a payload over 65535 bytes into a run of 'F' frames ([kind][flags][chunk] each).
+// The whole run sits on one lane (the lane of the original frame) and is gathered whole.
+void KoreLink_Asio::enqueue_fragments(char kind, std::span<const std::byte> payload)
 {
-  if (closing_ || !connected_ || sending_ || send_q_.empty()) return;
+  namespace env = arkan::relay::domain::protocol::envelope;
+  env::for_each_fragment(kind, payload, [this](auto head, auto chunk) { enqueue(head, chunk); });
+  fragmented_.fetch_add(1, std::memory_order_relaxed);
+}
 
-  sending_ = true;
-  auto msg = std::move(send_q_.front());
-  send_q_.pop_front();
+arkan::relay::application::ports::FrameReservation KoreLink_Asio::reserve(char kind,
+                                                                         std::size_t len)
+{
+  // 'S' is never forwarded and oversized payloads are rejected: send_frame() reports both
+  if (kind == 'S' || len > std::numeric_limits<uint16_t>::max() || closing_) return {};
+  if (fallback_pending_.load(std::memory_order_acquire) != 0) return {};
+  const std::size_t peer_max = peer_max_frame_.load(std::memory_order_relaxed);
+  if (peer_max != 0 && len > peer_max) return {};
+
+  std::byte* frame = staging_.reserve(3 + len);
+  if (!frame) return {};
+
+  const auto h = make_header(kind, len);
+  std::memcpy(frame, h.data(), h.size());
+
+  arkan::relay::application::ports::FrameReservation r;
+  r.payload = std::span<std::byte>(frame + h.size(), len);
+  r.handle = frame;
+  return r;
+}
 
-  log_.sock(arkan::relay::application::ports::LogLevel::debug,
-            "[KoreLink] flush_sendq -> writing len=" + std::to_string(msg.size()));
+void KoreLink_Asio::commit(arkan::relay::application::ports::FrameReservation& r)
+{
+  if (!r) return;
+  staging_.commit(static_cast<std::byte*>(r.handle), 3 + r.payload.size());
+  r = {};
 
-  auto owned = std::make_shared<std::vector<std::byte>>(std::move(msg));
+  // wake the I/O thread at most once per batch: only the producer that raises the flag posts
+  if (!wake_pending_.exchange(true, std::memory_order_acq_rel))
+  {
+    emit_us_.store(now_us(), std::memory_order_relaxed);
+    boost::asio::post(strand_, with_memory(wake_mem_, [this] { drain_staging(); }));
+  }
+}
 
-  boost::asio::async_write(
-      socket_, boost::asio::buffer(*owned),
-      [this, owned](const boost::system::error_code& ec, std::size_t bytes_transferred) mutable
+void KoreLink_Asio::drain_staging()
+{
+  // take the waking producer's stamp first: a producer raising the flag again after it is
+  // lowered stamps the next pass
+  const uint64_t emitted = emit_us_.exchange(0, std::memory_order_relaxed);
+  if (emit_pending_us_ == 0) emit_pending_us_ = emitted;
+
+  // lower the flag before draining so a commit racing with us schedules another pass
+  wake_pending_.exchange(false, std::memory_order_acq_rel);
+  staging_.drain([this](std::span<const std::byte> frame) { enqueue(frame, {}); });
+  flush_sendq();
+}
+
+// -------------------- send lanes --------------------
+bool KoreLink_Asio::lanes_empty() const
+{
+  for (const auto& l : lanes_)
+    if (!l.empty()) return false;
+  return true;
+}
+
+std::size_t KoreLink_Asio::queued_bytes() const
+{
+  std::size_t n = 0;
+  for (const auto& l : lanes_) n += l.queued_bytes();
+  return n;
+}
+
+std::size_t KoreLink_Asio::queued_frames() const
+{
+  std::size_t n = 0;
+  for (const auto& l : lanes_) n += l.queued_frames();
+  return n;
+}
+
+// Game traffic ('R', or 'Z' with the opcode kept in the clear) goes by opcode; anything else
+// is link protocol
+std::size_t KoreLink_Asio::lane_for(char kind, bool has_opcode, uint16_t opcode) const
+{
+  using arkan::relay::application::ports::Lane;
+  if (kind != 'R' && kind != 'Z') return static_cast<std::size_t>(Lane::control);
+  return has_opcode ? lane_of_[opcode] : static_cast<std::size_t>(options_.lanes.fallback);
+}
+
+uint16_t KoreLink_Asio::opcode_at(std::span<const std::byte> payload)
+{
+  return static_cast<uint16_t>(std::to_integer<unsigned>(payload[0]) |
+                               (std::to_integer<unsigned>(payload[1]) << 8));
+}
+
+void KoreLink_Asio::apply_lane_map()
+{
+  const auto& lo = options_.lanes;
+  lane_of_.assign(0x10000, static_cast<uint8_t>(lo.fallback));
+  for (const auto& [op, lane] : lo.opcodes) lane_of_[op] = static_cast<uint8_t>(lane);
+}
+
+// Queues one frame (`head` + `rest` are its bytes back to back): on its lane, or in the spill
+// journal while that is in use
+void KoreLink_Asio::enqueue(std::span<const std::byte> head, std::span<const std::byte> rest)
+{
+  if (spill_.is_open() && spill(head, rest)) return;
+  enqueue_lane(head, rest, now_ms());
+}
+
+// Queues one frame on its lane (`stamp`: when it was first queued, for the TTL), shedding first
+// when the queue is over its caps
+void KoreLink_Asio::enqueue_lane(std::span<const std::byte> head, std::span<const std::byte> rest,
+                                 uint64_t stamp)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  using arkan::relay::application::ports::Lane;
+  using arkan::relay::application::ports::ShedPolicy;
+  const auto& q = options_.queue;
+  const std::size_t len = head.size() + rest.size();
+
+  auto at = [&](std::size_t i)
+  {
+    const std::byte b = i < head.size() ? head[i] : rest[i - head.size()];
+    return std::to_integer<unsigned>(b);
+  };
+  // a fragment run is queued or shed as a unit: the decision is taken on its first fragment
+  // (the run may overshoot the caps, like gather() does), the rest follow it
+  const char kind = static_cast<char>(at(0));
+  const bool fragment = kind == env::kFragment && len > 4;
+  if (fragment && (at(4) & env::kFragFirst) == 0)
+  {
+    if (frag_shed_)
+    {
+      if (at(4) & env::kFragLast) frag_shed_ = false;
+      shed_overflow_.fetch_add(1, std::memory_order_relaxed);
+      shed_bytes_.fetch_add(len, std::memory_order_relaxed);
+      return;
+    }
+    lanes_[frag_lane_].push(head, rest, stamp);
+    return;
+  }
+
+  // the game packet's opcode, for 'R'/'Z' frames only: [kind][len16][op16], or
+  // [F][len16][kind][flags][op16] for the first fragment of a run
+  const char pkind = fragment ? static_cast<char>(at(3)) : kind;
+  const std::size_t op_at = SendRing::kHeaderSize + (fragment ? env::kFragmentPrefix : 0);
+  const bool has_opcode =
+      (pkind == env::kRecv || pkind == env::kCompressed) && len >= op_at + 2;
+  const auto opcode =
+      has_opcode ? static_cast<uint16_t>(at(op_at) | (at(op_at + 1) << 8)) : uint16_t{0};
+
+  // a run of fragments goes on the lane of the frame it carries
+  const std::size_t lane = lane_for(pkind, has_opcode, opcode);
+  if (fragment)
+  {
+    frag_lane_ = lane;
+    frag_shed_ = false;
+  }
+
+  std::size_t need_bytes = 0, need_frames = 0;
+  auto over_cap = [&]
+  {
+    need_bytes = need_frames = 0;
+    const std::size_t qb = queued_bytes();
+    const std::size_t qf = queued_frames();
+    if (q.max_bytes != 0 && qb + len > q.max_bytes) need_bytes = qb + len - q.max_bytes;
+    if (q.max_frames != 0 && qf + 1 > q.max_frames) need_frames = qf + 1 - q.max_frames;
+    return need_bytes != 0 || need_frames != 0;
+  };
+
+  // expired frames are the first to go, whatever the policy
+  if (over_cap()) shed_expired();
+
+  if (over_cap())
+  {
+    const bool sheddable =
+        has_opcode &&
+        std::find(q.shed_opcodes.begin(), q.shed_opcodes.end(), opcode) != q.shed_opcodes.end();
+    auto short_of = [&](const SendRing::Dropped& d)
+    { return d.bytes < need_bytes || d.frames < need_frames; };
+
+    // lowest-priority lanes give way first
+    SendRing::Dropped d;
+    if (q.policy == ShedPolicy::drop_class)
+    {
+      for (std::size_t i = kLanes; i-- > 0 && short_of(d);)
       {
-        try
-        {
-          sending_ = false;
-          if (ec)
-          {
-            log_.sock(arkan::relay::application::ports::LogLevel::err,
-                      "[KoreLink] async_write error: " + ec.message() +
-                          " queued_len=" + std::to_string(owned->size()));
-            schedule_reconnect();
-            return;
-          }
+        const auto got =
+            lanes_[i].drop_opcodes(q.shed_opcodes, need_bytes - (std::min)(need_bytes, d.bytes),
+                                   need_frames - (std::min)(need_frames, d.frames));
+        d.frames += got.frames;
+        d.bytes += got.bytes;
+      }
+    }
 
-          log_.sock(arkan::relay::application::ports::LogLevel::debug,
-                    "[KoreLink] async_write wrote " + std::to_string(bytes_transferred) +
-                        " bytes (queued_len=" + std::to_string(owned->size()) + ")");
+    if (q.policy == ShedPolicy::drop_newest ||
+        (q.policy == ShedPolicy::drop_class && short_of(d) && sheddable))
+    {
+      // the incoming frame is the one to go (with the rest of its run)
+      if (fragment && (at(4) & env::kFragLast) == 0) frag_shed_ = true;
+      shed_overflow_.fetch_add(d.frames + 1, std::memory_order_relaxed);
+      shed_bytes_.fetch_add(d.bytes + len, std::memory_order_relaxed);
+      log_shed();
+      return;
+    }
 
-          if (!send_q_.empty()) flush_sendq();
-        }
-        catch (const std::exception& ex)
-        {
-          log_.sock(arkan::relay::application::ports::LogLevel::err,
-                    std::string("[KoreLink] async_write handler exception: ") + ex.what());
-          schedule_reconnect();
-        }
+    for (std::size_t i = kLanes; i-- > 0;)
+    {
+      while (short_of(d) && !lanes_[i].empty())
+      {
+        const auto one = lanes_[i].drop_front(1);
+        d.frames += one.frames;
+        d.bytes += one.bytes;
+      }
+    }
+    shed_overflow_.fetch_add(d.frames, std::memory_order_relaxed);
+    shed_bytes_.fetch_add(d.bytes, std::memory_order_relaxed);
+    log_shed();
+  }
+
+  lanes_[lane].push(head, rest, stamp);
+}
+
+// -------------------- disk spill --------------------
+void KoreLink_Asio::open_spill()
+{
+  const auto& so = options_.spill;
+  if (so.dir.empty() || spill_.is_open()) return;
+
+  char b[320];
+  if (spill_.open(so.dir, so.segment_bytes, so.max_bytes))
+    std::snprintf(b, sizeof(b), "[KoreLink] spill journal at %s (max %zu bytes)\n",
+                  so.dir.c_str(), so.max_bytes);
+  else
+    std::snprintf(b, sizeof(b), "[KoreLink] spill journal disabled: cannot use %s\n",
+                  so.dir.c_str());
+  log_.sock(spill_.is_open() ? arkan::relay::application::ports::LogLevel::info
+                             : arkan::relay::application::ports::LogLevel::warn,
+            b);
+}
+
+// Sends a frame to the journal when the queue has no room for it, or when earlier frames are
+// still there (they must leave first). Returns false when the frame belongs in the queue.
+bool KoreLink_Asio::spill(std::span<const std::byte> head, std::span<const std::byte> rest)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  const auto& q = options_.queue;
+  const std::size_t len = head.size() + rest.size();
+
+  auto at = [&](std::size_t i)
+  {
+    const std::byte b = i < head.size() ? head[i] : rest[i - head.size()];
+    return std::to_integer<unsigned>(b);
+  };
+  auto full = [&]
+  {
+    return (q.max_bytes != 0 && queued_bytes() + len > q.max_bytes) ||
+           (q.max_frames != 0 && queued_frames() + 1 > q.max_frames);
+  };
+
+  // the rest of a fragment run follows its first fragment
+  const bool run_start =
+      static_cast<char>(at(0)) != env::kFragment || (len > 4 && (at(4) & env::kFragFirst) != 0);
+  if (run_start)
+  {
+    if (spill_.empty() && full()) shed_expired();
+    spill_run_ = !spill_.empty() || full();
+  }
+  if (!spill_run_) return false;
+
+  if (!spill_.append(head, rest, now_ms()))
+  {
+    // journal full (or the disk refused): the frame is shed, later ones must not overtake it
+    shed_overflow_.fetch_add(1, std::memory_order_relaxed);
+    shed_bytes_.fetch_add(len, std::memory_order_relaxed);
+    log_shed();
+    return true;
+  }
+  spilled_.fetch_add(1, std::memory_order_relaxed);
+  spill_bytes_.store(spill_.bytes(), std::memory_order_relaxed);
+  schedule_spill();
+  return true;
+}
+
+void KoreLink_Asio::schedule_spill()
+{
+  if (spill_armed_ || spill_.empty() || closing_ || live_connections() == 0) return;
+
+  spill_armed_ = true;
+  spill_timer_.expires_after(kSpillTick);
+  spill_timer_.async_wait(
+      [this, life = life_](const boost::system::error_code& ec)
+      {
+        spill_armed_ = false;
+        if (!ec) drain_spill();
       });
 }
 
-void KoreLink_Asio::do_read_header()
+// Feeds the journal back into the queue, oldest first: up to drain_rate per second, and only
+// while the queue is below half its cap, so live traffic queued meanwhile is not shed for it.
+// Frames keep the stamp they were first queued with: those past the TTL are dropped here.
+void KoreLink_Asio::drain_spill()
 {
-  if (closing_) return;
-  auto buf = boost::asio::buffer(hdr_.data(), hdr_.size());
-  boost::asio::async_read(socket_, buf,
-                          [this](const boost::system::error_code& ec, std::size_t)
-                          {
-                            if (ec)
-                            {
-                              schedule_reconnect();
-                              return;
-                            }
-                            const uint16_t len = le16(hdr_[1], hdr_[2]);
-                            log_.sock(
-                                arkan::relay::application::ports::LogLevel::info,
-                                "[KoreLink] read header kind=" +
-                                    std::to_string((int)std::to_integer<unsigned char>(hdr_[0])) +
-                                    " len=" + std::to_string(len));
-
-                            do_read_body(len);
-                          });
-}
-
-void KoreLink_Asio::do_read_body(std::size_t body_len)
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (closing_ || spill_.empty() || live_connections() == 0) return;
+
+  const auto& q = options_.queue;
+  const std::size_t budget =
+      (std::max)(options_.spill.drain_rate / (1000 / kSpillTick.count()), std::size_t{1});
+  const std::size_t refill = q.max_bytes != 0 ? q.max_bytes / 2 : kSpillRefill;
+  const uint64_t now = now_ms();
+  const uint64_t ttl = q.ttl.count() > 0 ? static_cast<uint64_t>(q.ttl.count()) : 0;
+
+  std::size_t moved = 0;
+  SendRing::Dropped expired;
+  bool expired_run = false;  // a run goes with its first fragment
+  while (!spill_.empty())
+  {
+    const auto f = spill_.front();
+    const uint64_t stamp = spill_.front_stamp();
+    const bool mid_run =
+        static_cast<char>(std::to_integer<unsigned char>(f[0])) == env::kFragment &&
+        f.size() > 4 && (std::to_integer<unsigned>(f[4]) & env::kFragFirst) == 0;
+    if (!mid_run) expired_run = ttl != 0 && now > ttl && stamp < now - ttl;
+    if (expired_run)
+    {
+      ++expired.frames;
+      expired.bytes += f.size();
+      spill_.pop();
+      continue;
+    }
+
+    const bool room = queued_bytes() == 0 ||
+                      (queued_bytes() + f.size() <= refill &&
+                       (q.max_frames == 0 || queued_frames() < q.max_frames / 2));
+    const bool quota = moved == 0 || moved + f.size() <= budget;
+    if (!mid_run && !(room && quota)) break;
+
+    enqueue_lane(f, {}, stamp);
+    moved += f.size();
+    unspilled_.fetch_add(1, std::memory_order_relaxed);
+    spill_.pop();
+  }
+  spill_bytes_.store(spill_.bytes(), std::memory_order_relaxed);
+  if (expired.frames != 0)
+  {
+    shed_expired_.fetch_add(expired.frames, std::memory_order_relaxed);
+    shed_bytes_.fetch_add(expired.bytes, std::memory_order_relaxed);
+    log_shed();
+  }
+
+  if (spill_.empty())
+  {
+    char b[128];
+    std::snprintf(b, sizeof(b), "[KoreLink] spill journal drained (%llu frames fed back)\n",
+                  (unsigned long long)unspilled_.load(std::memory_order_relaxed));
+    log_.sock(arkan::relay::application::ports::LogLevel::info, b);
+  }
+  if (moved != 0) flush_sendq();
+  schedule_spill();
+}
+
+void KoreLink_Asio::shed_expired()
+{
+  const auto ttl = options_.queue.ttl.count();
+  if (ttl <= 0 || lanes_empty()) return;
+  // with the journal in use an outage fills the queue and spills instead: the TTL is applied
+  // once a connection is back, to queued and journaled frames alike (see drain_spill)
+  if (spill_.is_open() && live_connections() == 0) return;
+
+  // a frame that sat in the queue past its TTL is worth less than no frame at all
+  const uint64_t now = now_ms();
+  if (now <= static_cast<uint64_t>(ttl)) return;
+
+  SendRing::Dropped d;
+  for (auto& l : lanes_)
+  {
+    const auto got = l.drop_older_than(now - static_cast<uint64_t>(ttl));
+    d.frames += got.frames;
+    d.bytes += got.bytes;
+  }
+  if (d.frames == 0) return;
+
+  shed_expired_.fetch_add(d.frames, std::memory_order_relaxed);
+  shed_bytes_.fetch_add(d.bytes, std::memory_order_relaxed);
+  log_shed();
+}
+
+// Deficit round robin across the lanes: each write carries up to weight * kLaneQuantum bytes
+// of every non-empty lane (unused credit carries over while the lane stays backlogged), so a
+// bulk flood delays interactive frames by one bounded write at most. Flow-control credit from
+// Kore caps the whole write on top of that.
+void KoreLink_Asio::schedule_lanes(Conn& c)
+{
+  for (auto& g : c.wbatch) g = {};
+
+  constexpr std::size_t kNoLimit = std::numeric_limits<std::size_t>::max();
+  if ((c.credit_bytes_on && c.credit_bytes <= 0) || (c.credit_frames_on && c.credit_frames <= 0))
+    return;
+  std::size_t left_bytes =
+      c.credit_bytes_on ? static_cast<std::size_t>(c.credit_bytes) : kNoLimit;
+  std::size_t left_frames =
+      c.credit_frames_on ? static_cast<std::size_t>(c.credit_frames) : kNoLimit;
+
+  // frames this connection's Kore did not agree to stay queued for one that did
+  namespace env = arkan::relay::domain::protocol::envelope;
+  char held[2];
+  std::size_t nheld = 0;
+  if (!(c.features & env::kFeatFragments)) held[nheld++] = env::kFragment;
+  if (!(c.features & env::kFeatCompress)) held[nheld++] = env::kCompressed;
+  const std::string_view hold(held, nheld);
+
+  std::size_t taken = 0;
+  // a frame larger than a lane's quantum needs a few rounds of credit before it fits
+  for (int round = 0; round < 8 && taken == 0 && !lanes_empty(); ++round)
+  {
+    for (std::size_t i = 0; i < kLanes; ++i)
+    {
+      auto& lane = lanes_[i];
+      if (lane.empty() || c.wbatch[i].bytes != 0)
+      {
+        if (lane.empty()) deficit_[i] = 0;
+        continue;
+      }
+      if (!hold.empty() && !admit_front(c, i, hold)) continue;
+
+      // the first frame of a write goes out whole as long as any credit is left
+      if (left_bytes == 0 || left_frames == 0) return;
+
+      const std::size_t w = (std::max)(options_.lanes.weights[i], 1u);
+      deficit_[i] += w * kLaneQuantum;
+
+      // a batched region must fit one 'B' payload (a frame too large for that goes out bare)
+      std::size_t cap = deficit_[i];
+      if (options_.batch.window.count() > 0 && lane.front_bytes() <= kMaxBatch)
+        cap = (std::min)(cap, kMaxBatch);
+      cap = (std::min)(cap, (std::max)(left_bytes, taken == 0 ? lane.front_bytes() : 0));
+      std::size_t max_frames = write_batch_limit_ == 0 ? kNoLimit : write_batch_limit_;
+      max_frames = (std::min)(max_frames, left_frames);
+
+      c.wbatch[i] = lane.gather(max_frames == kNoLimit ? 0 : max_frames, cap, hold);
+      left_bytes -= (std::min)(left_bytes, c.wbatch[i].bytes);
+      left_frames -= (std::min)(left_frames, c.wbatch[i].frames);
+      deficit_[i] -= c.wbatch[i].bytes;
+      if (lane.empty()) deficit_[i] = 0;
+      taken += c.wbatch[i].bytes;
+    }
+  }
+}
+
+// Whether lane `lane` may give its oldest frame to `c`. 'F' runs and 'Z' frames cannot be
+// re-encoded here (the link has no codec, and a run does not fit one plain frame), so one whose
+// kind is in `hold` waits for a connection that agreed to it, or one still in its handshake;
+// with none connected it is shed, as Kore could not read it anyway.
+bool KoreLink_Asio::admit_front(Conn& c, std::size_t lane, std::string_view hold)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  auto& l = lanes_[lane];
+  while (!l.empty())
+  {
+    const char kind = l.front_kind(), inner = l.front_kind(true);
+    if (hold.find(kind) == std::string_view::npos && hold.find(inner) == std::string_view::npos)
+      return true;
+
+    const uint32_t need = (kind == env::kFragment ? env::kFeatFragments : 0) |
+                          (inner == env::kCompressed ? env::kFeatCompress : 0);
+    const bool other = std::any_of(conns_.begin(), conns_.end(),
+                                   [&](const auto& o)
+                                   {
+                                     return o.get() != &c && o->connected &&
+                                            (o->hello_pending || (o->features & need) == need);
+                                   });
+    if (other) return false;
+
+    const auto d = l.drop_front(1);
+    shed_unsupported_.fetch_add(d.frames, std::memory_order_relaxed);
+    shed_bytes_.fetch_add(d.bytes, std::memory_order_relaxed);
+    log_shed();
+  }
+  return false;
+}
+
+// Micro-batching: the first frame queued after a flush opens a window; writes are held back
+// until it ends or `max_bytes` are queued, so a burst leaves in one write instead of many.
+bool KoreLink_Asio::batch_ready()
+{
+  const auto& b = options_.batch;
+  if (b.window.count() <= 0 || lanes_empty()) return true;
+  if (b.max_bytes != 0 && queued_bytes() >= b.max_bytes) return true;
+
+  const auto now = std::chrono::steady_clock::now();
+  if (!batch_open_)
+  {
+    batch_open_ = true;
+    batch_due_ = now + b.window;
+    batch_timer_.expires_at(batch_due_);
+    auto on_timer = [this, life = life_](const boost::system::error_code& ec)
+    {
+      if (ec || closing_) return;
+      flush_sendq();
+    };
+    batch_timer_.async_wait(with_memory(batch_mem_, std::move(on_timer)));
+    return false;
+  }
+  return now >= batch_due_;
+}
+
+void KoreLink_Asio::flush_sendq()
 {
   if (closing_) return;
+  shed_expired();
+  if (!batch_ready()) return;
+
+  // idle live connections, fastest recent writer first
+  pick_.clear();
+  for (auto& c : conns_)
+  {
+    if (c->connected && !c->sending) pick_.push_back(c.get());
+  }
+  if (pick_.size() > 1)
+  {
+    std::sort(pick_.begin(), pick_.end(),
+              [](const Conn* a, const Conn* b) { return a->write_us < b->write_us; });
+  }
+
+  for (Conn* c : pick_) flush_conn(*c);
+
+  // everything was handed to a socket: the next frame starts a new window
+  if (lanes_empty()) batch_open_ = false;
+}
+
+bool KoreLink_Asio::flush_conn(Conn& c)
+{
+  if (c.ctl.empty() && lanes_empty() && !c.replay_due) return false;
+
+  // connection control frames first, then each lane's share, in lane priority order, as one
+  // gathered write; the queued bytes stay in their rings until the write completes. The first
+  // write after a reconnect carries the unacknowledged frames instead of the lanes' share.
+  c.sending = true;
+  c.ctl_inflight.swap(c.ctl);
+  c.wreplay = std::exchange(c.replay_due, false) && !c.replay.empty();
+  if (c.wreplay || c.hello_pending)
+    for (auto& g : c.wbatch) g = {};
+  else
+    schedule_lanes(c);
 
-  // special-case zero-length body: handle immediately (no async_read with 0 bytes)
-  if (body_len == 0)
+  // out of credit with nothing else to say: the frames wait in their lanes for the next grant
+  if (c.ctl_inflight.empty() && !c.wreplay &&
+      std::all_of(c.wbatch.begin(), c.wbatch.end(), [](const auto& g) { return g.bytes == 0; }))
   {
-    if (on_frame_)
+    c.sending = false;
+    if (c.credit_bytes_on || c.credit_frames_on)
+      credit_stalls_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // with micro-batching on, each lane region of two or more frames is prefixed with a 'B'
+  // header: the region already is a run of complete frames, so it becomes the batch payload
+  namespace env = arkan::relay::domain::protocol::envelope;
+  const bool batching = options_.batch.window.count() > 0 && (c.features & env::kFeatBatch);
+  std::size_t frames = 0, bytes = 0;
+  c.wbatches = 0;
+  c.wbufs[0] = boost::asio::buffer(c.ctl_inflight);
+  for (std::size_t i = 0; i < kLanes; ++i)
+  {
+    const auto& g = c.wbatch[i];
+    c.wbufs[1 + 3 * i] = boost::asio::const_buffer();
+    if (batching && g.frames > 1 && g.bytes <= kMaxBatch)
     {
-      const char kind = static_cast<char>(hdr_[0]);
-      on_frame_(kind, std::span<const std::byte>());  // empty span
+      c.bhdr[i] = make_header('B', g.bytes);
+      c.wbufs[1 + 3 * i] = boost::asio::buffer(c.bhdr[i]);
+      ++c.wbatches;
     }
-    // continue reading next header
-    do_read_header();
-    return;
+    c.wbufs[2 + 3 * i] = g.bufs[0];
+    c.wbufs[3 + 3 * i] = g.bufs[1];
+    frames += g.frames;
+    bytes += g.bytes;
+  }
+  if (c.wreplay)
+  {
+    const auto rb = c.replay.buffers();
+    c.wbufs[2] = rb[0];
+    c.wbufs[3] = rb[1];
+    frames = c.replay.frames();
+    bytes = c.replay.bytes();
+  }
+  c.wframes = frames;
+
+  // credit is spent when the frames are handed over; replayed frames were paid for already
+  if (!c.wreplay)
+  {
+    if (c.credit_bytes_on) c.credit_bytes -= static_cast<int64_t>(bytes);
+    if (c.credit_frames_on) c.credit_frames -= static_cast<int64_t>(frames);
   }
 
-  body_.assign(body_len, std::byte{0});
-  boost::asio::async_read(
-      socket_, boost::asio::buffer(body_.data(), body_.size()),
-      [this, body_len](const boost::system::error_code& ec, std::size_t)
+  // frames are numbered as they are handed to the socket (Kore may ack them before the write
+  // completes) and kept until acknowledged, whether or not the write makes it
+  c.wkept = c.replay.enabled() && (c.features & env::kFeatSequence) && !c.wreplay;
+  if (c.wkept)
+  {
+    const uint64_t evicted = c.replay.evicted();
+    for (const auto& g : c.wbatch) c.replay.append(g);
+    replay_evicted_.fetch_add(c.replay.evicted() - evicted, std::memory_order_relaxed);
+  }
+  c.write_start = std::chrono::steady_clock::now();
+
+  if (emit_pending_us_ != 0 && frames != 0 && !c.wreplay)
+  {
+    const uint64_t now = now_us();
+    emit_to_write_.record(now > emit_pending_us_ ? now - emit_pending_us_ : 0);
+    emit_pending_us_ = 0;
+  }
+
+  log_.sockf(arkan::relay::application::ports::LogLevel::debug,
+             "[KoreLink] flush_sendq conn#{} -> writing frames={} len={}", c.id, frames, bytes);
+
+  auto on_written = [this, &c, gen = c.gen, life = life_](const boost::system::error_code& ec,
+                                                          std::size_t bytes_transferred)
+  {
+    try
+    {
+      c.sending = false;
+
+      // a failed write puts its frames back in front of their lanes, for the rest of the pool
+      // or this connection once it is back; frames the replay buffer holds are resent from there
+      const bool requeue = ec && !closing_ && !c.wkept;
+      for (std::size_t i = 0; i < kLanes; ++i)
+      {
+        if (requeue)
+          lanes_[i].requeue(c.wbatch[i]);
+        else
+          lanes_[i].consume(c.wbatch[i]);
+      }
+      c.ctl_inflight.clear();
+      if (closing_) return;
+      if (ec)
+      {
+        const char* fate = c.wkept || c.wreplay ? " frames_kept_for_replay=" : " frames_requeued=";
+        log_.sock(arkan::relay::application::ports::LogLevel::err,
+                  "[KoreLink] conn#" + std::to_string(c.id) + " async_write error: " +
+                      ec.message() + fate + std::to_string(c.wframes));
+        if (gen == c.gen) schedule_reconnect(c);
+        // frames still queued go out on the remaining connections right away
+        flush_sendq();
+        return;
+      }
+
+      writes_.fetch_add(1, std::memory_order_relaxed);
+      c.last_tx = std::chrono::steady_clock::now();
+      batches_.fetch_add(c.wbatches, std::memory_order_relaxed);
+      frames_written_.fetch_add(c.wframes, std::memory_order_relaxed);
+      if (c.wreplay) replayed_.fetch_add(c.wframes, std::memory_order_relaxed);
+      bytes_written_.fetch_add(bytes_transferred, std::memory_order_relaxed);
+
+      // EWMA (1/8) of the completion time: slow connections are picked last
+      const double us = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - c.write_start)
+                            .count();
+      c.write_us += (us - c.write_us) / 8.0;
+
+      log_.sockf(arkan::relay::application::ports::LogLevel::debug,
+                 "[KoreLink] async_write wrote {} bytes (frames={})", bytes_transferred,
+                 c.wframes);
+
+      flush_sendq();
+    }
+    catch (const std::exception& ex)
+    {
+      log_.sock(arkan::relay::application::ports::LogLevel::err,
+                std::string("[KoreLink] async_write handler exception: ") + ex.what());
+      if (gen == c.gen) schedule_reconnect(c);
+    }
+  };
+  boost::asio::async_write(c.socket, c.wbufs, with_memory(c.write_mem, std::move(on_written)));
+  return true;
+}
+
+void KoreLink_Asio::do_read(Conn& c)
+{
+  if (closing_) return;
+
+  // one read_some may carry many frames (or the tail of one): parse all complete ones in place
+  auto on_read = [this, &c, gen = c.gen, life = life_](const boost::system::error_code& ec,
+                                                       std::size_t n)
+  {
+    if (gen != c.gen) return;  // connection already torn down
+    try
+    {
+      if (ec)
       {
-        try
+        schedule_reconnect(c);
+        return;
+      }
+      c.reader.commit(n);
+      c.last_rx = std::chrono::steady_clock::now();
+
+      char kind = 0;
+      std::span<const std::byte> payload;
+      while (c.reader.next(kind, payload))
+      {
+        log_.sockf(arkan::relay::application::ports::LogLevel::info,
+                   "[KoreLink] read frame kind={} len={}", static_cast<unsigned char>(kind),
+                   payload.size());
+
+        // 'F' runs are delivered as the one logical frame they carry
+        if (kind == 'F' && !c.frags.feed(payload, kind, payload)) continue;
+        // probe echoes are link business; plain keepalives still reach the callback
+        if (kind == 'K' && on_keepalive(c, payload)) continue;
+        if (kind == 'A')
         {
-          if (ec)
-          {
-            schedule_reconnect();
-            return;
-          }
-          if (on_frame_)
-          {
-            const char kind = static_cast<char>(hdr_[0]);
-            on_frame_(kind, std::span<const std::byte>(body_.data(), body_len));
-          }
-          do_read_header();
+          on_ack(c, payload);
+          continue;
         }
-        catch (const std::exception& ex)
+        if (kind == 'C')
         {
-          // ensure exceptions don't escape the asio handler
-          log_.sock(arkan::relay::application::ports::LogLevel::err,
-                    std::string("[KoreLink] do_read_body handler exception: ") + ex.what());
-          schedule_reconnect();
+          on_credit(c, payload);
+          continue;
         }
-      });
+        if (kind == 'H')
+        {
+          on_hello(c, payload);
+          continue;
+        }
+        if (on_frame_) on_frame_(kind, payload);
+      }
+
+      do_read(c);
+    }
+    catch (const std::exception& ex)
+    {
+      // ensure exceptions don't escape the asio handler
+      log_.sock(arkan::relay::application::ports::LogLevel::err,
+                std::string("[KoreLink] do_read handler exception: ") + ex.what());
+      schedule_reconnect(c);
+    }
+  };
+  c.socket.async_read_some(c.reader.prepare(), with_memory(c.read_mem, std::move(on_read)));
 }
 
 // -------------------- framing helpers --------------------
+uint64_t KoreLink_Asio::now_ms()
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+uint64_t KoreLink_Asio::now_us()
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
 std::array<std::byte, 3> KoreLink_Asio::make_header(char kind, std::size_t len)
 {
   const uint16_t L = static_cast<uint16_t>(len);
@@ -516,9 +1824,4 @@ std::array<std::byte, 3> KoreLink_Asio::make_header(char kind, std::size_t len)
           std::byte{static_cast<unsigned char>((L >> 8) & 0xFF)}};
 }
 
-uint16_t KoreLink_Asio::le16(std::byte lo, std::byte hi)
-{
-  return static_cast<uint16_t>(static_cast<unsigned>(lo) | (static_cast<unsigned>(hi) << 8));
-}
-
 }  // namespace arkan::relay::infrastructure::link
@@ -4,17 +4,28 @@
 #include <array>
 #include <atomic>
 #include <boost/asio.hpp>
+#include <chrono>
 #include <cstdint>
-#include <deque>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #include "application/ports/IKoreLink.hpp"
 #include "application/ports/ILogger.hpp"
+#include "infrastructure/link/FragmentAssembler.hpp"
+#include "infrastructure/link/FrameReader.hpp"
+#include "infrastructure/link/FrameStaging.hpp"
+#include "infrastructure/link/HandlerMemory.hpp"
+#include "infrastructure/link/LatencyHistogram.hpp"
+#include "infrastructure/link/ReplayBuffer.hpp"
+#include "infrastructure/link/SendRing.hpp"
+#include "infrastructure/link/SpillJournal.hpp"
+#include "infrastructure/net/IoPool.hpp"
 #include "infrastructure/win32/PortClaim.hpp"
 
 namespace arkan::relay::infrastructure::link
@@ -25,86 +36,378 @@ class KoreLink_Asio final : public arkan::relay::application::ports::IKoreLink
  public:
   using tcp = boost::asio::ip::tcp;
 
+  // Runs on a private single-thread pool
   KoreLink_Asio(arkan::relay::application::ports::ILogger& log);
+  // Runs on a shared pool, serialized by a strand of its own. `pool` must outlive the link and
+  // the link must not be destroyed from one of the pool's threads.
+  KoreLink_Asio(arkan::relay::application::ports::ILogger& log,
+                arkan::relay::infrastructure::net::IoPool& pool);
   ~KoreLink_Asio() override;
 
   // IKoreLink
   void connect(const std::string& host, uint16_t port) override;
   void close() override;
   void send_frame(char kind, std::span<const std::byte> payload) override;
+  arkan::relay::application::ports::FrameReservation reserve(char kind, std::size_t len) override;
+  void commit(arkan::relay::application::ports::FrameReservation& r) override;
   void on_frame(std::function<void(char, std::span<const std::byte>)> cb) override
   {
     on_frame_ = std::move(cb);
   }
+  uint32_t peer_features() const override
+  {
+    return peer_features_.load(std::memory_order_relaxed);
+  }
 
   void set_candidate_ports(std::vector<uint16_t> ports) override;
   void set_reconnect_policy(const arkan::relay::application::ports::ReconnectPolicy& p) override;
+  void set_options(const arkan::relay::application::ports::LinkOptions& o) override;
+
+  // Caps how many queued frames a single gathered write may carry (0 = everything queued).
+  // 1 reproduces the legacy one-write-per-frame behaviour; meant for benchmarks.
+  void set_write_batch_limit(std::size_t max_frames);
+
+  // Write-path counters (telemetry/benchmarks)
+  struct Stats
+  {
+    uint64_t frames_written{0};
+    uint64_t bytes_written{0};
+    uint64_t writes{0};
+    uint64_t batches{0};     // 'B' envelopes written (micro-batching)
+    uint64_t fragmented{0};  // payloads over 65535 bytes sent as 'F' runs
+    uint64_t failovers{0};   // connections lost while others were still up
+    uint64_t resolves{0};    // host lookups (resolved addresses are cached)
+
+    // handshake (see HandshakeOptions)
+    uint64_t hellos{0};          // 'H' answers from Kore
+    uint64_t hello_timeouts{0};  // connections left on the original envelope (no answer)
+
+    // keepalive probes (smoothed over every connection, RFC 6298 style)
+    uint64_t srtt_us{0};
+    uint64_t rttvar_us{0};
+    uint64_t rtt_samples{0};
+    uint64_t dead_peers{0};  // connections dropped for silence
+
+    // sequencing (see ReplayOptions)
+    uint64_t acked{0};           // frames Kore acknowledged
+    uint64_t replayed{0};        // unacknowledged frames written again after a reconnect
+    uint64_t replay_evicted{0};  // frames evicted from a full replay buffer unacknowledged
+
+    // flow control (credit granted by Kore)
+    uint64_t credit_grants{0};
+    uint64_t credit_stalls{0};  // writes held back because a connection ran out of credit
+
+    // producer commit -> socket write issued (I/O thread wakeup + queueing), microseconds
+    uint64_t emit_to_write_p50_us{0};
+    uint64_t emit_to_write_p99_us{0};
+    uint64_t emit_to_write_samples{0};
+
+    // load shedding (frames dropped before reaching the socket)
+    uint64_t shed_overflow{0};     // queue over max_bytes/max_frames
+    uint64_t shed_expired{0};      // queued longer than the TTL
+    uint64_t shed_unsupported{0};  // 'F'/'Z' frames no connected Kore agreed to
+    uint64_t shed_bytes{0};
+
+    // disk spill (see SpillOptions)
+    uint64_t spilled{0};           // frames written to the journal
+    uint64_t unspilled{0};         // frames fed back from the journal into the queue
+    uint64_t spill_queued_bytes{0};  // bytes in the journal right now
+  };
+  Stats stats() const;
 
  private:
+  static constexpr std::size_t kLanes = arkan::relay::application::ports::kLaneCount;
+  static constexpr std::size_t kLaneQuantum = 16 * 1024;  // bytes per weight unit and write
+  static constexpr std::size_t kMaxBatch = 0xFFFF;        // sub-frame bytes one 'B' can carry
+  static constexpr std::chrono::milliseconds kMinConnectTimeout{250};
+  static constexpr std::chrono::milliseconds kMaxConnectTimeout{5000};
+  static constexpr std::chrono::milliseconds kSpillTick{10};  // journal drain period
+  static constexpr std::size_t kSpillRefill = 256 * 1024;     // queue level the drain tops up to
+
+  // I/O objects are bound to the strand's concrete type: the default type-erased executor
+  // allocates every time an operation copies it
+  using strand_type = arkan::relay::infrastructure::net::IoPool::strand_type;
+  using socket_type = boost::asio::basic_stream_socket<tcp, strand_type>;
+  using timer_type =
+      boost::asio::basic_waitable_timer<std::chrono::steady_clock,
+                                        boost::asio::wait_traits<std::chrono::steady_clock>,
+                                        strand_type>;
+
+  // One pending connect attempt: its own socket and port claim. The winner of a race is
+  // swapped into its Conn.
+  struct Racer
+  {
+    explicit Racer(strand_type& strand)
+        : socket(strand)
+    {
+    }
+
+    socket_type socket;
+    std::unique_ptr<arkan::relay::infrastructure::PortClaim> claim{
+        std::make_unique<arkan::relay::infrastructure::PortClaim>()};
+    uint16_t port{0};  // 0 = idle
+  };
+
+  // One TCP connection to Kore. With pool_size > 1 several are kept live and share the lanes.
+  struct Conn
+  {
+    Conn(strand_type& strand, unsigned conn_id)
+        : id(conn_id), socket(strand), ping_timer(strand), reconn_timer(strand)
+    {
+    }
+
+    unsigned id;
+    socket_type socket;
+    timer_type ping_timer;
+    timer_type reconn_timer;
+
+    // PortClaim instance (Win32)
+    std::unique_ptr<arkan::relay::infrastructure::PortClaim> port_claim{
+        std::make_unique<arkan::relay::infrastructure::PortClaim>()};
+    uint16_t port{0};
+    bool connected{false};
+    uint32_t gen{0};  // bumped on every teardown; stale read handlers compare against it
+
+    // connect attempts in flight (see LinkOptions::connect_race)
+    std::vector<std::unique_ptr<Racer>> racers;
+    std::size_t racing{0};
+
+    // features in use on this connection ('H' bits, see HandshakeOptions)
+    uint32_t features{0};
+    uint32_t max_frame{0};      // largest frame Kore accepts here, 0 = no stated limit
+    bool hello_pending{false};  // 'H' sent, Kore's answer awaited: queued frames are held
+    std::chrono::steady_clock::time_point hello_at{};
+
+    // keepalive / RTT probes (see KeepaliveOptions)
+    std::chrono::steady_clock::time_point last_rx{};
+    std::chrono::steady_clock::time_point last_tx{};
+    std::chrono::steady_clock::time_point probe_at{};
+    uint32_t probe_seq{0};  // probe awaiting its echo (0 = none)
+    bool echoes{false};     // peer answered a probe: silence detection armed
+    std::chrono::milliseconds ping_every{0};
+
+    // reconnection state
+    std::chrono::milliseconds cur_delay{0};
+    unsigned attempt{0};
+    std::size_t port_idx{0};  // round-robin cursor into candidate_ports_
+
+    // framing (inbound frames are parsed in place from one reusable buffer)
+    FrameReader reader;
+    FragmentAssembler frags;
+
+    // frames written but not yet acknowledged by Kore (sequencing on)
+    ReplayBuffer replay;
+    bool replay_due{false};  // write the replay buffer before anything else
+
+    // flow control: credit granted by Kore ('C' frames); a unit is unlimited until first granted
+    bool credit_bytes_on{false};
+    bool credit_frames_on{false};
+    int64_t credit_bytes{0};  // may go negative: the frame that exhausts credit goes out whole
+    int64_t credit_frames{0};
+
+    // connection-scoped control frames (keepalive), written ahead of queued data
+    std::vector<std::byte> ctl;
+    std::vector<std::byte> ctl_inflight;
+
+    // in-flight write
+    bool sending{false};
+    std::array<SendRing::Gather, kLanes> wbatch{};  // one region per lane
+    std::array<std::array<std::byte, 3>, kLanes> bhdr{};  // 'B' header per lane region
+    std::array<boost::asio::const_buffer, 1 + 3 * kLanes> wbufs{};
+    std::size_t wframes{0};
+    std::size_t wbatches{0};
+    bool wreplay{false};  // the write in flight is a replay
+    bool wkept{false};    // its lane frames are in the replay buffer too
+    std::chrono::steady_clock::time_point write_start{};
+    double write_us{0.0};  // smoothed write completion time (pool pick order)
+
+    // recycled operation storage of the read, write and ping loops
+    HandlerMemory read_mem;
+    HandlerMemory write_mem;
+    HandlerMemory ping_mem;
+  };
+
   // life cycle
-  void start_connect();
-  void schedule_reconnect();
-  void do_read_header();
-  void do_read_body(std::size_t body_len);
+  void ensure_pool();
+  void start_connect(Conn& c);
+  void launch_racers(Conn& c);
+  void on_race_result(Conn& c, Racer& r, const boost::system::error_code& ec);
+  void schedule_reconnect(Conn& c);
+  void teardown(Conn& c);
+  void do_read(Conn& c);
+  void enqueue(std::span<const std::byte> head, std::span<const std::byte> rest);
+  void enqueue_lane(std::span<const std::byte> head, std::span<const std::byte> rest,
+                    uint64_t stamp);
+  bool spill(std::span<const std::byte> head, std::span<const std::byte> rest);
+  void open_spill();
+  void schedule_spill();
+  void drain_spill();
+  void enqueue_fragments(char kind, std::span<const std::byte> payload);
+  std::size_t lane_for(char kind, bool has_opcode, uint16_t opcode) const;
+  static uint16_t opcode_at(std::span<const std::byte> payload);
+  void shed_expired();
+  void apply_lane_map();
+  void schedule_lanes(Conn& c);
+  bool admit_front(Conn& c, std::size_t lane, std::string_view hold);
+  bool lanes_empty() const;
+  std::size_t queued_bytes() const;
+  std::size_t queued_frames() const;
+  bool batch_ready();
   void flush_sendq();
-  void schedule_ping();
+  bool flush_conn(Conn& c);
+  void drain_staging();
+  void send_hello(Conn& c);
+  void on_hello(Conn& c, std::span<const std::byte> payload);
+  void start_session(Conn& c);
+  uint32_t own_features() const;
+  void update_peer_features();
+  void schedule_ping(Conn& c);
+  void on_ping(Conn& c);
+  void send_probe(Conn& c);
+  bool on_keepalive(Conn& c, std::span<const std::byte> payload);
+  void start_sequence(Conn& c);
+  void on_ack(Conn& c, std::span<const std::byte> payload);
+  void hand_over_unacked(Conn& c);
+  void on_credit(Conn& c, std::span<const std::byte> payload);
+  std::chrono::milliseconds probe_timeout() const;
+  std::chrono::milliseconds connect_timeout() const;
 
   // helpers
   static std::array<std::byte, 3> make_header(char kind, std::size_t len);
-  static uint16_t le16(std::byte lo, std::byte hi);
-  uint16_t current_port_nolock() const;
+  static uint64_t now_ms();
+  static uint64_t now_us();
+  std::size_t live_connections() const;
 
-  // PortClaim instance (Win32)
-  arkan::relay::infrastructure::PortClaim port_claim_;
-  // tries to claim an available port (runs on strand)
-  bool claim_port_for_connect(uint16_t& out_port);
+  // claims up to `want` available ports not used by another connection, one per racer
+  // (runs on strand); returns how many were claimed
+  std::size_t claim_ports_for_connect(Conn& c, std::size_t want);
+  bool port_busy(uint16_t p) const;
 
   // Log
   application::ports::ILogger& log_;
 
   // telemetry helpers (no-throw, no-alloc)
   static void dbg(const char* s);
-  void log_connected(uint16_t port) const;
-  void log_switch_port(uint16_t oldp, uint16_t newp) const;
-  void log_reconnect_in(long long ms) const;
+  void log_connected(const Conn& c) const;
+  void log_switch_port(const Conn& c, uint16_t oldp, uint16_t newp) const;
+  void log_reconnect_in(const Conn& c, long long ms) const;
+  void log_rtt(const Conn& c, double sample_us) const;
+  void log_shed();
+  void log_latency() const;
 
   // simple xorshift32 RNG for jitter (avoid <random>)
   static uint32_t xorshift32_(uint32_t& s);
   static double unit_01_(uint32_t& s);
 
  private:
-  // asio
-  boost::asio::io_context io_;
-  boost::asio::strand<boost::asio::io_context::executor_type> strand_{io_.get_executor()};
-  std::optional<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> work_;
-  std::thread io_thread_;
-  tcp::resolver resolver_{strand_};
-  tcp::socket socket_{strand_};
-  boost::asio::steady_timer ping_timer_{strand_};
-  boost::asio::steady_timer reconn_timer_{strand_};
+  KoreLink_Asio(arkan::relay::application::ports::ILogger& log,
+                std::unique_ptr<arkan::relay::infrastructure::net::IoPool> own);
+
+  // asio (own_pool_ is only set by the single-thread constructor; it is destroyed last)
+  std::unique_ptr<arkan::relay::infrastructure::net::IoPool> own_pool_;
+  arkan::relay::infrastructure::net::IoPool& pool_;
+  strand_type strand_;
+  tcp::resolver resolver_;
+
+  // copied into every pending async handler; the dtor waits until no copy is left
+  std::shared_ptr<void> life_{std::make_shared<char>()};
 
   // config/state
   std::string host_;
   uint16_t single_port_{0};
   std::atomic<bool> closing_{false};
-  std::atomic<bool> connected_{false};
+
+  // addresses of host_, resolved once and reused by every connect attempt; cleared when an
+  // attempt fails in a way that suggests they went stale
+  std::vector<boost::asio::ip::address> host_addrs_;
 
   // reconnection policy
   arkan::relay::application::ports::ReconnectPolicy policy_{};
-  std::chrono::milliseconds cur_delay_{policy_.initial};
-  unsigned attempt_{0};
 
-  // round-robin
+  // candidate ports (round-robin per connection)
   std::vector<uint16_t> candidate_ports_;
-  std::size_t port_idx_{0};
 
-  // framing
-  std::array<std::byte, 3> hdr_{};
-  std::vector<std::byte> body_;
+  // connection pool (built on first connect; entries are never destroyed while io_ runs)
+  arkan::relay::application::ports::LinkOptions options_{};
+  std::vector<std::unique_ptr<Conn>> conns_;
+  std::vector<Conn*> pick_;  // scratch for flush_sendq()
+
+  // producer staging (lock-free, any thread) -> drained into the send lanes on strand_
+  FrameStaging staging_;
+  std::atomic<bool> wake_pending_{false};
+  HandlerMemory wake_mem_;  // the drain_staging() post (one in flight, see commit())
+
+  // emit -> write latency: the producer that wakes the strand stamps its frame (the oldest of
+  // the pass); the stamp is recorded when a write next goes out
+  std::atomic<uint64_t> emit_us_{0};
+  uint64_t emit_pending_us_{0};
+  LatencyHistogram emit_to_write_;
+  std::atomic<uint32_t> fallback_pending_{0};  // send_frame() copies posted but not queued yet
+
+  // send lanes shared by every connection, indexed by ports::Lane (single-threaded by strand_)
+  std::array<SendRing, kLanes> lanes_;
+  std::array<std::size_t, kLanes> deficit_{};  // DRR credit, bytes
+  std::vector<uint8_t> lane_of_;               // 'R' opcode -> lane
+  std::size_t frag_lane_{0};                   // lane of the 'F' run being queued
+  bool frag_shed_{false};                      // its first fragment was shed: so is the rest
+  std::size_t write_batch_limit_{0};
+
+  // micro-batching window (see BatchOptions): opened by the first frame queued after a flush
+  timer_type batch_timer_{strand_};
+  HandlerMemory batch_mem_;
+  bool batch_open_{false};
+  std::chrono::steady_clock::time_point batch_due_{};
+
+  // disk spill (see SpillOptions): frames go to the journal while spill_run_ is set
+  SpillJournal spill_;
+  bool spill_run_{false};
+  timer_type spill_timer_{strand_};
+  bool spill_armed_{false};
+
+  // write-path counters (written on strand_, read from any thread)
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<uint64_t> writes_{0};
+  std::atomic<uint64_t> batches_{0};
+  std::atomic<uint64_t> fragmented_{0};
+  std::atomic<uint64_t> failovers_{0};
+  std::atomic<uint64_t> resolves_{0};
+
+  // handshake: what every connected Kore agreed to (all features while off); set from the
+  // options in the constructor and whenever a connection comes up or goes down
+  std::atomic<uint32_t> peer_features_{0};
+  std::atomic<std::size_t> peer_max_frame_{0};  // smallest limit a connected Kore stated, 0 = none
+  std::atomic<uint64_t> hellos_{0};
+  std::atomic<uint64_t> hello_timeouts_{0};
+
+  // RTT estimate (written on strand_, read from any thread)
+  double srtt_us_{0.0};
+  double rttvar_us_{0.0};
+  uint32_t probe_seq_{0};
+  std::atomic<uint64_t> srtt_stat_{0};
+  std::atomic<uint64_t> rttvar_stat_{0};
+  std::atomic<uint64_t> rtt_samples_{0};
+  std::atomic<uint64_t> dead_peers_{0};
+  std::atomic<uint64_t> shed_overflow_{0};
+  std::atomic<uint64_t> shed_expired_{0};
+  std::atomic<uint64_t> shed_unsupported_{0};
+  std::atomic<uint64_t> shed_bytes_{0};
+  uint64_t shed_logged_at_{0};  // ms; shedding warnings are rate-limited
+
+  // sequencing: streams are (session_, connection id); the session changes with every link
+  uint32_t session_{0};
+  std::atomic<uint64_t> acked_{0};
+  std::atomic<uint64_t> replayed_{0};
+  std::atomic<uint64_t> replay_evicted_{0};
+
+  // flow control counters
+  std::atomic<uint64_t> credit_grants_{0};
+  std::atomic<uint64_t> credit_stalls_{0};
 
-  // send queue (single-threaded by strand_)
-  std::deque<std::vector<std::byte>> send_q_;
-  bool sending_{false};
+  // disk spill counters (written on strand_, read from any thread)
+  std::atomic<uint64_t> spilled_{0};
+  std::atomic<uint64_t> unspilled_{0};
+  std::atomic<uint64_t> spill_bytes_{0};
 
   // callback
   std::function<void(char, std::span<const std::byte>)> on_frame_;
@@ -0,0 +1,305 @@
+#include "infrastructure/link/KoreLink_Shm.hpp"
+
+#include "domain/protocol/Envelope.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace
+{
+constexpr auto kPingEvery = std::chrono::milliseconds(5000);
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+constexpr auto kReopenEvery = std::chrono::milliseconds(500);
+}  // namespace
+
+// -------------------- ctor/dtor --------------------
+KoreLink_Shm::KoreLink_Shm(application::ports::ILogger& log, std::size_t ring_bytes)
+    : log_(log), ring_bytes_(ring_bytes)
+{
+}
+
+KoreLink_Shm::~KoreLink_Shm()
+{
+  close();
+}
+
+std::string KoreLink_Shm::segment_name(uint16_t port)
+{
+  return "ArkanRelay_Shm_" + std::to_string(port);
+}
+
+// -------------------- config setters --------------------
+void KoreLink_Shm::set_candidate_ports(std::vector<uint16_t> ports)
+{
+  ports.erase(std::remove(ports.begin(), ports.end(), 0), ports.end());
+  std::sort(ports.begin(), ports.end());
+  ports.erase(std::unique(ports.begin(), ports.end()), ports.end());
+
+  std::lock_guard<std::mutex> lk(tx_mtx_);
+  candidate_ports_ = std::move(ports);
+}
+
+void KoreLink_Shm::set_options(const arkan::relay::application::ports::LinkOptions& o)
+{
+  std::lock_guard<std::mutex> lk(tx_mtx_);
+  options_ = o;
+}
+
+KoreLink_Shm::Stats KoreLink_Shm::stats() const
+{
+  Stats st;
+  st.frames_written = frames_written_.load(std::memory_order_relaxed);
+  st.bytes_written = bytes_written_.load(std::memory_order_relaxed);
+  st.backlogged = backlogged_.load(std::memory_order_relaxed);
+  st.shed_overflow = shed_overflow_.load(std::memory_order_relaxed);
+  return st;
+}
+
+// -------------------- public API --------------------
+void KoreLink_Shm::connect(const std::string& host, uint16_t port)
+{
+  close();
+
+  host_ = host;
+  port_ = port;
+  peer_seen_ = false;
+  reader_.reset();
+  frags_.reset();
+  running_ = true;
+  pump_thread_ = std::thread([this] { pump(); });
+}
+
+void KoreLink_Shm::close()
+{
+  running_ = false;
+  {
+    std::lock_guard<std::mutex> lk(tx_mtx_);
+    chan_.wake();
+  }
+  if (pump_thread_.joinable()) pump_thread_.join();
+
+  std::lock_guard<std::mutex> lk(tx_mtx_);
+  chan_.close();
+  port_claim_.release();
+  backlog_.clear();
+  backlog_off_ = 0;
+}
+
+void KoreLink_Shm::send_frame(char kind, std::span<const std::byte> payload)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (payload.size() > env::kMaxLogicalFrame)
+  {
+    log_.sock(arkan::relay::application::ports::LogLevel::err,
+              "[KoreLink/shm] send_frame: payload too large, rejecting (max 16 MiB)");
+    return;
+  }
+
+  log_.sockf(arkan::relay::application::ports::LogLevel::debug,
+             "[KoreLink/shm] enqueue kind={} len={}", kind, payload.size());
+
+  if (kind == 'S')
+  {
+    log_.sockf(arkan::relay::application::ports::LogLevel::warn,
+               "[KoreLink/shm] dropping 'S' frame (forwarding SEND to Kore is disabled). len={}",
+               payload.size());
+    return;
+  }
+
+  if (payload.size() <= env::kMaxPayload)
+  {
+    push_frame(make_header(kind, payload.size()), payload);
+    return;
+  }
+
+  // one lock for the whole 'F' run: frames from other threads must not land inside it
+  std::lock_guard<std::mutex> lk(tx_mtx_);
+  env::for_each_fragment(kind, payload,
+                         [this](auto head, auto chunk) { push_locked(head, chunk); });
+}
+
+// -------------------- write path --------------------
+void KoreLink_Shm::push_frame(std::span<const std::byte> header,
+                              std::span<const std::byte> payload)
+{
+  std::lock_guard<std::mutex> lk(tx_mtx_);
+  push_locked(header, payload);
+}
+
+void KoreLink_Shm::push_locked(std::span<const std::byte> header,
+                               std::span<const std::byte> payload)
+{
+  // straight into the shared ring unless older frames are still waiting for space
+  if (backlog_off_ == backlog_.size() && chan_.is_open() && chan_.write(header, payload))
+  {
+    frames_written_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(header.size() + payload.size(), std::memory_order_relaxed);
+    return;
+  }
+
+  const std::size_t len = header.size() + payload.size();
+  const std::size_t max = options_.queue.max_bytes;
+  if (max != 0 && backlog_.size() - backlog_off_ + len > max)
+  {
+    shed_overflow_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  if (backlog_off_ == backlog_.size())
+  {
+    backlog_.clear();
+    backlog_off_ = 0;
+  }
+  backlog_.insert(backlog_.end(), header.begin(), header.end());
+  backlog_.insert(backlog_.end(), payload.begin(), payload.end());
+  backlogged_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool KoreLink_Shm::flush_backlog()
+{
+  bool wrote = false;
+  while (backlog_off_ + 3 <= backlog_.size())
+  {
+    const std::byte* f = backlog_.data() + backlog_off_;
+    const std::size_t len =
+        3 + (std::to_integer<std::size_t>(f[1]) | (std::to_integer<std::size_t>(f[2]) << 8));
+    if (!chan_.write(std::span<const std::byte>(f, len))) break;
+
+    backlog_off_ += len;
+    frames_written_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(len, std::memory_order_relaxed);
+    wrote = true;
+  }
+  if (backlog_off_ == backlog_.size())
+  {
+    backlog_.clear();
+    backlog_off_ = 0;
+  }
+  return wrote;
+}
+
+std::size_t KoreLink_Shm::backlog_front_len() const
+{
+  if (backlog_off_ + 3 > backlog_.size()) return 0;
+  const std::byte* f = backlog_.data() + backlog_off_;
+  return 3 + (std::to_integer<std::size_t>(f[1]) | (std::to_integer<std::size_t>(f[2]) << 8));
+}
+
+// -------------------- pump thread --------------------
+bool KoreLink_Shm::open_channel()
+{
+  std::vector<uint16_t> try_ports = candidate_ports_;
+  if (try_ports.empty() && port_ != 0) try_ports.push_back(port_);
+
+  for (uint16_t p : try_ports)
+  {
+    port_claim_.release();
+    if (!port_claim_.claim(host_, p)) continue;
+
+    const std::string name = segment_name(p);
+    if (chan_.open(name, ShmChannel::Role::relay, ring_bytes_))
+    {
+      char b[192];
+      std::snprintf(b, sizeof(b), "[KoreLink/shm] segment %s open (port claim %u)\n",
+                    name.c_str(), (unsigned)p);
+      log_.sock(arkan::relay::application::ports::LogLevel::info, b);
+      return true;
+    }
+    port_claim_.release();
+  }
+  return false;
+}
+
+void KoreLink_Shm::pump()
+{
+  auto next_ping = std::chrono::steady_clock::now() + kPingEvery;
+
+  while (running_)
+  {
+    if (!chan_.is_open())
+    {
+      bool opened = false;
+      {
+        std::lock_guard<std::mutex> lk(tx_mtx_);
+        opened = open_channel();
+      }
+      if (!opened)
+      {
+        log_.sock(arkan::relay::application::ports::LogLevel::warn,
+                  "[KoreLink/shm] no shared-memory segment could be opened; retrying");
+        const auto until = std::chrono::steady_clock::now() + kReopenEvery;
+        while (running_ && std::chrono::steady_clock::now() < until)
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        continue;
+      }
+    }
+
+    // Kore attach/detach is the shared-memory equivalent of connect/disconnect
+    const bool peer = chan_.peer_attached();
+    if (peer != peer_seen_)
+    {
+      peer_seen_ = peer;
+      log_.sock(arkan::relay::application::ports::LogLevel::info,
+                peer ? "[KoreLink/shm] Kore attached" : "[KoreLink/shm] Kore detached");
+    }
+
+    bool progress = false;
+
+    // Kore -> relay: copy whatever is published and parse every complete frame in place
+    for (;;)
+    {
+      const auto buf = reader_.prepare();
+      const std::size_t n =
+          chan_.read(std::span<std::byte>(static_cast<std::byte*>(buf.data()), buf.size()));
+      if (n == 0) break;
+      reader_.commit(n);
+      progress = true;
+
+      char kind = 0;
+      std::span<const std::byte> payload;
+      while (reader_.next(kind, payload))
+      {
+        log_.sockf(arkan::relay::application::ports::LogLevel::debug,
+                   "[KoreLink/shm] read frame kind={} len={}", static_cast<unsigned char>(kind),
+                   payload.size());
+
+        // 'F' runs are delivered as the one logical frame they carry
+        if (kind == 'F' && !frags_.feed(payload, kind, payload)) continue;
+        if (on_frame_) on_frame_(kind, payload);
+      }
+    }
+
+    // relay -> Kore: frames that did not fit when they were sent
+    std::size_t want_space = 0;
+    {
+      std::lock_guard<std::mutex> lk(tx_mtx_);
+      if (backlog_off_ != backlog_.size()) progress |= flush_backlog();
+      want_space = backlog_front_len();
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_ping)
+    {
+      if (peer) push_frame(make_header('K', 0), {});
+      next_ping = now + kPingEvery;
+    }
+
+    if (!progress) chan_.wait(kIdleWait, want_space);
+  }
+}
+
+// -------------------- framing helpers --------------------
+std::array<std::byte, 3> KoreLink_Shm::make_header(char kind, std::size_t len)
+{
+  const uint16_t L = static_cast<uint16_t>(len);
+  return {std::byte{static_cast<unsigned char>(kind)},
+          std::byte{static_cast<unsigned char>(L & 0xFF)},
+          std::byte{static_cast<unsigned char>((L >> 8) & 0xFF)}};
+}
+
+}  // namespace arkan::relay::infrastructure::link
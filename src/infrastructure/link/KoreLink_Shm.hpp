@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "application/ports/IKoreLink.hpp"
+#include "application/ports/ILogger.hpp"
+#include "infrastructure/link/FragmentAssembler.hpp"
+#include "infrastructure/link/FrameReader.hpp"
+#include "infrastructure/link/ShmChannel.hpp"
+#include "infrastructure/win32/PortClaim.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// KoreLink_Shm
+//  - IKoreLink over a ShmChannel for a Kore running on the same host: frames
+//    skip the loopback TCP stack entirely.
+//  - The segment is named after the claimed Kore port ("ArkanRelay_Shm_<port>"),
+//    so candidate ports and port claims work as with KoreLink_Asio and Kore only
+//    needs the port it already listens on to find its segment.
+//  - send_frame() copies straight into the shared ring from the caller's thread
+//    (serialized by a mutex); frames that do not fit wait in a bounded local
+//    backlog drained by the pump thread as Kore frees space.
+//  - The pump thread parses Kore -> relay frames in place and sends keepalives.
+// -----------------------------------------------------------------------------
+class KoreLink_Shm final : public arkan::relay::application::ports::IKoreLink
+{
+ public:
+  explicit KoreLink_Shm(arkan::relay::application::ports::ILogger& log,
+                        std::size_t ring_bytes = ShmChannel::kDefaultRingBytes);
+  ~KoreLink_Shm() override;
+
+  // IKoreLink
+  void connect(const std::string& host, uint16_t port) override;
+  void close() override;
+  void send_frame(char kind, std::span<const std::byte> payload) override;
+  void on_frame(std::function<void(char, std::span<const std::byte>)> cb) override
+  {
+    on_frame_ = std::move(cb);
+  }
+
+  void set_candidate_ports(std::vector<uint16_t> ports) override;
+  void set_options(const arkan::relay::application::ports::LinkOptions& o) override;
+
+  // Segment name used for a Kore port
+  static std::string segment_name(uint16_t port);
+
+  // Write-path counters (telemetry/benchmarks)
+  struct Stats
+  {
+    uint64_t frames_written{0};
+    uint64_t bytes_written{0};
+    uint64_t backlogged{0};  // frames that had to wait for ring space
+    uint64_t shed_overflow{0};
+  };
+  Stats stats() const;
+
+ private:
+  void pump();
+  bool open_channel();  // tx_mtx_ held
+  void push_frame(std::span<const std::byte> header, std::span<const std::byte> payload);
+  void push_locked(std::span<const std::byte> header,
+                   std::span<const std::byte> payload);  // tx_mtx_ held
+  bool flush_backlog();                  // tx_mtx_ held
+  std::size_t backlog_front_len() const;  // tx_mtx_ held
+
+  static std::array<std::byte, 3> make_header(char kind, std::size_t len);
+
+  application::ports::ILogger& log_;
+  const std::size_t ring_bytes_;
+
+  // PortClaim instance (Win32)
+  arkan::relay::infrastructure::PortClaim port_claim_;
+  std::string host_;
+  uint16_t port_{0};
+  std::vector<uint16_t> candidate_ports_;
+  arkan::relay::application::ports::LinkOptions options_{};
+
+  ShmChannel chan_;
+  std::thread pump_thread_;
+  std::atomic<bool> running_{false};
+  bool peer_seen_{false};  // pump thread only
+
+  // producer side (any thread)
+  std::mutex tx_mtx_;
+  std::vector<std::byte> backlog_;  // encoded frames waiting for ring space
+  std::size_t backlog_off_{0};      // first byte of backlog_ not yet written
+
+  // consumer side (pump thread)
+  FrameReader reader_;
+  FragmentAssembler frags_;
+
+  // counters (read from any thread)
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+  std::atomic<uint64_t> backlogged_{0};
+  std::atomic<uint64_t> shed_overflow_{0};
+
+  // callback
+  std::function<void(char, std::span<const std::byte>)> on_frame_;
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// LatencyHistogram
+//  - Log-linear buckets over microseconds: 8 per power of two, so any
+//    percentile is reported within 12.5% of the true value.
+//  - record() from one thread at a time; count()/percentile() from any thread.
+// -----------------------------------------------------------------------------
+class LatencyHistogram
+{
+ public:
+  void record(uint64_t us)
+  {
+    buckets_[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  // Upper bound of the bucket holding the p-th percentile (0 < p <= 100); 0 when empty
+  uint64_t percentile(double p) const
+  {
+    const uint64_t n = count();
+    if (n == 0) return 0;
+
+    const auto rank = static_cast<uint64_t>(static_cast<double>(n) * p / 100.0 + 0.5);
+    uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+      seen += buckets_[b].load(std::memory_order_relaxed);
+      if (seen >= (rank == 0 ? 1 : rank)) return upper_of(b);
+    }
+    return upper_of(kBuckets - 1);
+  }
+
+ private:
+  static constexpr unsigned kSubBits = 3;
+  static constexpr std::size_t kSub = std::size_t{1} << kSubBits;
+  static constexpr std::size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+  // values below kSub get a bucket each; above, the top kSubBits+1 bits pick the bucket
+  static std::size_t bucket_of(uint64_t v)
+  {
+    if (v < kSub) return static_cast<std::size_t>(v);
+    const unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(v));
+    const unsigned shift = msb - kSubBits;
+    return (shift + 1) * kSub + static_cast<std::size_t>((v >> shift) & (kSub - 1));
+  }
+
+  static uint64_t upper_of(std::size_t b)
+  {
+    if (b < kSub) return b;
+    const unsigned shift = static_cast<unsigned>(b / kSub) - 1;
+    const uint64_t base = (uint64_t{kSub} | (b % kSub)) << shift;
+    return base + ((uint64_t{1} << shift) - 1);
+  }
+
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+  std::atomic<uint64_t> count_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,108 @@
+#include "infrastructure/link/ReplayBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace arkan::relay::infrastructure::link
+{
+
+ReplayBuffer::ReplayBuffer(std::size_t capacity)
+{
+  reset(capacity);
+}
+
+void ReplayBuffer::reset(std::size_t capacity)
+{
+  std::size_t cap = 0;
+  if (capacity != 0)
+  {
+    cap = 1024;
+    while (cap < capacity) cap <<= 1;
+  }
+  buf_.assign(cap, std::byte{0});
+  buf_.shrink_to_fit();
+  mask_ = cap == 0 ? 0 : cap - 1;
+  head_ = tail_ = 0;
+  head_seq_ = next_seq_ = 1;
+  evicted_ = 0;
+}
+
+void ReplayBuffer::append(const SendRing::Gather& g)
+{
+  if (!enabled() || g.frames == 0) return;
+
+  const auto frames = static_cast<uint32_t>(g.frames);
+  if (g.bytes > buf_.size())
+  {
+    // larger than the whole buffer: neither this region nor anything before it can be replayed
+    evicted_ += this->frames() + frames;
+    head_ = tail_;
+    next_seq_ += frames;
+    head_seq_ = next_seq_;
+    return;
+  }
+
+  while (bytes() + g.bytes > buf_.size())
+  {
+    drop_front();
+    ++evicted_;
+  }
+  for (const auto& b : g.bufs)
+  {
+    write_at(tail_, b);
+    tail_ += b.size();
+  }
+  next_seq_ += frames;
+}
+
+std::size_t ReplayBuffer::ack(uint32_t seq)
+{
+  // serial-number comparison: numbers wrap after 2^32 frames
+  std::size_t n = 0;
+  for (; !empty() && static_cast<int32_t>(seq - head_seq_) >= 0; ++n) drop_front();
+  if (empty()) head_ = tail_ = 0;
+  return n;
+}
+
+void ReplayBuffer::clear()
+{
+  head_ = tail_ = 0;
+  head_seq_ = next_seq_;
+}
+
+std::array<boost::asio::const_buffer, 2> ReplayBuffer::buffers() const
+{
+  std::array<boost::asio::const_buffer, 2> out{};
+  if (empty()) return out;
+
+  const std::size_t phys = static_cast<std::size_t>(head_) & mask_;
+  const std::size_t first = (std::min)(bytes(), buf_.size() - phys);
+  out[0] = boost::asio::buffer(buf_.data() + phys, first);
+  if (first < bytes()) out[1] = boost::asio::buffer(buf_.data(), bytes() - first);
+  return out;
+}
+
+void ReplayBuffer::drop_front()
+{
+  head_ += SendRing::kHeaderSize + frame_len_at(head_);
+  ++head_seq_;
+}
+
+void ReplayBuffer::write_at(uint64_t pos, const boost::asio::const_buffer& src)
+{
+  if (src.size() == 0) return;
+  const auto* p = static_cast<const std::byte*>(src.data());
+  const std::size_t phys = static_cast<std::size_t>(pos) & mask_;
+  const std::size_t first = (std::min)(src.size(), buf_.size() - phys);
+  std::memcpy(buf_.data() + phys, p, first);
+  if (first < src.size()) std::memcpy(buf_.data(), p + first, src.size() - first);
+}
+
+uint16_t ReplayBuffer::frame_len_at(uint64_t pos) const
+{
+  const auto lo = std::to_integer<unsigned>(buf_[static_cast<std::size_t>(pos + 1) & mask_]);
+  const auto hi = std::to_integer<unsigned>(buf_[static_cast<std::size_t>(pos + 2) & mask_]);
+  return static_cast<uint16_t>(lo | (hi << 8));
+}
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "infrastructure/link/SendRing.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// ReplayBuffer
+//  - Copies of the frames one connection has written, kept until Kore
+//    acknowledges them ('A' frames) so they can be sent again after a
+//    reconnect.
+//  - Frames are numbered implicitly: the first one appended is 1, each next
+//    one the previous number + 1 (32-bit, wrapping).
+//  - Bounded: when an append does not fit, the oldest frames are evicted
+//    unacknowledged (counted in evicted()); they cannot be replayed.
+//  - Not thread-safe: owned by the link strand.
+// -----------------------------------------------------------------------------
+class ReplayBuffer
+{
+ public:
+  // 0 = off: nothing is kept
+  explicit ReplayBuffer(std::size_t capacity = 0);
+
+  // Resizes the storage (rounded up to a power of two) and forgets every frame kept so far
+  void reset(std::size_t capacity);
+
+  bool enabled() const
+  {
+    return !buf_.empty();
+  }
+
+  // Keeps a copy of a region just written (its frames get the next numbers)
+  void append(const SendRing::Gather& g);
+
+  // Kore processed every frame up to `seq`: drops them, returns how many
+  std::size_t ack(uint32_t seq);
+
+  // Forgets every kept frame unacknowledged (another connection writes them again); numbering
+  // goes on from next_seq()
+  void clear();
+
+  // Number of the oldest frame kept (the one after the last acked frame when nothing was
+  // evicted); equals next_seq() when empty
+  uint32_t first_seq() const
+  {
+    return head_seq_;
+  }
+  uint32_t next_seq() const
+  {
+    return next_seq_;
+  }
+
+  bool empty() const
+  {
+    return head_ == tail_;
+  }
+  std::size_t bytes() const
+  {
+    return static_cast<std::size_t>(tail_ - head_);
+  }
+  std::size_t frames() const
+  {
+    return static_cast<std::size_t>(next_seq_ - head_seq_);
+  }
+  uint64_t evicted() const
+  {
+    return evicted_;
+  }
+
+  // Every kept frame, oldest first (the second buffer is empty unless the range wraps). The
+  // bytes stay valid until the next append() or reset(); ack() never overwrites them.
+  std::array<boost::asio::const_buffer, 2> buffers() const;
+
+ private:
+  void drop_front();
+  void write_at(uint64_t pos, const boost::asio::const_buffer& src);
+  uint16_t frame_len_at(uint64_t pos) const;
+
+  std::vector<std::byte> buf_;
+  std::size_t mask_{0};
+
+  // monotonically increasing byte positions: head_ <= tail_
+  uint64_t head_{0};
+  uint64_t tail_{0};
+
+  uint32_t head_seq_{1};
+  uint32_t next_seq_{1};
+  uint64_t evicted_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::link
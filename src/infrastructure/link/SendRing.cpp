@@ -0,0 +1,393 @@
+#include "infrastructure/link/SendRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "domain/protocol/Envelope.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace
+{
+std::size_t round_pow2(std::size_t v)
+{
+  std::size_t p = 1024;
+  while (p < v) p <<= 1;
+  return p;
+}
+}  // namespace
+
+SendRing::SendRing(std::size_t capacity)
+    : buf_(round_pow2(capacity)), mask_(buf_.size() - 1), stamps_(1024), smask_(1023)
+{
+  regions_.reserve(8);
+}
+
+// -------------------- producer side --------------------
+void SendRing::push(std::span<const std::byte> header, std::span<const std::byte> payload,
+                    uint64_t stamp)
+{
+  const std::size_t need = header.size() + payload.size();
+  if (static_cast<std::size_t>(tail_ - head_) + need > buf_.size()) grow(need);
+  if (static_cast<std::size_t>(ftail_ - fhead_) == stamps_.size()) grow_stamps();
+
+  write_at(tail_, header);
+  write_at(tail_ + header.size(), payload);
+  tail_ += need;
+  stamps_[static_cast<std::size_t>(ftail_++) & smask_] = stamp;
+  ++queued_frames_;
+}
+
+void SendRing::grow_stamps()
+{
+  std::vector<uint64_t> next(stamps_.size() * 2);
+  const std::size_t nmask = next.size() - 1;
+  for (uint64_t f = fhead_; f < ftail_; ++f)
+    next[static_cast<std::size_t>(f) & nmask] = stamps_[static_cast<std::size_t>(f) & smask_];
+  stamps_ = std::move(next);
+  smask_ = nmask;
+}
+
+void SendRing::write_at(uint64_t pos, std::span<const std::byte> src)
+{
+  if (src.empty()) return;
+  const std::size_t phys = static_cast<std::size_t>(pos) & mask_;
+  const std::size_t first = (std::min)(src.size(), buf_.size() - phys);
+  std::memcpy(buf_.data() + phys, src.data(), first);
+  if (first < src.size()) std::memcpy(buf_.data(), src.data() + first, src.size() - first);
+}
+
+void SendRing::read_at(uint64_t pos, std::span<std::byte> dst) const
+{
+  if (dst.empty()) return;
+  const std::size_t phys = static_cast<std::size_t>(pos) & mask_;
+  const std::size_t first = (std::min)(dst.size(), buf_.size() - phys);
+  std::memcpy(dst.data(), buf_.data() + phys, first);
+  if (first < dst.size()) std::memcpy(dst.data() + first, buf_.data(), dst.size() - first);
+}
+
+void SendRing::move_within(uint64_t dst, uint64_t src, std::size_t len)
+{
+  // dst < src: copying forward in contiguous runs never clobbers unread source bytes
+  while (len > 0)
+  {
+    const std::size_t dp = static_cast<std::size_t>(dst) & mask_;
+    const std::size_t sp = static_cast<std::size_t>(src) & mask_;
+    std::size_t run = (std::min)(len, buf_.size() - dp);
+    run = (std::min)(run, buf_.size() - sp);
+    std::memmove(buf_.data() + dp, buf_.data() + sp, run);
+    dst += run;
+    src += run;
+    len -= run;
+  }
+}
+
+void SendRing::grow(std::size_t need)
+{
+  const std::size_t used = static_cast<std::size_t>(tail_ - head_);
+  const std::size_t cap = round_pow2((std::max)(buf_.size() * 2, used + need));
+
+  std::vector<std::byte> next(cap);
+  const std::size_t nmask = cap - 1;
+  for (uint64_t p = head_; p < tail_;)
+  {
+    // copy in runs that are contiguous in both the old and the new storage
+    const std::size_t op = static_cast<std::size_t>(p) & mask_;
+    const std::size_t np = static_cast<std::size_t>(p) & nmask;
+    std::size_t run = static_cast<std::size_t>(tail_ - p);
+    run = (std::min)(run, buf_.size() - op);
+    run = (std::min)(run, cap - np);
+    std::memcpy(next.data() + np, buf_.data() + op, run);
+    p += run;
+  }
+
+  // In-flight writes still point into the old storage; keep it alive until they complete.
+  if (in_flight()) retired_.push_back(std::move(buf_));
+
+  buf_ = std::move(next);
+  mask_ = nmask;
+}
+
+// -------------------- consumer side --------------------
+uint16_t SendRing::frame_len_at(uint64_t pos) const
+{
+  const auto lo = std::to_integer<unsigned>(buf_[static_cast<std::size_t>(pos + 1) & mask_]);
+  const auto hi = std::to_integer<unsigned>(buf_[static_cast<std::size_t>(pos + 2) & mask_]);
+  return static_cast<uint16_t>(lo | (hi << 8));
+}
+
+bool SendRing::continues_run(uint64_t pos) const
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  if (static_cast<char>(std::to_integer<unsigned char>(byte_at(pos))) != env::kFragment ||
+      frame_len_at(pos) < env::kFragmentPrefix)
+    return false;
+  return (std::to_integer<uint8_t>(byte_at(pos + kHeaderSize + 1)) & env::kFragLast) == 0;
+}
+
+char SendRing::carried_kind_at(uint64_t pos) const
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  const char kind = kind_at(pos);
+  if (kind != env::kFragment || frame_len_at(pos) < env::kFragmentPrefix) return kind;
+  return kind_at(pos + kHeaderSize);
+}
+
+SendRing::Gather SendRing::gather(std::size_t max_frames, std::size_t max_bytes,
+                                  std::string_view hold)
+{
+  Gather g;
+  if (empty()) return g;
+
+  uint64_t end = tail_;
+  std::size_t frames = queued_frames_;
+  const bool cut_frames = max_frames != 0 && max_frames < queued_frames_;
+  const bool cut_bytes = max_bytes != 0 && max_bytes < queued_bytes();
+  auto held = [&](uint64_t pos)
+  {
+    return hold.find(kind_at(pos)) != std::string_view::npos ||
+           hold.find(carried_kind_at(pos)) != std::string_view::npos;
+  };
+  if (cut_frames || cut_bytes || !hold.empty())
+  {
+    // walk frame headers to find the cut point; a fragment run is never cut (its pieces must
+    // reach the peer back to back on one connection), even if that overshoots the limits
+    end = send_;
+    bool in_run = false;
+    for (frames = 0; frames < queued_frames_; ++frames)
+    {
+      const std::size_t len = kHeaderSize + frame_len_at(end);
+      if (!in_run)
+      {
+        if (cut_frames && frames >= max_frames) break;
+        if (cut_bytes && static_cast<std::size_t>(end - send_) + len > max_bytes) break;
+        if (!hold.empty() && held(end)) break;
+      }
+      in_run = continues_run(end);
+      end += len;
+    }
+    if (frames == 0) return g;
+  }
+
+  const std::size_t phys = static_cast<std::size_t>(send_) & mask_;
+  const std::size_t total = static_cast<std::size_t>(end - send_);
+  const std::size_t first = (std::min)(total, buf_.size() - phys);
+
+  g.bufs[0] = boost::asio::const_buffer(buf_.data() + phys, first);
+  if (first < total) g.bufs[1] = boost::asio::const_buffer(buf_.data(), total - first);
+  g.bytes = total;
+  g.frames = frames;
+  g.begin = send_;
+
+  regions_.push_back(Region{send_, end, fsend_, fsend_ + frames, false});
+  send_ = end;
+  fsend_ += frames;
+  queued_frames_ -= frames;
+  return g;
+}
+
+void SendRing::consume(const Gather& g)
+{
+  if (g.bytes == 0) return;
+
+  for (auto& r : regions_)
+  {
+    if (r.begin == g.begin)
+    {
+      r.done = true;
+      break;
+    }
+  }
+
+  // reclaim space in ring order: only completed regions at the head can be released
+  std::size_t done = 0;
+  for (; done < regions_.size() && regions_[done].done; ++done)
+  {
+    head_ = regions_[done].end;
+    fhead_ = regions_[done].fend;
+  }
+  regions_.erase(regions_.begin(), regions_.begin() + static_cast<std::ptrdiff_t>(done));
+
+  if (regions_.empty())
+  {
+    // frames dropped between regions were never sent: nothing before send_ is pinned now
+    head_ = send_;
+    fhead_ = fsend_;
+    retired_.clear();
+    // rewind positions when idle so the next burst starts at the beginning of the storage
+    if (head_ == tail_) head_ = send_ = tail_ = 0;
+  }
+}
+
+void SendRing::requeue(const Gather& g)
+{
+  if (g.bytes == 0) return;
+  const auto it = std::find_if(regions_.begin(), regions_.end(),
+                               [&](const Region& r) { return r.begin == g.begin; });
+  if (it == regions_.end()) return;
+
+  if (it->end == send_ && it->fend == fsend_)
+  {
+    // nothing was gathered or dropped after it: the region simply becomes unsent again
+    send_ = it->begin;
+    fsend_ = it->fbegin;
+    queued_frames_ += g.frames;
+    regions_.erase(it);
+    if (regions_.empty())
+    {
+      head_ = send_;
+      fhead_ = fsend_;
+      retired_.clear();
+    }
+    return;
+  }
+
+  // other regions (or dropped frames) sit between it and the queue
+  std::vector<std::byte> bytes(g.bytes);
+  read_at(it->begin, bytes);
+  std::vector<uint64_t> stamps;
+  stamps.reserve(g.frames);
+  for (uint64_t f = it->fbegin; f < it->fend; ++f)
+    stamps.push_back(stamps_[static_cast<std::size_t>(f) & smask_]);
+  prepend(bytes, std::move(stamps));
+  consume(g);
+}
+
+void SendRing::push_front(std::span<const std::byte> frames, uint64_t stamp)
+{
+  std::size_t n = 0;
+  for (std::size_t at = 0; at + kHeaderSize <= frames.size(); ++n)
+  {
+    const auto len = std::to_integer<std::size_t>(frames[at + 1]) |
+                     (std::to_integer<std::size_t>(frames[at + 2]) << 8);
+    at += kHeaderSize + len;
+  }
+  if (n != 0) prepend(frames, std::vector<uint64_t>(n, stamp));
+}
+
+// The unsent frames are written again after the tail, behind `frames`. The space they leave is
+// reclaimed once the regions in flight before it complete.
+void SendRing::prepend(std::span<const std::byte> frames, std::vector<uint64_t> stamps)
+{
+  std::vector<std::byte> bytes(frames.size() + queued_bytes());
+  std::memcpy(bytes.data(), frames.data(), frames.size());
+  read_at(send_, std::span<std::byte>(bytes).subspan(frames.size()));
+  for (uint64_t f = fsend_; f < ftail_; ++f)
+    stamps.push_back(stamps_[static_cast<std::size_t>(f) & smask_]);
+
+  send_ = tail_;
+  fsend_ = ftail_;
+  if (regions_.empty())
+  {
+    head_ = send_;
+    fhead_ = fsend_;
+  }
+  if (static_cast<std::size_t>(tail_ - head_) + bytes.size() > buf_.size()) grow(bytes.size());
+  while (static_cast<std::size_t>(ftail_ - fhead_) + stamps.size() > stamps_.size())
+    grow_stamps();
+
+  write_at(tail_, bytes);
+  tail_ += bytes.size();
+  for (const uint64_t st : stamps) stamps_[static_cast<std::size_t>(ftail_++) & smask_] = st;
+  queued_frames_ = stamps.size();
+}
+
+// -------------------- shedding --------------------
+SendRing::Dropped SendRing::drop_front(std::size_t n)
+{
+  Dropped d;
+  bool in_run = false;
+  while ((d.frames < n || in_run) && !empty())
+  {
+    in_run = continues_run(send_);
+    const std::size_t len = kHeaderSize + frame_len_at(send_);
+    send_ += len;
+    ++fsend_;
+    --queued_frames_;
+    ++d.frames;
+    d.bytes += len;
+  }
+  // nothing in flight: the dropped bytes can be reused right away
+  if (regions_.empty())
+  {
+    head_ = send_;
+    fhead_ = fsend_;
+  }
+  return d;
+}
+
+SendRing::Dropped SendRing::drop_older_than(uint64_t stamp)
+{
+  std::size_t n = 0;
+  for (uint64_t f = fsend_; f < ftail_ && stamps_[static_cast<std::size_t>(f) & smask_] < stamp;
+       ++f)
+    ++n;
+  return n ? drop_front(n) : Dropped{};
+}
+
+SendRing::Dropped SendRing::drop_opcodes(std::span<const uint16_t> opcodes, std::size_t bytes,
+                                         std::size_t frames)
+{
+  Dropped d;
+  if (opcodes.empty() || empty()) return d;
+
+  namespace env = arkan::relay::domain::protocol::envelope;
+
+  // compact the unsent region in place: survivors slide towards send_
+  uint64_t r = send_, w = send_;
+  uint64_t fr = fsend_, fw = fsend_;
+  bool in_run = false, drop_run = false;
+  while (r < tail_)
+  {
+    const std::size_t plen = frame_len_at(r);
+    const std::size_t len = kHeaderSize + plen;
+
+    // the rest of a fragment run shares the fate of its first fragment
+    bool drop = in_run && drop_run;
+    if (!in_run && (d.bytes < bytes || d.frames < frames))
+    {
+      // the packet's opcode: right after the header, or after the prefix of a first fragment
+      char kind = kind_at(r);
+      uint64_t at = r + kHeaderSize;
+      std::size_t avail = plen;
+      if (kind == env::kFragment && plen >= env::kFragmentPrefix)
+      {
+        kind = kind_at(at);
+        at += env::kFragmentPrefix;
+        avail -= env::kFragmentPrefix;
+      }
+      if ((kind == env::kRecv || kind == env::kCompressed) && avail >= 2)
+      {
+        const auto lo = std::to_integer<unsigned>(byte_at(at));
+        const auto hi = std::to_integer<unsigned>(byte_at(at + 1));
+        const auto op = static_cast<uint16_t>(lo | (hi << 8));
+        drop = std::find(opcodes.begin(), opcodes.end(), op) != opcodes.end();
+      }
+    }
+    if (!in_run) drop_run = drop;
+    in_run = continues_run(r);
+
+    if (drop)
+    {
+      ++d.frames;
+      d.bytes += len;
+    }
+    else
+    {
+      if (w != r) move_within(w, r, len);
+      stamps_[static_cast<std::size_t>(fw++) & smask_] =
+          stamps_[static_cast<std::size_t>(fr) & smask_];
+      w += len;
+    }
+    r += len;
+    ++fr;
+  }
+
+  tail_ = w;
+  ftail_ = fw;
+  queued_frames_ -= d.frames;
+  return d;
+}
+
+}  // namespace arkan::relay::infrastructure::link
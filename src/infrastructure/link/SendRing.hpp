@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// SendRing
+//  - Contiguous byte ring holding encoded frames ([kind][len16][payload]) that
+//    are waiting for the socket.
+//  - gather() hands every queued byte to a single (gathered) write; the bytes
+//    stay in place until consume() is called from the write completion.
+//  - Several gathered regions may be in flight at once (one per connection);
+//    they may complete in any order, space is reclaimed in ring order. A
+//    region whose write failed can be put back in front of the queue.
+//  - Capacity is a power of two and doubles on demand; storage pinned by
+//    in-flight writes is kept alive until those writes complete.
+//  - Each queued frame carries a caller-defined stamp (enqueue time) so that
+//    stale or excess frames can be shed before they reach the socket. Only
+//    frames not yet gathered can be dropped.
+//  - Not thread-safe: owned by the link strand.
+// -----------------------------------------------------------------------------
+class SendRing
+{
+ public:
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+  static constexpr std::size_t kHeaderSize = 3;
+
+  // Buffers covering a gathered region (the second one is empty unless it wraps)
+  struct Gather
+  {
+    std::array<boost::asio::const_buffer, 2> bufs{};
+    std::size_t bytes{0};
+    std::size_t frames{0};
+    uint64_t begin{0};  // ring position of the region (identifies it in consume())
+  };
+
+  explicit SendRing(std::size_t capacity = kDefaultCapacity);
+
+  // Frames/bytes removed by one of the drop_*() calls
+  struct Dropped
+  {
+    std::size_t frames{0};
+    std::size_t bytes{0};
+  };
+
+  // Appends one frame: header + payload are stored back to back.
+  void push(std::span<const std::byte> header, std::span<const std::byte> payload,
+            uint64_t stamp = 0);
+
+  // Encoded size of the oldest frame not yet gathered (queue must not be empty)
+  std::size_t front_bytes() const
+  {
+    return kHeaderSize + frame_len_at(send_);
+  }
+
+  // Kind of the oldest frame not yet gathered; for an 'F' run, the kind of the frame it carries
+  // when `carried` is set (queue must not be empty)
+  char front_kind(bool carried = false) const
+  {
+    return carried ? carried_kind_at(send_) : kind_at(send_);
+  }
+
+  // Stamp of the oldest frame not yet gathered (queue must not be empty)
+  uint64_t front_stamp() const
+  {
+    return stamps_[static_cast<std::size_t>(fsend_) & smask_];
+  }
+
+  // Drops up to `n` of the oldest queued frames. A run of 'F' fragments goes whole, so the
+  // count may overshoot `n`: a run cut short would only be thrown away by the peer.
+  Dropped drop_front(std::size_t n);
+
+  // Drops the oldest queued frames whose stamp is below `stamp` (whole runs, as drop_front).
+  Dropped drop_older_than(uint64_t stamp);
+
+  // Drops queued game frames ('R', 'Z', or a fragment run carrying one) whose opcode (first two
+  // bytes of the packet, LE) is listed, oldest first, until at least `bytes` and `frames` have
+  // been released. Other kinds are never dropped; survivors keep their order.
+  Dropped drop_opcodes(std::span<const uint16_t> opcodes, std::size_t bytes, std::size_t frames);
+
+  // Exposes queued frames not yet handed to the socket, whole frames only, up to `max_frames`
+  // frames and `max_bytes` bytes (0 = no limit). Returns an empty Gather (bytes == 0) when
+  // nothing is queued or the first frame does not fit `max_bytes`. A run of 'F' fragments is
+  // taken whole once its first fragment fits. The region also ends before the first frame whose
+  // kind (or, for an 'F' run, carried kind) is in `hold`: those stay queued.
+  Gather gather(std::size_t max_frames = 0, std::size_t max_bytes = 0,
+                std::string_view hold = {});
+
+  // Releases a region returned by gather() (write completed, or failed and not to be resent).
+  void consume(const Gather& g);
+
+  // Puts a region returned by gather() back in front of the queued frames, stamps unchanged:
+  // its write failed, the next gather() hands it out again.
+  void requeue(const Gather& g);
+
+  // Queues encoded frames ([kind][len16][payload] each, back to back) in front of the queued
+  // ones, all with `stamp`: frames that have to be written again, ahead of anything newer.
+  void push_front(std::span<const std::byte> frames, uint64_t stamp);
+
+  bool empty() const
+  {
+    return tail_ == send_;
+  }
+  bool in_flight() const
+  {
+    return !regions_.empty();
+  }
+  std::size_t queued_bytes() const
+  {
+    return static_cast<std::size_t>(tail_ - send_);
+  }
+  std::size_t queued_frames() const
+  {
+    return queued_frames_;
+  }
+  std::size_t capacity() const
+  {
+    return buf_.size();
+  }
+
+ private:
+  void grow(std::size_t need);
+  void write_at(uint64_t pos, std::span<const std::byte> src);
+  void read_at(uint64_t pos, std::span<std::byte> dst) const;
+  void prepend(std::span<const std::byte> frames, std::vector<uint64_t> stamps);
+  void move_within(uint64_t dst, uint64_t src, std::size_t len);
+  std::byte byte_at(uint64_t pos) const
+  {
+    return buf_[static_cast<std::size_t>(pos) & mask_];
+  }
+  uint16_t frame_len_at(uint64_t pos) const;
+  char kind_at(uint64_t pos) const
+  {
+    return static_cast<char>(std::to_integer<unsigned char>(byte_at(pos)));
+  }
+  char carried_kind_at(uint64_t pos) const;  // kind_at, or the kind an 'F' run carries
+  bool continues_run(uint64_t pos) const;  // 'F' fragment that is not the last of its run
+  void grow_stamps();
+
+  struct Region
+  {
+    uint64_t begin;
+    uint64_t end;
+    uint64_t fbegin;  // frame numbers, for the stamps of a requeued region
+    uint64_t fend;
+    bool done;
+  };
+
+  std::vector<std::byte> buf_;
+  std::vector<std::vector<std::byte>> retired_;  // storage pinned by in-flight writes
+  std::size_t mask_{0};
+  std::vector<Region> regions_;  // in-flight regions, in ring order
+
+  // monotonically increasing byte positions: head_ <= send_ <= tail_
+  uint64_t head_{0};  // oldest byte still in flight
+  uint64_t send_{0};  // first byte not yet handed to the socket
+  uint64_t tail_{0};  // next byte to be written
+
+  std::size_t queued_frames_{0};
+
+  // per-frame stamps of queued and in-flight frames, indexed by frame number:
+  // fhead_ <= fsend_ <= ftail_
+  std::vector<uint64_t> stamps_;
+  std::size_t smask_{0};
+  uint64_t fhead_{0};
+  uint64_t fsend_{0};
+  uint64_t ftail_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,339 @@
+#include "infrastructure/link/ShmChannel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#endif
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace
+{
+constexpr uint32_t kInitializing = 1;
+constexpr auto kSpin = std::chrono::microseconds(50);
+
+std::size_t round_pow2(std::size_t v)
+{
+  std::size_t p = ShmChannel::kMinRingBytes;
+  while (p < v) p <<= 1;
+  return p;
+}
+
+std::string event_name(const std::string& name, ShmChannel::Role r)
+{
+  return name + (r == ShmChannel::Role::relay ? ".relay" : ".kore");
+}
+
+// -------------------- platform shims --------------------
+#ifdef _WIN32
+void* map_segment(const std::string& name, std::size_t want, void*& handle, std::size_t& size)
+{
+  HANDLE h = ::CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                  static_cast<DWORD>(want), name.c_str());
+  if (h == nullptr) return nullptr;
+
+  void* p = ::MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (p == nullptr)
+  {
+    ::CloseHandle(h);
+    return nullptr;
+  }
+
+  // an existing section keeps the size chosen by its creator
+  MEMORY_BASIC_INFORMATION mbi{};
+  ::VirtualQuery(p, &mbi, sizeof(mbi));
+  handle = h;
+  size = mbi.RegionSize;
+  return p;
+}
+
+void unmap_segment(void* p, std::size_t, void* handle)
+{
+  if (p) ::UnmapViewOfFile(p);
+  if (handle) ::CloseHandle(static_cast<HANDLE>(handle));
+}
+
+void* open_event(const std::string& name)
+{
+  return ::CreateEventA(nullptr, FALSE, FALSE, name.c_str());  // auto-reset
+}
+
+void close_event(void* ev)
+{
+  if (ev) ::CloseHandle(static_cast<HANDLE>(ev));
+}
+
+void signal_event(void* ev)
+{
+  ::SetEvent(static_cast<HANDLE>(ev));
+}
+
+void wait_event(void* ev, std::chrono::milliseconds timeout)
+{
+  ::WaitForSingleObject(static_cast<HANDLE>(ev), static_cast<DWORD>(timeout.count()));
+}
+#else
+void* map_segment(const std::string& name, std::size_t want, void*& handle, std::size_t& size)
+{
+  const std::string path = "/" + name;
+  const int fd = ::shm_open(path.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0) return nullptr;
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 ||
+      (st.st_size == 0 && ::ftruncate(fd, static_cast<off_t>(want)) != 0) ||
+      ::fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    return nullptr;
+  }
+
+  void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) return nullptr;
+
+  handle = nullptr;
+  size = static_cast<std::size_t>(st.st_size);
+  return p;
+}
+
+void unmap_segment(void* p, std::size_t size, void*)
+{
+  if (p) ::munmap(p, size);
+}
+
+void* open_event(const std::string& name)
+{
+  sem_t* s = ::sem_open(("/" + name).c_str(), O_CREAT, 0600, 0);
+  return s == SEM_FAILED ? nullptr : s;
+}
+
+void close_event(void* ev)
+{
+  if (ev) ::sem_close(static_cast<sem_t*>(ev));
+}
+
+void signal_event(void* ev)
+{
+  ::sem_post(static_cast<sem_t*>(ev));
+}
+
+void wait_event(void* ev, std::chrono::milliseconds timeout)
+{
+  timespec ts{};
+  ::clock_gettime(CLOCK_REALTIME, &ts);
+  const long long ns = ts.tv_nsec + static_cast<long long>(timeout.count()) * 1000000LL;
+  ts.tv_sec += static_cast<time_t>(ns / 1000000000LL);
+  ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+  while (::sem_timedwait(static_cast<sem_t*>(ev), &ts) != 0 && errno == EINTR)
+  {
+  }
+}
+#endif
+}  // namespace
+
+// -------------------- open/close --------------------
+ShmChannel::~ShmChannel()
+{
+  close();
+}
+
+bool ShmChannel::open(const std::string& name, Role role, std::size_t ring_bytes)
+{
+  close();
+
+  const std::size_t ring = round_pow2(ring_bytes);
+  void* map = map_segment(name, sizeof(Header) + 2 * ring, map_handle_, map_bytes_);
+  if (!map) return false;
+
+  base_ = static_cast<std::byte*>(map);
+  hdr_ = reinterpret_cast<Header*>(base_);
+  role_ = role;
+  name_ = name;
+
+  // the first side to get here lays out the segment; the other waits for it
+  uint32_t m = ref(hdr_->magic).load(std::memory_order_acquire);
+  if (m == 0 && ref(hdr_->magic).compare_exchange_strong(m, kInitializing))
+  {
+    hdr_->version = kVersion;
+    hdr_->ring_bytes = static_cast<uint32_t>(ring);
+    ref(hdr_->magic).store(kMagic, std::memory_order_release);
+  }
+  for (int i = 0; i < 1000 && ref(hdr_->magic).load(std::memory_order_acquire) != kMagic; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  ring_bytes_ = hdr_->ring_bytes;
+  mask_ = ring_bytes_ - 1;
+  if (ref(hdr_->magic).load(std::memory_order_acquire) != kMagic ||
+      hdr_->version != kVersion || ring_bytes_ < kMinRingBytes ||
+      (ring_bytes_ & mask_) != 0 || map_bytes_ < sizeof(Header) + 2 * ring_bytes_)
+  {
+    close();
+    return false;
+  }
+
+  own_event_ = open_event(event_name(name, role));
+  peer_event_ =
+      open_event(event_name(name, role == Role::relay ? Role::kore : Role::relay));
+  if (!own_event_ || !peer_event_)
+  {
+    close();
+    return false;
+  }
+
+  // a relay (re)starting without Kore attached drops whatever a previous session left behind
+  const auto self = static_cast<uint32_t>(role_);
+  if (role_ == Role::relay && !peer_attached())
+  {
+    for (auto& r : hdr_->ring)
+    {
+      ref(r.tail.v).store(0);
+      ref(r.head.v).store(0);
+    }
+  }
+  ref(hdr_->sleeping[self]).store(0);
+  ref(hdr_->attached[self]).store(1);
+  return true;
+}
+
+void ShmChannel::close()
+{
+  if (hdr_) ref(hdr_->attached[static_cast<uint32_t>(role_)]).store(0);
+
+  close_event(own_event_);
+  close_event(peer_event_);
+  own_event_ = peer_event_ = nullptr;
+
+  unmap_segment(base_, map_bytes_, map_handle_);
+  base_ = nullptr;
+  hdr_ = nullptr;
+  map_handle_ = nullptr;
+  map_bytes_ = ring_bytes_ = mask_ = 0;
+}
+
+void ShmChannel::remove(const std::string& name)
+{
+#ifdef _WIN32
+  (void)name;
+#else
+  ::shm_unlink(("/" + name).c_str());
+  ::sem_unlink(("/" + event_name(name, Role::relay)).c_str());
+  ::sem_unlink(("/" + event_name(name, Role::kore)).c_str());
+#endif
+}
+
+bool ShmChannel::peer_attached() const
+{
+  return hdr_ && ref(hdr_->attached[1 - static_cast<uint32_t>(role_)]).load() != 0;
+}
+
+// -------------------- producer --------------------
+std::size_t ShmChannel::write_space() const
+{
+  auto& r = tx();
+  const uint32_t tail = ref(r.tail.v).load(std::memory_order_relaxed);
+  const uint32_t head = ref(r.head.v).load(std::memory_order_acquire);
+  return ring_bytes_ - static_cast<uint32_t>(tail - head);
+}
+
+bool ShmChannel::write(std::span<const std::byte> a, std::span<const std::byte> b)
+{
+  const std::size_t need = a.size() + b.size();
+  if (need > write_space()) return false;
+
+  auto& r = tx();
+  const uint32_t tail = ref(r.tail.v).load(std::memory_order_relaxed);
+  std::byte* data = tx_data();
+  std::size_t pos = tail & mask_;
+  for (auto part : {a, b})
+  {
+    const std::size_t first = (std::min)(part.size(), ring_bytes_ - pos);
+    if (first) std::memcpy(data + pos, part.data(), first);
+    if (first < part.size()) std::memcpy(data, part.data() + first, part.size() - first);
+    pos = (pos + part.size()) & mask_;
+  }
+
+  // seq_cst publish pairs with the peer's seq_cst `sleeping` store in wait()
+  ref(r.tail.v).store(tail + static_cast<uint32_t>(need));
+  notify_peer();
+  return true;
+}
+
+// -------------------- consumer --------------------
+bool ShmChannel::readable() const
+{
+  auto& r = rx();
+  return ref(r.tail.v).load(std::memory_order_acquire) !=
+         ref(r.head.v).load(std::memory_order_relaxed);
+}
+
+std::size_t ShmChannel::read(std::span<std::byte> out)
+{
+  auto& r = rx();
+  const uint32_t head = ref(r.head.v).load(std::memory_order_relaxed);
+  const uint32_t tail = ref(r.tail.v).load(std::memory_order_acquire);
+  const std::size_t n = (std::min)(out.size(), static_cast<std::size_t>(tail - head));
+  if (n == 0) return 0;
+
+  const std::byte* data = rx_data();
+  const std::size_t pos = head & mask_;
+  const std::size_t first = (std::min)(n, ring_bytes_ - pos);
+  std::memcpy(out.data(), data + pos, first);
+  if (first < n) std::memcpy(out.data() + first, data, n - first);
+
+  // freed space may be what a sleeping producer waits for
+  ref(r.head.v).store(head + static_cast<uint32_t>(n));
+  notify_peer();
+  return n;
+}
+
+// -------------------- wakeups --------------------
+void ShmChannel::notify_peer()
+{
+  if (ref(hdr_->sleeping[1 - static_cast<uint32_t>(role_)]).load() != 0) signal_event(peer_event_);
+}
+
+void ShmChannel::wait(std::chrono::milliseconds timeout, std::size_t want_space)
+{
+  auto ready = [&] { return readable() || (want_space != 0 && write_space() >= want_space); };
+
+  // bursts usually continue within microseconds: a short spin keeps the peer from paying a
+  // signal per frame
+  const auto spin_until = std::chrono::steady_clock::now() + kSpin;
+  while (!ready())
+  {
+    if (std::chrono::steady_clock::now() >= spin_until) break;
+    std::this_thread::yield();
+  }
+  if (ready()) return;
+
+  auto sleeping = ref(hdr_->sleeping[static_cast<uint32_t>(role_)]);
+  sleeping.store(1);
+
+  // re-check after announcing: a peer that published before seeing the flag did not signal
+  if (!ready()) wait_event(own_event_, timeout);
+
+  sleeping.store(0);
+}
+
+void ShmChannel::wake()
+{
+  if (own_event_) signal_event(own_event_);
+}
+
+}  // namespace arkan::relay::infrastructure::link
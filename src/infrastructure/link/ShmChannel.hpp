@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// ShmChannel
+//  - Duplex byte channel between the relay and Kore on the same host: a named
+//    shared-memory segment holding two single-producer/single-consumer rings
+//    (relay -> Kore, Kore -> relay) plus one named wake event per side.
+//  - Carries the same [kind][len16 LE][payload] stream as the TCP link; write()
+//    publishes whole frames (all or nothing), readers may see any byte count.
+//  - Wakeups are futex-style: a side spins briefly, then sets its `sleeping` flag
+//    before waiting on its event; the peer only signals the event when that flag
+//    is set, so a busy consumer costs no system call.
+//  - Win32: CreateFileMapping + auto-reset events. Elsewhere: shm_open + named
+//    semaphores (used by the tests/benchmarks on POSIX hosts).
+//  - One producer and one consumer per side: callers serialize write()/read().
+//
+// Segment layout (all integers little-endian, positions are free-running u32):
+//   Header   { magic, version, ring_bytes, reserved,
+//              sleeping[2], attached[2],          (index 0 = relay, 1 = Kore)
+//              ring[0] { tail, head }, ring[1] { tail, head } } (64-byte lines)
+//   ring[0] data (relay -> Kore), ring[1] data (Kore -> relay)
+// Wake events: "<name>.relay" (relay waits) and "<name>.kore" (Kore waits).
+// -----------------------------------------------------------------------------
+class ShmChannel
+{
+ public:
+  enum class Role : uint32_t
+  {
+    relay = 0,
+    kore = 1,
+  };
+
+  static constexpr uint32_t kMagic = 0x534B5241u;  // "ARKS"
+  static constexpr uint32_t kVersion = 1;
+  static constexpr std::size_t kDefaultRingBytes = 1u << 20;
+  static constexpr std::size_t kMinRingBytes = 128u * 1024;  // room for two maximum frames
+
+  ShmChannel() = default;
+  ~ShmChannel();
+
+  ShmChannel(const ShmChannel&) = delete;
+  ShmChannel& operator=(const ShmChannel&) = delete;
+
+  // Creates or attaches to `name`. The first side to open sizes the rings (power of two).
+  bool open(const std::string& name, Role role, std::size_t ring_bytes = kDefaultRingBytes);
+  void close();
+
+  bool is_open() const
+  {
+    return hdr_ != nullptr;
+  }
+  bool peer_attached() const;
+
+  // Producer side: appends `a` then `b` as one unit; false (nothing written) if it does not fit.
+  bool write(std::span<const std::byte> a, std::span<const std::byte> b = {});
+  std::size_t write_space() const;
+
+  // Consumer side: copies up to out.size() bytes, returns the count.
+  std::size_t read(std::span<std::byte> out);
+  bool readable() const;
+
+  // Sleeps until the peer produced data, freed space (if `want_space` bytes are awaited) or
+  // wake() was called. Returns immediately when the condition already holds.
+  void wait(std::chrono::milliseconds timeout, std::size_t want_space = 0);
+
+  // Breaks this side's wait() (e.g. shutdown or local work queued)
+  void wake();
+
+  // POSIX: unlinks the named objects (no-op on Win32, where they die with the last handle)
+  static void remove(const std::string& name);
+
+ private:
+  // Plain integers accessed through std::atomic_ref: the memory is shared with another process
+  // and never constructed as C++ objects.
+  struct alignas(64) Index
+  {
+    uint32_t v;
+  };
+  struct RingCtl
+  {
+    Index tail;  // producer position
+    Index head;  // consumer position
+  };
+  struct alignas(64) Header
+  {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_bytes;
+    uint32_t reserved;
+    uint32_t sleeping[2];
+    uint32_t attached[2];
+    RingCtl ring[2];
+  };
+
+  static std::atomic_ref<uint32_t> ref(uint32_t& v)
+  {
+    return std::atomic_ref<uint32_t>(v);
+  }
+
+  RingCtl& tx() const
+  {
+    return hdr_->ring[static_cast<uint32_t>(role_)];
+  }
+  RingCtl& rx() const
+  {
+    return hdr_->ring[1 - static_cast<uint32_t>(role_)];
+  }
+  std::byte* tx_data() const
+  {
+    return base_ + sizeof(Header) + static_cast<std::size_t>(role_) * ring_bytes_;
+  }
+  std::byte* rx_data() const
+  {
+    return base_ + sizeof(Header) + (1 - static_cast<std::size_t>(role_)) * ring_bytes_;
+  }
+  void notify_peer();
+
+  Role role_{Role::relay};
+  Header* hdr_{nullptr};
+  std::byte* base_{nullptr};
+  std::size_t ring_bytes_{0};
+  std::size_t mask_{0};
+  std::size_t map_bytes_{0};
+  std::string name_;
+
+  // platform handles (HANDLE / sem_t* / fd)
+  void* map_handle_{nullptr};
+  void* own_event_{nullptr};
+  void* peer_event_{nullptr};
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,199 @@
+#include "infrastructure/link/SpillJournal.hpp"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstring>
+
+#include "infrastructure/io/MappedFile.hpp"
+
+namespace arkan::relay::infrastructure::link
+{
+
+namespace fs = boost::filesystem;
+using io::map_file;
+using io::unmap_file;
+
+namespace
+{
+constexpr std::size_t kHeaderSize = 3;
+constexpr std::size_t kStampSize = 8;  // after each frame
+
+bool is_segment(const fs::path& p)
+{
+  const std::string name = p.filename().string();
+  return name.size() > 10 && name.compare(0, 6, "spill-") == 0 &&
+         name.compare(name.size() - 4, 4, ".seg") == 0;
+}
+}  // namespace
+
+// -------------------- open/close --------------------
+SpillJournal::~SpillJournal()
+{
+  close();
+}
+
+bool SpillJournal::open(const std::string& dir, std::size_t segment_bytes, std::size_t max_bytes)
+{
+  close();
+  if (dir.empty()) return false;
+
+  boost::system::error_code ec;
+  fs::create_directories(dir, ec);
+  if (!fs::is_directory(dir, ec)) return false;
+
+  // nothing is recovered across runs: frames of a previous session are stale by now
+  for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+  {
+    if (is_segment(it->path())) fs::remove(it->path(), ec);
+  }
+
+  dir_ = dir;
+  segment_bytes_ = (std::max)(segment_bytes, kMinSegmentBytes);
+  max_bytes_ = max_bytes;
+  windex_ = rindex_ = 0;
+  woff_ = roff_ = 0;
+  bytes_ = frames_ = 0;
+  return true;
+}
+
+void SpillJournal::close()
+{
+  if (!is_open()) return;
+
+  // segments between the reader and the writer are not mapped, only on disk
+  unmap(rseg_, rindex_, false);
+  unmap(wseg_, windex_, false);
+  for (uint32_t i = rindex_;; ++i)
+  {
+    boost::system::error_code ec;
+    fs::remove(path_of(i), ec);
+    if (i == windex_) break;
+  }
+
+  dir_.clear();
+  bytes_ = frames_ = 0;
+}
+
+// -------------------- writer --------------------
+bool SpillJournal::append(std::span<const std::byte> head, std::span<const std::byte> rest,
+                          uint64_t stamp)
+{
+  const std::size_t n = head.size() + rest.size() + kStampSize;
+  if (!is_open() || n < kHeaderSize + kStampSize) return false;
+  if (max_bytes_ != 0 && bytes_ + n > max_bytes_) return false;
+
+  if (!wseg_.data)
+  {
+    if (!map(wseg_, windex_, true)) return false;
+    woff_ = 0;
+  }
+  else if (woff_ + n > wseg_.size)
+  {
+    // the rest of this segment stays zero: the reader moves on to the next one there
+    Segment next;
+    if (!map(next, windex_ + 1, true)) return false;
+    if (rindex_ == windex_)
+      rseg_ = wseg_;  // the reader is still on it: hand the mapping over
+    else
+      unmap(wseg_, windex_, false);
+    wseg_ = next;
+    ++windex_;
+    woff_ = 0;
+  }
+
+  std::memcpy(wseg_.data + woff_, head.data(), head.size());
+  if (!rest.empty()) std::memcpy(wseg_.data + woff_ + head.size(), rest.data(), rest.size());
+  std::byte* s = wseg_.data + woff_ + n - kStampSize;
+  for (std::size_t i = 0; i < kStampSize; ++i) s[i] = static_cast<std::byte>(stamp >> (8 * i));
+  woff_ += n;
+  bytes_ += n;
+  ++frames_;
+  return true;
+}
+
+// -------------------- reader --------------------
+std::span<const std::byte> SpillJournal::front() const
+{
+  const std::byte* p = reading().data + roff_;
+  const std::size_t len = std::to_integer<std::size_t>(p[1]) |
+                          (std::to_integer<std::size_t>(p[2]) << 8);
+  return {p, kHeaderSize + len};
+}
+
+uint64_t SpillJournal::front_stamp() const
+{
+  const auto f = front();
+  uint64_t stamp = 0;
+  for (std::size_t i = 0; i < kStampSize; ++i)
+    stamp |= std::to_integer<uint64_t>(f.data()[f.size() + i]) << (8 * i);
+  return stamp;
+}
+
+void SpillJournal::pop()
+{
+  const std::size_t n = front().size() + kStampSize;
+  roff_ += n;
+  bytes_ -= n;
+  --frames_;
+
+  if (frames_ == 0)
+  {
+    // drained: start over in a fresh segment so the disk space goes back right away
+    if (rindex_ != windex_) unmap(rseg_, rindex_, true);
+    unmap(wseg_, windex_, true);
+    rindex_ = ++windex_;
+    roff_ = woff_ = 0;
+    return;
+  }
+  settle();
+}
+
+void SpillJournal::settle()
+{
+  while (rindex_ != windex_)
+  {
+    if (!rseg_.data && !map(rseg_, rindex_, false))
+    {
+      // unreadable segment: its frames are lost, carry on with the next one
+      ++rindex_;
+      roff_ = 0;
+      continue;
+    }
+    if (roff_ + kHeaderSize <= rseg_.size && rseg_.data[roff_] != std::byte{0}) return;
+
+    unmap(rseg_, rindex_, true);
+    ++rindex_;
+    roff_ = 0;
+  }
+
+  // caught up with the writer after losing a segment: what was counted in it is gone
+  if (roff_ >= woff_) bytes_ = frames_ = 0;
+}
+
+// -------------------- segments --------------------
+std::string SpillJournal::path_of(uint32_t index) const
+{
+  char name[32];
+  std::snprintf(name, sizeof(name), "spill-%08x.seg", index);
+  return (fs::path(dir_) / name).string();
+}
+
+bool SpillJournal::map(Segment& s, uint32_t index, bool create)
+{
+  s.data = map_file(path_of(index), segment_bytes_, create, s.handle);
+  s.size = s.data ? segment_bytes_ : 0;
+  return s.data != nullptr;
+}
+
+void SpillJournal::unmap(Segment& s, uint32_t index, bool remove)
+{
+  unmap_file(s.data, s.size, s.handle);
+  s = {};
+  if (!remove) return;
+
+  boost::system::error_code ec;
+  fs::remove(path_of(index), ec);
+}
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace arkan::relay::infrastructure::link
+{
+
+// -----------------------------------------------------------------------------
+// SpillJournal
+//  - FIFO of encoded frames ([kind][len16 LE][payload]) on disk, for frames the
+//    send queue has no room for during a long Kore outage. Each record is the
+//    frame followed by the stamp it was first queued with ([stamp64 LE]), so the
+//    queue TTL still counts from then once it is read back.
+//  - Frames are appended to memory-mapped segment files (<dir>/spill-NNNNNNNN.seg,
+//    `segment_bytes` each) and read back in the same order; a segment is deleted
+//    once read. A frame never straddles two segments: a kind byte of 0 (the file
+//    is zero-filled) ends the data of a segment.
+//  - At most two segments are mapped at once (the one written and the one read),
+//    so memory stays bounded however long the outage; `max_bytes` bounds the disk.
+//  - Scratch storage: open() deletes segments left by an earlier run, close()
+//    deletes the journal's own.
+//  - Segments are mapped with io::map_file (CreateFileMapping on Win32).
+//  - Not thread-safe: owned by the link strand.
+// -----------------------------------------------------------------------------
+class SpillJournal
+{
+ public:
+  static constexpr std::size_t kMinSegmentBytes = 144u * 1024;  // room for two maximum frames
+  static constexpr std::size_t kDefaultSegmentBytes = 16u << 20;
+
+  SpillJournal() = default;
+  ~SpillJournal();
+
+  SpillJournal(const SpillJournal&) = delete;
+  SpillJournal& operator=(const SpillJournal&) = delete;
+
+  // Creates `dir` if needed. max_bytes = 0: bounded by the disk only.
+  bool open(const std::string& dir, std::size_t segment_bytes = kDefaultSegmentBytes,
+            std::size_t max_bytes = 0);
+  void close();
+
+  bool is_open() const
+  {
+    return !dir_.empty();
+  }
+
+  // Appends one frame (`head` + `rest` back to back) stamped `stamp`; false if the journal is
+  // full or the segment could not be created
+  bool append(std::span<const std::byte> head, std::span<const std::byte> rest = {},
+              uint64_t stamp = 0);
+
+  // Oldest frame and its stamp (journal must not be empty); valid until pop()
+  std::span<const std::byte> front() const;
+  uint64_t front_stamp() const;
+  void pop();
+
+  bool empty() const
+  {
+    return frames_ == 0;
+  }
+  std::size_t bytes() const
+  {
+    return bytes_;
+  }
+  std::size_t frames() const
+  {
+    return frames_;
+  }
+
+ private:
+  struct Segment
+  {
+    std::byte* data{nullptr};
+    std::size_t size{0};
+    void* handle{nullptr};  // mapping HANDLE (Win32)
+  };
+
+  bool map(Segment& s, uint32_t index, bool create);
+  void unmap(Segment& s, uint32_t index, bool remove);
+  std::string path_of(uint32_t index) const;
+  const Segment& reading() const
+  {
+    return rindex_ == windex_ ? wseg_ : rseg_;
+  }
+  void settle();  // moves the reader past finished segments
+
+  std::string dir_;
+  std::size_t segment_bytes_{0};
+  std::size_t max_bytes_{0};
+
+  Segment wseg_;  // segment windex_, being appended to
+  Segment rseg_;  // segment rindex_ while the reader is behind the writer
+  uint32_t windex_{0};
+  uint32_t rindex_{0};
+  std::size_t woff_{0};
+  std::size_t roff_{0};
+
+  std::size_t bytes_{0};
+  std::size_t frames_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::link
@@ -0,0 +1,294 @@
+#include "infrastructure/logging/FlightRecorder.hpp"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+#include "shared/hex/Hex.hpp"
+
+namespace arkan::relay::infrastructure::logging
+{
+
+using arkan::relay::application::ports::FlightEvent;
+
+namespace
+{
+constexpr std::size_t kRowBytes = 32;  // hex bytes per dump line
+
+uint64_t now_us()
+{
+  using namespace std::chrono;
+  return static_cast<uint64_t>(
+      duration_cast<microseconds>(system_clock::now().time_since_epoch()).count());
+}
+
+std::tm local_tm(uint64_t time_us)
+{
+  const auto secs = static_cast<std::time_t>(time_us / 1000000);
+  std::tm tm{};
+#ifdef _WIN32
+  localtime_s(&tm, &secs);
+#else
+  localtime_r(&secs, &tm);
+#endif
+  return tm;
+}
+
+const char* label_of(uint8_t event)
+{
+  switch (static_cast<FlightEvent>(event))
+  {
+    case FlightEvent::send:
+      return "SEND";
+    case FlightEvent::recv:
+      return "RECV";
+    case FlightEvent::inject_send:
+      return "INJECT-SEND";
+    case FlightEvent::inject_recv:
+      return "INJECT-RECV";
+    case FlightEvent::state:
+      return "STATE";
+    case FlightEvent::note:
+      return "NOTE";
+  }
+  return "?";
+}
+
+bool is_text(uint8_t event)
+{
+  return event == static_cast<uint8_t>(FlightEvent::state) ||
+         event == static_cast<uint8_t>(FlightEvent::note);
+}
+
+std::FILE* open_out(const char* path)
+{
+#ifdef _WIN32
+  std::FILE* f = nullptr;
+  return fopen_s(&f, path, "wb") == 0 ? f : nullptr;
+#else
+  return std::fopen(path, "wb");
+#endif
+}
+}  // namespace
+
+// -------------------- construction --------------------
+FlightRecorder::FlightRecorder(std::size_t max_bytes, uint32_t seconds, std::string dir)
+    : seconds_(seconds), dir_(std::move(dir))
+{
+  std::size_t n = kMinBytes / kSlotBytes;
+  while (n * 2 * kSlotBytes <= max_bytes) n <<= 1;
+  slots_ = std::make_unique<Slot[]>(n);
+  mask_ = n - 1;
+
+  // an entry never takes more than a quarter of the ring, so it cannot overwrite itself
+  max_entry_ = (std::min)(kMaxEntryBytes, n / 4 * kSlotData - sizeof(Head));
+
+  if (!dir_.empty())
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir_, ec);
+  }
+}
+
+// -------------------- writer --------------------
+void FlightRecorder::record(FlightEvent e, std::span<const std::byte> bytes)
+{
+  const std::size_t stored = (std::min)(bytes.size(), max_entry_);
+  const std::size_t n = slots_for(stored);
+  const uint64_t first = head_.fetch_add(n, std::memory_order_relaxed);
+
+  for (std::size_t i = 0; i < n; ++i)
+    slot(first + i).seq.store(busy(first + i), std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Head h{};
+  h.time_us = now_us();
+  h.length = static_cast<uint32_t>((std::min)(bytes.size(), std::size_t{UINT32_MAX}));
+  h.stored = static_cast<uint32_t>(stored);
+  h.event = static_cast<uint8_t>(e);
+
+  // the head then the bytes, as one stream over the slots
+  const std::byte* src = bytes.data();
+  std::size_t left = stored;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    std::byte* dst = slot(first + i).data;
+    std::size_t room = kSlotData;
+    if (i == 0)
+    {
+      std::memcpy(dst, &h, sizeof(h));
+      dst += sizeof(h);
+      room -= sizeof(h);
+    }
+    const std::size_t take = (std::min)(room, left);
+    if (take) std::memcpy(dst, src, take);
+    src += take;
+    left -= take;
+  }
+
+  for (std::size_t i = 0; i < n; ++i)
+    slot(first + i).seq.store(done(first + i, i == 0), std::memory_order_release);
+  entries_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// -------------------- dump --------------------
+bool FlightRecorder::load(uint64_t index, bool first, std::byte* out) const
+{
+  const Slot& s = slot(index);
+  const uint64_t want = done(index, first);
+  if (s.seq.load(std::memory_order_acquire) != want) return false;
+  std::memcpy(out, s.data, kSlotData);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return s.seq.load(std::memory_order_relaxed) == want;
+}
+
+bool FlightRecorder::dump(const char* reason)
+{
+  if (dir_.empty()) return false;
+
+  // the reason goes into the file name: keep it short and plain
+  char tag[24];
+  std::size_t t = 0;
+  for (const char* p = reason ? reason : ""; *p && t + 1 < sizeof(tag); ++p)
+  {
+    const char c = *p;
+    const bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+    tag[t++] = plain ? c : '_';
+  }
+  tag[t] = '\0';
+
+  const uint64_t now = now_us();
+  const std::tm tm = local_tm(now);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+  char path[512];
+  const int n = std::snprintf(path, sizeof(path), "%s/flight-%s-%03u-%s.txt", dir_.c_str(), stamp,
+                              static_cast<unsigned>((now / 1000) % 1000), t ? tag : "manual");
+  if (n <= 0 || static_cast<std::size_t>(n) >= sizeof(path)) return false;
+  return dump_to(path, reason);
+}
+
+bool FlightRecorder::dump_to(const char* path, const char* reason)
+{
+  std::FILE* f = open_out(path);
+  if (!f) return false;
+
+  const uint64_t end = head_.load(std::memory_order_acquire);
+  const uint64_t ring = mask_ + 1;
+  const uint64_t now = now_us();
+  const uint64_t window = uint64_t{seconds_} * 1000000;
+  const uint64_t cutoff = (window && now > window) ? now - window : 0;
+
+  std::fprintf(f, "# arkan-relay flight recorder: reason=%s, %llu entries recorded, ring %zu KiB",
+               reason ? reason : "", static_cast<unsigned long long>(entries()),
+               capacity() / 1024);
+  if (seconds_) std::fprintf(f, ", last %u s", seconds_);
+  std::fputc('\n', f);
+
+  // oldest slot still in memory: it may be in the middle of an entry, or be overwritten
+  // while we read; such slots are skipped one by one until the start of an entry
+  std::byte first[kSlotData];
+  std::size_t written = 0;
+  for (uint64_t i = end > ring ? end - ring : 0; i < end;)
+  {
+    if (!load(i, true, first))
+    {
+      ++i;
+      continue;
+    }
+    Head h;
+    std::memcpy(&h, first, sizeof(h));
+    if (h.stored > max_entry_)
+    {
+      ++i;
+      continue;
+    }
+    const std::size_t nslots = slots_for(h.stored);
+    if (h.time_us >= cutoff)
+    {
+      write(f, h, first, i, nslots);
+      ++written;
+    }
+    i += nslots;
+  }
+
+  std::fprintf(f, "# %zu entries\n", written);
+  return std::fclose(f) == 0;
+}
+
+void FlightRecorder::write(std::FILE* f, const Head& h, const std::byte* first, uint64_t index,
+                           std::size_t nslots) const
+{
+  const std::tm tm = local_tm(h.time_us);
+  char stamp[48];
+  const std::size_t sn = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+  std::snprintf(stamp + sn, sizeof(stamp) - sn, ".%06u",
+                static_cast<unsigned>(h.time_us % 1000000));
+
+  const bool text = is_text(h.event);
+  if (text)
+    std::fprintf(f, "%s %-11s ", stamp, label_of(h.event));
+  else
+    std::fprintf(f, "%s %-11s %u bytes%s\n", stamp, label_of(h.event), h.length,
+                 h.stored < h.length ? " (cut)" : "");
+
+  std::byte row[kRowBytes];
+  std::size_t rn = 0;
+  char line[2 + kRowBytes * 3 + 1];
+  const auto flush_row = [&]
+  {
+    line[0] = line[1] = ' ';
+    std::size_t ln = 2 + shared::hex::encode(std::span<const std::byte>(row, rn), line + 2);
+    line[ln - 1] = '\n';  // in place of the last byte's space
+    std::fwrite(line, 1, ln, f);
+    rn = 0;
+  };
+
+  std::byte chunk[kSlotData];
+  std::size_t left = h.stored;
+  bool torn = false;
+  for (std::size_t s = 0; s < nslots && left; ++s)
+  {
+    const std::byte* p = chunk;
+    std::size_t take = (std::min)(left, kSlotData);
+    if (s == 0)
+    {
+      p = first + sizeof(Head);
+      take = (std::min)(left, kSlotData - sizeof(Head));
+    }
+    else if (!load(index + s, false, chunk))
+    {
+      torn = true;
+      break;
+    }
+    left -= take;
+
+    if (text)
+    {
+      std::fwrite(p, 1, take, f);
+      continue;
+    }
+    while (take)
+    {
+      const std::size_t k = (std::min)(take, kRowBytes - rn);
+      std::memcpy(row + rn, p, k);
+      rn += k;
+      p += k;
+      take -= k;
+      if (rn == kRowBytes) flush_row();
+    }
+  }
+
+  if (text)
+  {
+    std::fputs(torn ? " ...(overwritten)\n" : "\n", f);
+    return;
+  }
+  if (rn) flush_row();
+  if (torn) std::fputs("  ...(overwritten while dumping)\n", f);
+}
+
+}  // namespace arkan::relay::infrastructure::logging
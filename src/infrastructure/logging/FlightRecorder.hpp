@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "application/ports/IFlightRecorder.hpp"
+
+namespace arkan::relay::infrastructure::logging
+{
+
+// -----------------------------------------------------------------------------
+// FlightRecorder
+//  - Always-on memory of the last packets both ways, injected frames and
+//    checksum state transitions, for post-mortems of desyncs and crashes:
+//    nothing is written anywhere until dump() is called.
+//  - A fixed ring of 64-byte slots, allocated once. record() claims the slots
+//    an entry needs with one fetch_add and copies into them, so any number of
+//    threads record without locks; the oldest entries are simply overwritten.
+//  - Each slot carries a sequence word (seqlock style) telling which entry
+//    index it holds and whether the copy is finished: a dump running while
+//    producers overwrite the ring skips torn entries instead of printing them.
+//  - dump() writes a text file (<dir>/flight-<date>-<time>-<reason>.txt) of
+//    the entries still in memory and younger than `seconds`, oldest first. It
+//    uses stack buffers and stdio only, so it may run inside a crash handler.
+// -----------------------------------------------------------------------------
+class FlightRecorder final : public arkan::relay::application::ports::IFlightRecorder
+{
+ public:
+  using FlightEvent = arkan::relay::application::ports::FlightEvent;
+
+  static constexpr std::size_t kSlotBytes = 64;
+  static constexpr std::size_t kMinBytes = 64u * 1024;
+  static constexpr std::size_t kMaxEntryBytes = 64u * 1024;  // longer entries are cut
+
+  // `max_bytes` of memory (rounded down to a power of two of slots, at least kMinBytes);
+  // seconds = 0: dumps hold whatever is still in memory. Creates `dir` if needed.
+  FlightRecorder(std::size_t max_bytes, uint32_t seconds, std::string dir);
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  void record(FlightEvent e, std::span<const std::byte> bytes) override;
+  bool dump(const char* reason) override;
+
+  // Same as dump(), into `path`
+  bool dump_to(const char* path, const char* reason);
+
+  std::size_t capacity() const
+  {
+    return (mask_ + 1) * kSlotBytes;
+  }
+  uint64_t entries() const
+  {
+    return entries_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::size_t kSlotData = kSlotBytes - sizeof(uint64_t);
+
+  struct alignas(kSlotBytes) Slot
+  {
+    std::atomic<uint64_t> seq{0};
+    std::byte data[kSlotData];
+  };
+
+  // Start of every entry, followed by its bytes; both spread over consecutive slots
+  struct Head
+  {
+    uint64_t time_us;  // system clock, microseconds since the epoch
+    uint32_t length;   // size of what was recorded
+    uint32_t stored;   // bytes kept (length cut to kMaxEntryBytes)
+    uint8_t event;
+    uint8_t pad[7];
+  };
+
+  static std::size_t slots_for(std::size_t stored)
+  {
+    return (sizeof(Head) + stored + kSlotData - 1) / kSlotData;
+  }
+
+  // Sequence word of a slot once entry slot `index` is in it: bit 1 = copy finished,
+  // bit 0 = first slot of its entry
+  static uint64_t busy(uint64_t index)
+  {
+    return index << 2;
+  }
+  static uint64_t done(uint64_t index, bool first)
+  {
+    return (index << 2) | 2u | (first ? 1u : 0u);
+  }
+
+  Slot& slot(uint64_t index) const
+  {
+    return slots_[index & mask_];
+  }
+
+  // Copies the data of slot `index` out; false if it does not (or no longer) hold that slot
+  bool load(uint64_t index, bool first, std::byte* out) const;
+  // One entry; `first` is its first slot, already loaded
+  void write(std::FILE* f, const Head& h, const std::byte* first, uint64_t index,
+             std::size_t nslots) const;
+
+  std::unique_ptr<Slot[]> slots_;
+  std::size_t mask_{0};
+  std::size_t max_entry_{0};
+  uint32_t seconds_{0};
+  std::string dir_;
+
+  alignas(64) std::atomic<uint64_t> head_{0};  // next free slot index
+  std::atomic<uint64_t> entries_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::logging
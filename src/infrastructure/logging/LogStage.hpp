@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "application/ports/LogRecord.hpp"
+
+namespace arkan::relay::infrastructure::logging
+{
+
+// -----------------------------------------------------------------------------
+// LogStage
+//  - Single-producer/single-consumer ring of deferred log records: one per
+//    logging thread, drained by the logger's formatter thread.
+//  - push() never waits: a full stage drops the record and counts it.
+//  - Capacity is rounded up to a power of two; storage is allocated once.
+// -----------------------------------------------------------------------------
+class LogStage
+{
+ public:
+  using LogRecord = arkan::relay::application::ports::LogRecord;
+
+  explicit LogStage(std::size_t capacity)
+  {
+    std::size_t n = 2;
+    while (n < capacity) n <<= 1;
+    slots_.resize(n);
+    mask_ = n - 1;
+  }
+
+  // Producer side
+  bool push(const LogRecord& r)
+  {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) > mask_)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    slots_[tail & mask_] = r;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool pop(LogRecord& out)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    out = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint64_t dropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::vector<LogRecord> slots_;
+  std::size_t mask_{0};
+
+  // producer and consumer indexes on separate cache lines
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::logging
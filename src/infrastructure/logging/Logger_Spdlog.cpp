@@ -18,7 +18,9 @@
 #include <spdlog/spdlog.h>
 
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <system_error>
 #include <vector>
 
@@ -28,6 +30,13 @@ using arkan::relay::application::ports::LogLevel;
 namespace arkan::relay::infrastructure::logging
 {
 
+namespace
+{
+// sampling sites of binary packet records (text packet lines sample on their format string)
+constexpr char kSendPacketSite[] = "packet send";
+constexpr char kRecvPacketSite[] = "packet recv";
+}  // namespace
+
 // -------------------------------------------------------------------------------------------------
 // map_level
 //  - Converts our app-level enum (ports::LogLevel) to spdlog's native level enum.
@@ -118,7 +127,8 @@ void Logger_Spdlog::init(const arkan::relay::domain::Settings& s)
   boost::system::error_code ec;
   fs::create_directories(dir, ec);
 
-  // Re-init safety: drop old named loggers if they exist
+  // Re-init safety: drop old named loggers if they exist (deferred lines go to the old ones first)
+  stop_formatter();
   if (auto prev = spdlog::get("app")) spdlog::drop(prev->name());
   if (auto prev = spdlog::get("socket")) spdlog::drop(prev->name());
 
@@ -177,10 +187,10 @@ void Logger_Spdlog::init(const arkan::relay::domain::Settings& s)
     }
     app_ = std::make_shared<spdlog::async_logger>("app", app_sinks.begin(), app_sinks.end(),
                                                   spdlog::thread_pool(),
-                                                  spdlog::async_overflow_policy::block);
+                                                  spdlog::async_overflow_policy::overrun_oldest);
     sock_ = std::make_shared<spdlog::async_logger>("socket", sock_sinks.begin(), sock_sinks.end(),
                                                    spdlog::thread_pool(),
-                                                   spdlog::async_overflow_policy::block);
+                                                   spdlog::async_overflow_policy::overrun_oldest);
     spdlog::register_logger(app_);
     spdlog::register_logger(sock_);
   }
@@ -205,6 +215,31 @@ void Logger_Spdlog::init(const arkan::relay::domain::Settings& s)
   app_->flush_on(spdlog::level::err);
   sock_->flush_on(spdlog::level::err);
   spdlog::flush_every(std::chrono::seconds(2));
+
+  // Binary packet records next to the text socket log (<stem>-NNNNNNNN.pkt)
+  packets_.close();
+  if (s.socketLogFormat == "binary" && !packets_.open(dir.string(), sockPath.stem().string()))
+    sock_->warn("binary socket log unavailable in {}; packets are logged as text", dir.string());
+
+  // Deferred socket lines: threads keep the stages they registered (other threads may be pushing
+  // to them right now); whatever is still staged goes to the new loggers
+  sample_every_ = (std::max)(s.socketSampleEvery, uint32_t{1});
+  rate_limit_ = s.socketRateLimit;
+  unstaged_ = 0;
+  rate_limited_ = 0;
+  sampled_out_ = 0;
+  if (id_.load(std::memory_order_relaxed) == 0)
+    id_.store(next_logger_id_.fetch_add(1, std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+  defer_stop_ = false;
+  format_thread_ = std::thread([this] { format_loop(); });
+}
+
+Logger_Spdlog::~Logger_Spdlog()
+{
+  // lines still queued are handed to spdlog, then flushed
+  stop_formatter();
+  if (sock_) sock_->flush();
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -228,8 +263,283 @@ void Logger_Spdlog::sock(LogLevel level, std::string_view msg)
 }
 
 // -------------------------------------------------------------------------------------------------
-// set_level(level)
-//  - Adjusts the global level of both loggers at runtime (trace/debug/info/...).
+// enabled(level)
+//  - One atomic load: callers skip building socket lines the logger would discard.
+// -------------------------------------------------------------------------------------------------
+bool Logger_Spdlog::enabled(LogLevel level) const
+{
+  return sock_ && sock_->should_log(map_level(level));
+}
+
+// -------------------------------------------------------------------------------------------------
+// sock_deferred(record)
+//  - Copies the record into the calling thread's stage: no lock, no allocation, no formatting,
+//    never waits (a full stage drops the line and counts it).
+//  - The record keeps its capture time, so lines are stamped when they happened.
+// -------------------------------------------------------------------------------------------------
+void Logger_Spdlog::sock_deferred(const arkan::relay::application::ports::LogRecord& r)
+{
+  uint32_t suppressed = 0;
+  if (!admit(r.fmt, r.level, r.time, suppressed)) return;
+
+  LogStage* st = stage();
+  if (!st)
+  {
+    unstaged_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (suppressed == 0)
+  {
+    st->push(r);
+    return;
+  }
+  auto copy = r;
+  copy.suppressed = suppressed;
+  st->push(copy);
+}
+
+// -------------------------------------------------------------------------------------------------
+// stage()
+//  - The calling thread's stage; registered (under the pool lock, once per thread and logger) on
+//    first use, reusing the stage of a thread that exited when there is one.
+//  - nullptr while kMaxStages live threads have one; the thread tries again on its next line.
+//  - A thread that exits (or moves on to another logger) hands its stage back; records it left
+//    there are still drained.
+// -------------------------------------------------------------------------------------------------
+LogStage* Logger_Spdlog::stage()
+{
+  struct Cached
+  {
+    uint64_t owner{0};
+    LogStage* stage{nullptr};
+    std::weak_ptr<StagePool> pool;  // expired once the logger is gone: nothing to hand back
+
+    ~Cached()
+    {
+      release();
+    }
+    void release()
+    {
+      if (auto p = pool.lock())
+      {
+        std::lock_guard<std::mutex> lk(p->m);
+        p->free.push_back(stage);
+      }
+      owner = 0;
+      stage = nullptr;
+      pool.reset();
+    }
+  };
+  thread_local Cached tls;
+  const uint64_t id = id_.load(std::memory_order_acquire);
+  if (id == 0) return nullptr;
+  if (tls.owner == id) return tls.stage;
+  tls.release();
+
+  std::lock_guard<std::mutex> lk(pool_->m);
+  LogStage* st = nullptr;
+  if (!pool_->free.empty())
+  {
+    st = pool_->free.back();
+    pool_->free.pop_back();
+  }
+  else if (pool_->stages.size() < kMaxStages)
+  {
+    pool_->stages.push_back(std::make_unique<LogStage>(kStageSlots));
+    st = pool_->stages.back().get();
+  }
+  if (st)
+  {
+    tls.owner = id;
+    tls.stage = st;
+    tls.pool = pool_;
+  }
+  return st;
+}
+
+// -------------------------------------------------------------------------------------------------
+// admit(site, level, time, suppressed)
+//  - Per message site (the format string's address): info and below are sampled 1 in
+//    sample_every_, warn and above are limited to rate_limit_ lines per second. A line let through
+//    after a rate-limited stretch reports how many were suppressed.
+//  - Lock-free and approximate under races: sites are a small open-addressed table of atomics;
+//    a site that finds no slot is never limited.
+// -------------------------------------------------------------------------------------------------
+bool Logger_Spdlog::admit(const char* site, LogLevel level,
+                          std::chrono::system_clock::time_point time, uint32_t& suppressed)
+{
+  const bool sampled = level <= LogLevel::info && sample_every_ > 1;
+  const bool limited = level >= LogLevel::warn && rate_limit_ > 0;
+  if (!sampled && !limited) return true;
+
+  Site* e = nullptr;
+  const auto h = static_cast<std::size_t>(reinterpret_cast<uintptr_t>(site) >> 3);
+  for (std::size_t i = 0; i < 8 && !e; ++i)
+  {
+    Site& c = sites_[(h + i) % kSites];
+    const char* k = c.key.load(std::memory_order_acquire);
+    if (k == nullptr && c.key.compare_exchange_strong(k, site, std::memory_order_acq_rel))
+      k = site;
+    if (k == site) e = &c;
+  }
+  if (!e) return true;
+
+  if (sampled)
+  {
+    if (e->seen.fetch_add(1, std::memory_order_relaxed) % sample_every_ == 0) return true;
+    sampled_out_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const int64_t sec =
+      std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+  int64_t w = e->window.load(std::memory_order_relaxed);
+  if (w != sec && e->window.compare_exchange_strong(w, sec, std::memory_order_relaxed))
+    e->in_window.store(0, std::memory_order_relaxed);
+  if (e->in_window.fetch_add(1, std::memory_order_relaxed) >= rate_limit_)
+  {
+    e->suppressed.fetch_add(1, std::memory_order_relaxed);
+    rate_limited_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  suppressed = e->suppressed.exchange(0, std::memory_order_relaxed);
+  return true;
+}
+
+Logger_Spdlog::Stats Logger_Spdlog::stats() const
+{
+  Stats st;
+  st.staged_dropped = unstaged_.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lk(pool_->m);
+    for (const auto& s : pool_->stages) st.staged_dropped += s->dropped();
+  }
+  if (auto tp = spdlog::thread_pool()) st.overrun = tp->overrun_counter();
+  st.rate_limited = rate_limited_.load(std::memory_order_relaxed);
+  st.sampled_out = sampled_out_.load(std::memory_order_relaxed);
+  return st;
+}
+
+// -------------------------------------------------------------------------------------------------
+// sock_packet(dir, socket, bytes)
+//  - Binary mode: one fixed-size record, no formatting; same level gate as the text line.
+// -------------------------------------------------------------------------------------------------
+void Logger_Spdlog::sock_packet(arkan::relay::application::ports::PacketDir dir, uint64_t socket,
+                                std::span<const std::byte> bytes)
+{
+  if (!packets_.is_open())
+  {
+    ILogger::sock_packet(dir, socket, bytes);
+    return;
+  }
+  if (!enabled(LogLevel::info)) return;
+
+  uint32_t suppressed = 0;
+  const char* site =
+      dir == arkan::relay::application::ports::PacketDir::send ? kSendPacketSite : kRecvPacketSite;
+  if (!admit(site, LogLevel::info, std::chrono::system_clock::time_point{}, suppressed)) return;
+  packets_.append(static_cast<char>(dir), socket, bytes);
+}
+
+// -------------------------------------------------------------------------------------------------
+// format_loop / stop_formatter
+//  - Producers never signal: the formatter drains every stage, then sleeps kDrainIdle when they
+//    were all empty. On stop the stages are drained first.
+//  - It also does the binary packet log's file work (next segment, rotation), so packets logged
+//    from the game thread never wait on the disk.
+//  - Lines lost to full stages, spdlog overruns or rate limiting are reported on the socket
+//    channel at most every kDropReportEvery.
+// -------------------------------------------------------------------------------------------------
+void Logger_Spdlog::format_loop()
+{
+  std::string line;
+  Stats reported;
+  auto next_report = std::chrono::steady_clock::now() + kDropReportEvery;
+  for (;;)
+  {
+    const bool busy = drain(line);
+    packets_.prepare();
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_report)
+    {
+      next_report = now + kDropReportEvery;
+      report_drops(reported);
+    }
+
+    std::unique_lock<std::mutex> lk(defer_m_);
+    if (defer_stop_)
+    {
+      lk.unlock();
+      drain(line);
+      report_drops(reported);
+      return;
+    }
+    if (!busy) defer_cv_.wait_for(lk, kDrainIdle, [this] { return defer_stop_; });
+  }
+}
+
+bool Logger_Spdlog::drain(std::string& line)
+{
+  std::vector<LogStage*> snapshot;
+  {
+    std::lock_guard<std::mutex> lk(pool_->m);
+    snapshot.reserve(pool_->stages.size());
+    for (const auto& s : pool_->stages) snapshot.push_back(s.get());
+  }
+
+  bool any = false;
+  arkan::relay::application::ports::LogRecord r;
+  for (LogStage* st : snapshot)
+  {
+    // bounded per pass so one chatty thread cannot starve the others
+    for (std::size_t n = 0; n < kStageSlots && st->pop(r); ++n)
+    {
+      write_record(r, line);
+      any = true;
+    }
+  }
+  return any;
+}
+
+void Logger_Spdlog::report_drops(Stats& reported)
+{
+  const Stats now = stats();
+  const uint64_t staged = now.staged_dropped - reported.staged_dropped;
+  const uint64_t overrun = now.overrun - reported.overrun;
+  const uint64_t limited = now.rate_limited - reported.rate_limited;
+  reported = now;
+  if (!sock_ || (staged == 0 && overrun == 0 && limited == 0)) return;
+
+  char b[192];
+  std::snprintf(b, sizeof(b),
+                "[log] lines dropped: %llu (stage full), %llu (spdlog queue overrun), "
+                "%llu (rate limited)",
+                static_cast<unsigned long long>(staged), static_cast<unsigned long long>(overrun),
+                static_cast<unsigned long long>(limited));
+  sock_->log(spdlog::level::warn, b);
+}
+
+void Logger_Spdlog::stop_formatter()
+{
+  if (!format_thread_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lk(defer_m_);
+    defer_stop_ = true;
+  }
+  defer_cv_.notify_one();
+  format_thread_.join();
+}
+
+void Logger_Spdlog::write_record(const arkan::relay::application::ports::LogRecord& r,
+                                 std::string& line)
+{
+  if (!sock_) return;
+  line.clear();
+  r.format(line);
+  sock_->log(r.time, spdlog::source_loc{}, map_level(r.level), line);
+}
+
 // -------------------------------------------------------------------------------------------------
 void Logger_Spdlog::set_level(LogLevel level)
 {
@@ -1,12 +1,21 @@
 #pragma once
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 #include "application/ports/ILogger.hpp"
 #include "domain/Settings.hpp"
+#include "infrastructure/logging/LogStage.hpp"
+#include "infrastructure/logging/PacketLog.hpp"
 
 namespace arkan::relay::infrastructure::logging
 {
@@ -14,18 +23,98 @@ namespace arkan::relay::infrastructure::logging
 class Logger_Spdlog final : public arkan::relay::application::ports::ILogger
 {
  public:
+  Logger_Spdlog() = default;
+  ~Logger_Spdlog() override;
+
+  Logger_Spdlog(const Logger_Spdlog&) = delete;
+  Logger_Spdlog& operator=(const Logger_Spdlog&) = delete;
+
   void init(const arkan::relay::domain::Settings& s) override;
 
   void app(arkan::relay::application::ports::LogLevel level, const std::string& msg) override;
 
   void sock(arkan::relay::application::ports::LogLevel level, std::string_view msg) override;
 
+  bool enabled(arkan::relay::application::ports::LogLevel level) const override;
+
+  void sock_deferred(const arkan::relay::application::ports::LogRecord& r) override;
+
+  // socketLogFormat = "binary": packets go to packets_ as records, not to the text file
+  void sock_packet(arkan::relay::application::ports::PacketDir dir, uint64_t socket,
+                   std::span<const std::byte> bytes) override;
+
   void set_level(arkan::relay::application::ports::LogLevel level);
 
+  // Lines not written so far
+  struct Stats
+  {
+    uint64_t staged_dropped{0};  // calling thread's stage full
+    uint64_t overrun{0};         // spdlog's async queue full (oldest line overwritten)
+    uint64_t rate_limited{0};    // warn+ lines over [logging].rateLimit for their site
+    uint64_t sampled_out{0};     // info- lines skipped by [logging].sampleEvery
+  };
+  Stats stats() const;
+
  private:
   std::shared_ptr<spdlog::logger> app_;
   std::shared_ptr<spdlog::logger> sock_;
 
+  // Deferred socket lines: each logging thread copies records into its own LogStage (lock-free,
+  // never waits; a full stage drops the line and counts it). format_thread_ drains the stages,
+  // formats and hands the lines to sock_. Lines keep their capture time but may land a little
+  // after direct sock() lines logged later.
+  static constexpr std::size_t kStageSlots = 512;
+  static constexpr std::size_t kMaxStages = 64;
+  static constexpr auto kDrainIdle = std::chrono::milliseconds(5);
+  static constexpr auto kDropReportEvery = std::chrono::seconds(10);
+
+  LogStage* stage();
+  bool admit(const char* site, arkan::relay::application::ports::LogLevel level,
+             std::chrono::system_clock::time_point time, uint32_t& suppressed);
+  void format_loop();
+  bool drain(std::string& line);
+  void report_drops(Stats& reported);
+  void stop_formatter();
+  void write_record(const arkan::relay::application::ports::LogRecord& r, std::string& line);
+
+  // Stages are never freed while the logger lives (init() keeps them): a thread holds its stage
+  // until it exits, then hands it back for the next thread to register. Shared with those
+  // threads, which may outlive the logger.
+  struct StagePool
+  {
+    std::mutex m;
+    std::vector<std::unique_ptr<LogStage>> stages;
+    std::vector<LogStage*> free;  // their threads have exited
+  };
+
+  static inline std::atomic<uint64_t> next_logger_id_{0};
+  std::atomic<uint64_t> id_{0};  // set by the first init(): nothing is staged before
+  std::shared_ptr<StagePool> pool_ = std::make_shared<StagePool>();
+  std::atomic<uint64_t> unstaged_{0};  // lines of threads past kMaxStages live ones
+
+  std::mutex defer_m_;
+  std::condition_variable defer_cv_;
+  bool defer_stop_{false};
+  std::thread format_thread_;
+
+  // Per message site (format string address): sampling and rate limiting state
+  struct Site
+  {
+    std::atomic<const char*> key{nullptr};
+    std::atomic<uint64_t> seen{0};
+    std::atomic<int64_t> window{0};  // second of in_window
+    std::atomic<uint32_t> in_window{0};
+    std::atomic<uint32_t> suppressed{0};
+  };
+  static constexpr std::size_t kSites = 256;
+  std::array<Site, kSites> sites_{};
+  uint32_t sample_every_{1};
+  uint32_t rate_limit_{0};
+  std::atomic<uint64_t> sampled_out_{0};
+  std::atomic<uint64_t> rate_limited_{0};
+
+  PacketLog packets_;
+
   // Helpers
   static spdlog::level::level_enum map_level(arkan::relay::application::ports::LogLevel l);
 };
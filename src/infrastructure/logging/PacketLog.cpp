@@ -0,0 +1,315 @@
+#include "infrastructure/logging/PacketLog.hpp"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <utility>
+
+#include "infrastructure/io/MappedFile.hpp"
+#include "shared/hex/Hex.hpp"
+
+namespace arkan::relay::infrastructure::logging
+{
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+constexpr char kMagic[8] = {'A', 'R', 'K', 'P', 'K', 'T', '\r', '\n'};
+
+// First slot of every segment
+struct SegmentHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t records;  // capacity, header slot excluded
+};
+
+constexpr std::size_t kSlot = sizeof(PacketRecord);
+
+// "<stem>-NNNNNNNN.pkt" -> NNNNNNNN; false for anything else
+bool parse_segment(const std::string& name, const std::string& stem, uint32_t& index)
+{
+  constexpr std::size_t kTail = 1 + 8 + 4;  // "-" + index + ".pkt"
+  if (name.size() <= kTail || name.compare(name.size() - 4, 4, ".pkt") != 0) return false;
+  const std::size_t dash = name.size() - kTail;
+  if (name[dash] != '-') return false;
+  if (!stem.empty() && name.compare(0, dash, stem) != 0) return false;
+  if (!stem.empty() && dash != stem.size()) return false;
+
+  uint32_t v = 0;
+  for (std::size_t i = dash + 1; i < dash + 9; ++i)
+  {
+    const char c = name[i];
+    if (c >= '0' && c <= '9')
+      v = (v << 4) | static_cast<uint32_t>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      v = (v << 4) | static_cast<uint32_t>(c - 'a' + 10);
+    else
+      return false;
+  }
+  index = v;
+  return true;
+}
+}  // namespace
+
+// -------------------- open/close --------------------
+PacketLog::~PacketLog()
+{
+  close();
+}
+
+bool PacketLog::open(const std::string& dir, const std::string& stem, std::size_t segment_records,
+                     std::size_t keep)
+{
+  close();
+  if (dir.empty() || stem.empty() || segment_records == 0) return false;
+
+  boost::system::error_code ec;
+  fs::create_directories(dir, ec);
+  if (!fs::is_directory(dir, ec)) return false;
+
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    dir_ = dir;
+    stem_ = stem;
+    segment_records_ = segment_records;
+    keep_ = (std::max)(keep, std::size_t{1});
+    records_ = dropped_ = 0;
+
+    // carry on after the previous run's segments
+    uint32_t last = 0;
+    bool found = false;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+    {
+      uint32_t i = 0;
+      if (!parse_segment(it->path().filename().string(), stem_, i)) continue;
+      last = found ? (std::max)(last, i) : i;
+      found = true;
+    }
+    index_ = found ? last + 1 : 0;
+    seg_ = create_segment(index_, handle_);
+    used_ = 0;
+    if (!seg_) return false;
+    rotate(index_);
+  }
+  prepare();
+  return true;
+}
+
+void PacketLog::close()
+{
+  std::lock_guard<std::mutex> lk(m_);
+  if (!seg_) return;
+  const std::size_t bytes = kSlot * (segment_records_ + 1);
+  io::unmap_file(seg_, bytes, handle_);
+  seg_ = nullptr;
+  handle_ = nullptr;
+  if (retired_) io::unmap_file(retired_, bytes, retired_handle_);
+  retired_ = nullptr;
+  retired_handle_ = nullptr;
+
+  // the spare was never written to: it does not outlive the log
+  if (!spare_) return;
+  io::unmap_file(spare_, bytes, spare_handle_);
+  spare_ = nullptr;
+  spare_handle_ = nullptr;
+  boost::system::error_code ec;
+  fs::remove(path_of(index_ + 1), ec);
+}
+
+// -------------------- writer --------------------
+void PacketLog::append(char dir, uint64_t socket, std::span<const std::byte> bytes)
+{
+  PacketRecord r;
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  r.time_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+  r.socket = socket;
+  r.length = static_cast<uint32_t>(bytes.size());
+  r.opcode = bytes.size() >= 2 ? static_cast<uint16_t>(std::to_integer<unsigned>(bytes[0]) |
+                                                       (std::to_integer<unsigned>(bytes[1]) << 8))
+                               : 0;
+  r.dir = static_cast<uint8_t>(dir);
+  r.stored = static_cast<uint8_t>((std::min)(bytes.size(), PacketRecord::kDataBytes));
+  std::memcpy(r.data, bytes.data(), r.stored);
+  std::memset(r.data + r.stored, 0, PacketRecord::kDataBytes - r.stored);
+
+  std::lock_guard<std::mutex> lk(m_);
+  if (seg_ && used_ == segment_records_ && spare_ && !retired_)
+  {
+    // move on to the segment prepare() made ready; it unmaps this one
+    retired_ = std::exchange(seg_, std::exchange(spare_, nullptr));
+    retired_handle_ = std::exchange(handle_, std::exchange(spare_handle_, nullptr));
+    ++index_;
+    used_ = 0;
+  }
+  if (!seg_ || used_ == segment_records_)
+  {
+    ++dropped_;
+    return;
+  }
+  std::memcpy(seg_ + kSlot * (1 + used_), &r, kSlot);
+  ++used_;
+  ++records_;
+}
+
+uint64_t PacketLog::records() const
+{
+  std::lock_guard<std::mutex> lk(m_);
+  return records_;
+}
+
+uint64_t PacketLog::dropped() const
+{
+  std::lock_guard<std::mutex> lk(m_);
+  return dropped_;
+}
+
+void PacketLog::prepare()
+{
+  // the file work happens outside m_: append() only ever waits for pointer swaps
+  std::byte* full = nullptr;
+  void* full_handle = nullptr;
+  uint32_t newest = 0, next = 0;
+  bool need = false;
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    if (!seg_) return;
+    full = std::exchange(retired_, nullptr);
+    full_handle = std::exchange(retired_handle_, nullptr);
+    newest = index_;
+    next = index_ + 1;
+    need = spare_ == nullptr;
+  }
+
+  const std::size_t bytes = kSlot * (segment_records_ + 1);
+  if (full)
+  {
+    io::unmap_file(full, bytes, full_handle);
+    rotate(newest);
+  }
+  if (!need) return;
+
+  void* handle = nullptr;
+  std::byte* seg = create_segment(next, handle);
+  if (!seg) return;  // tried again on the next call
+
+  std::lock_guard<std::mutex> lk(m_);
+  if (seg_ && !spare_ && index_ + 1 == next)
+  {
+    spare_ = seg;
+    spare_handle_ = handle;
+    return;
+  }
+  io::unmap_file(seg, bytes, handle);  // closed meanwhile
+}
+
+std::byte* PacketLog::create_segment(uint32_t index, void*& handle) const
+{
+  std::byte* seg = io::map_file(path_of(index), kSlot * (segment_records_ + 1), true, handle);
+  if (!seg) return nullptr;
+
+  SegmentHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.record_size = static_cast<uint32_t>(kSlot);
+  h.records = segment_records_;
+  std::memcpy(seg, &h, sizeof(h));
+  return seg;
+}
+
+// Only the newest `keep_` segments up to `newest` stay (the spare after it does not count)
+void PacketLog::rotate(uint32_t newest) const
+{
+  boost::system::error_code ec;
+  for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec))
+  {
+    uint32_t i = 0;
+    if (parse_segment(it->path().filename().string(), stem_, i) && i + keep_ <= newest)
+      fs::remove(it->path(), ec);
+  }
+}
+
+std::string PacketLog::path_of(uint32_t index) const
+{
+  char name[32];
+  std::snprintf(name, sizeof(name), "-%08x.pkt", index);
+  return (fs::path(dir_) / (stem_ + name)).string();
+}
+
+// -------------------- reading --------------------
+std::vector<std::string> PacketLog::segments(const std::string& dir, const std::string& stem)
+{
+  std::vector<std::pair<std::string, std::string>> found;  // (stem + index, path)
+  boost::system::error_code ec;
+  for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+  {
+    const std::string name = it->path().filename().string();
+    uint32_t i = 0;
+    if (parse_segment(name, stem, i)) found.emplace_back(name, it->path().string());
+  }
+  std::sort(found.begin(), found.end());
+
+  std::vector<std::string> out;
+  out.reserve(found.size());
+  for (auto& f : found) out.push_back(std::move(f.second));
+  return out;
+}
+
+bool PacketLog::read(const std::string& path, const std::function<void(const PacketRecord&)>& fn)
+{
+  std::ifstream in(path, std::ios::binary);
+  SegmentHeader h{};
+  if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.record_size != kSlot) return false;
+
+  in.seekg(static_cast<std::streamoff>(kSlot));
+  PacketRecord r;
+  for (uint64_t i = 0; i < h.records; ++i)
+  {
+    if (!in.read(reinterpret_cast<char*>(&r), kSlot) || r.time_us == 0) break;
+    fn(r);
+  }
+  return true;
+}
+
+std::string PacketLog::render(const PacketRecord& r, std::size_t max_bytes)
+{
+  const auto secs = static_cast<std::time_t>(r.time_us / 1000000);
+  std::tm tm{};
+#ifdef _WIN32
+  localtime_s(&tm, &secs);
+#else
+  localtime_r(&secs, &tm);
+#endif
+  char head[64];
+  const std::size_t n = std::strftime(head, sizeof(head), "[%Y-%m-%d %H:%M:%S", &tm);
+  std::snprintf(head + n, sizeof(head) - n, ".%03u] [socket] [info] ",
+                static_cast<unsigned>((r.time_us / 1000) % 1000));
+
+  std::string line(head);
+  line += r.dir == 'S' ? "SEND \xE2\x86\x92 " : "RECV \xE2\x86\x90 ";
+
+  // same cut as the text line: `max_bytes` of the packet (as far as they were kept), then
+  // "...(N bytes total)"
+  const std::size_t take = (max_bytes > 0) ? (std::min)(max_bytes, std::size_t{r.stored})
+                                           : std::size_t{r.stored};
+  const std::size_t at = line.size();
+  line.resize(at + shared::hex::encoded_size(take));
+  shared::hex::encode(std::span<const std::byte>(r.data, take), line.data() + at);
+  if (take < r.length)
+  {
+    line += "...(";
+    line += std::to_string(r.length);
+    line += " bytes total)";
+  }
+  return line;
+}
+
+}  // namespace arkan::relay::infrastructure::logging
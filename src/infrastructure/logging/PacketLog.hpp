@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace arkan::relay::infrastructure::logging
+{
+
+// One logged packet, as stored on disk (little-endian, 256 bytes)
+struct PacketRecord
+{
+  static constexpr std::size_t kDataBytes = 232;
+
+  uint64_t time_us;  // system clock, microseconds since the epoch; 0 = unused slot
+  uint64_t socket;
+  uint32_t length;  // size of the packet (only `stored` bytes of it are kept)
+  uint16_t opcode;  // first two bytes (LE), 0 for shorter packets
+  uint8_t dir;      // 'S' client -> server, 'R' server -> client
+  uint8_t stored;
+  std::byte data[kDataBytes];
+};
+static_assert(sizeof(PacketRecord) == 256, "PacketRecord layout is part of the file format");
+
+// -----------------------------------------------------------------------------
+// PacketLog
+//  - Binary form of the socket channel's per-packet lines: fixed-size
+//    PacketRecords appended to memory-mapped segment files
+//    (<dir>/<stem>-NNNNNNNN.pkt), with no formatting at all when writing.
+//  - A segment holds a header slot then `segment_records` records; the file is
+//    zero-filled, so a record with time_us == 0 ends its data. When a segment
+//    is full the writer moves on to the next one and only the newest `keep` are
+//    kept on disk (like the rotating text log). Segments of earlier runs are
+//    kept too: numbering continues after the highest one found.
+//  - append() is thread-safe (one short copy under a mutex) and never does file
+//    I/O: prepare(), called from a background thread, creates the next segment
+//    ahead of time and unmaps and rotates out the full ones. A record that finds
+//    the segment full before its successor is ready is dropped and counted.
+//  - render() turns a record back into the text line the socket channel would
+//    have written; `arkan_relay_slog` does that for whole files.
+// -----------------------------------------------------------------------------
+class PacketLog
+{
+ public:
+  static constexpr std::size_t kDefaultSegmentRecords = 64u * 1024;  // 16 MiB
+  static constexpr std::size_t kDefaultKeep = 4;
+  static constexpr uint32_t kVersion = 1;
+
+  PacketLog() = default;
+  ~PacketLog();
+
+  PacketLog(const PacketLog&) = delete;
+  PacketLog& operator=(const PacketLog&) = delete;
+
+  // Creates `dir` if needed
+  bool open(const std::string& dir, const std::string& stem,
+            std::size_t segment_records = kDefaultSegmentRecords, std::size_t keep = kDefaultKeep);
+  void close();
+
+  bool is_open() const
+  {
+    return seg_ != nullptr;
+  }
+
+  // Records one packet; bytes past PacketRecord::kDataBytes are not kept (`length` still says
+  // how long it was). Dropped, and counted, when no segment could be created.
+  void append(char dir, uint64_t socket, std::span<const std::byte> bytes);
+
+  // Background upkeep (see above); cheap when there is nothing to do. Not reentrant: one thread.
+  void prepare();
+
+  uint64_t records() const;
+  uint64_t dropped() const;
+
+  // -------------------- reading --------------------
+
+  // Segment files of `stem` in `dir` (stem empty: any), oldest first
+  static std::vector<std::string> segments(const std::string& dir, const std::string& stem = {});
+
+  // Calls `fn` for every record of one segment file, in order; false if it is not a segment
+  static bool read(const std::string& path, const std::function<void(const PacketRecord&)>& fn);
+
+  // "[2025-01-31 12:00:00.123] [socket] [info] RECV ← AA BB ...": `max_bytes` as in hex_dump
+  static std::string render(const PacketRecord& r, std::size_t max_bytes = 64);
+
+ private:
+  std::byte* create_segment(uint32_t index, void*& handle) const;
+  void rotate(uint32_t newest) const;
+  std::string path_of(uint32_t index) const;
+
+  mutable std::mutex m_;
+  std::string dir_;
+  std::string stem_;
+  std::size_t segment_records_{0};
+  std::size_t keep_{0};
+
+  std::byte* seg_{nullptr};
+  void* handle_{nullptr};
+  uint32_t index_{0};
+  std::size_t used_{0};  // records written to seg_
+
+  std::byte* spare_{nullptr};  // segment index_ + 1, ready for when seg_ is full
+  void* spare_handle_{nullptr};
+  std::byte* retired_{nullptr};  // full segment prepare() still has to unmap
+  void* retired_handle_{nullptr};
+
+  uint64_t records_{0};
+  uint64_t dropped_{0};
+};
+
+}  // namespace arkan::relay::infrastructure::logging
@@ -0,0 +1,118 @@
+#include "infrastructure/net/IoPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace arkan::relay::infrastructure::net
+{
+
+IoPool::IoPool(std::size_t threads, std::vector<int> cpus)
+    : IoPool(IoPoolOptions{threads, std::move(cpus)})
+{
+}
+
+// The concurrency hint is the worker count: with one worker the scheduler skips cross-thread
+// hand-offs, and on Windows it caps how many threads the completion port releases at once.
+IoPool::IoPool(const IoPoolOptions& o)
+    : io_(static_cast<int>((std::max)(o.threads, std::size_t{1}))),
+      work_(std::in_place, boost::asio::make_work_guard(io_))
+{
+  const std::size_t threads = (std::max)(o.threads, std::size_t{1});
+  threads_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i)
+  {
+    threads_.emplace_back([this, spin = o.spin] { work(spin); });
+    if (!o.cpus.empty()) pin(threads_.back(), o.cpus[i % o.cpus.size()]);
+    if (o.high_priority) raise_priority(threads_.back());
+  }
+}
+
+IoPool::~IoPool()
+{
+  stop();
+}
+
+void IoPool::stop()
+{
+  if (work_) work_->reset();
+  io_.stop();
+  for (auto& t : threads_)
+  {
+    if (t.joinable() && t.get_id() != std::this_thread::get_id()) t.join();
+  }
+}
+
+bool IoPool::running_in_this_thread() const
+{
+  const auto self = std::this_thread::get_id();
+  return std::any_of(threads_.begin(), threads_.end(),
+                     [&](const std::thread& t) { return t.get_id() == self; });
+}
+
+void IoPool::work(std::chrono::microseconds spin)
+{
+  if (spin.count() <= 0)
+  {
+    io_.run();
+    return;
+  }
+
+  // busy-poll: run whatever is ready; once nothing has been for `spin`, block for the next one
+  auto idle_since = std::chrono::steady_clock::now();
+  while (!io_.stopped())
+  {
+    if (io_.poll() != 0)
+    {
+      idle_since = std::chrono::steady_clock::now();
+      continue;
+    }
+    if (std::chrono::steady_clock::now() - idle_since < spin)
+    {
+#ifdef _WIN32
+      YieldProcessor();
+#else
+      std::this_thread::yield();
+#endif
+      continue;
+    }
+    io_.run_one();
+    idle_since = std::chrono::steady_clock::now();
+  }
+}
+
+// Best effort: a CPU the process may not use leaves the thread where the OS put it
+void IoPool::pin(std::thread& t, int cpu)
+{
+  if (cpu < 0) return;
+#ifdef _WIN32
+  if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return;
+  ::SetThreadAffinityMask(static_cast<HANDLE>(t.native_handle()), DWORD_PTR{1} << cpu);
+#else
+  if (cpu >= CPU_SETSIZE) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  ::pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#endif
+}
+
+// Best effort: without the privilege the thread keeps its normal priority. POSIX has no
+// unprivileged way up for SCHED_OTHER threads, so this is a no-op there.
+void IoPool::raise_priority(std::thread& t)
+{
+#ifdef _WIN32
+  ::SetThreadPriority(static_cast<HANDLE>(t.native_handle()), THREAD_PRIORITY_HIGHEST);
+#else
+  (void)t;
+#endif
+}
+
+}  // namespace arkan::relay::infrastructure::net
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace arkan::relay::infrastructure::net
+{
+
+struct IoPoolOptions
+{
+  std::size_t threads{1};
+  std::vector<int> cpus;              // worker i runs on cpus[i % size] (empty = anywhere)
+  std::chrono::microseconds spin{0};  // busy-poll budget after the last handler (0 = block)
+  bool high_priority{false};          // raise the workers' scheduling priority
+};
+
+// -----------------------------------------------------------------------------
+// IoPool
+//  - One io_context run by `threads` worker threads (relay.ioThreads).
+//  - Subsystems get their own strand from make_strand(): handlers of one strand
+//    never run concurrently, handlers of different strands do.
+//  - Worker i is pinned to cpus[i % cpus.size()] when `cpus` is not empty.
+//  - Busy-poll mode (spin > 0): a worker keeps polling for `spin` after its
+//    last handler before it blocks, so a burst arriving meanwhile skips the
+//    wakeup. Costs a core per spinning worker; pair it with pinning.
+//  - Must outlive everything that posts to it; stop() (or the dtor) drops
+//    pending handlers without running them and joins the workers.
+// -----------------------------------------------------------------------------
+class IoPool
+{
+ public:
+  using executor_type = boost::asio::io_context::executor_type;
+  using strand_type = boost::asio::strand<executor_type>;
+
+  explicit IoPool(std::size_t threads = 1, std::vector<int> cpus = {});
+  explicit IoPool(const IoPoolOptions& o);
+  ~IoPool();
+
+  IoPool(const IoPool&) = delete;
+  IoPool& operator=(const IoPool&) = delete;
+
+  boost::asio::io_context& context()
+  {
+    return io_;
+  }
+  executor_type executor()
+  {
+    return io_.get_executor();
+  }
+  strand_type make_strand()
+  {
+    return boost::asio::make_strand(io_);
+  }
+  std::size_t size() const
+  {
+    return threads_.size();
+  }
+
+  // True on one of the pool's worker threads
+  bool running_in_this_thread() const;
+
+  void stop();
+
+ private:
+  void work(std::chrono::microseconds spin);
+  static void pin(std::thread& t, int cpu);
+  static void raise_priority(std::thread& t);
+
+  boost::asio::io_context io_;
+  std::optional<boost::asio::executor_work_guard<executor_type>> work_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace arkan::relay::infrastructure::net
@@ -1,14 +1,36 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <span>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
+// SIMD level of the hex encoder: 2 = SSSE3 (pshufb; any /arch:AVX2 build), 1 = SSE2 (x86
+// default), 0 = table only
+#if !defined(ARKAN_HEX_SIMD)
+#if defined(__AVX2__) || defined(__SSSE3__)
+#define ARKAN_HEX_SIMD 2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARKAN_HEX_SIMD 1
+#else
+#define ARKAN_HEX_SIMD 0
+#endif
+#endif
+
+#if ARKAN_HEX_SIMD == 2
+#include <tmmintrin.h>
+#elif ARKAN_HEX_SIMD == 1
+#include <emmintrin.h>
+#endif
+
 #if defined(min)
 #undef min
 #endif
@@ -25,27 +47,168 @@ namespace arkan::relay::shared::hex
 constexpr int ptr_width = (sizeof(uintptr_t) == 4) ? 8 : (sizeof(uintptr_t) == 8) ? 16 : 8;
 
 // -----------------------------------------------------------------------------
-// hex_dump(data, max_len)
+// encode(in, out)
+//  - Writes "AA BB CC " (uppercase, one space after every byte) for all of
+//    `in` into `out`, which must hold encoded_size(in.size()) chars; no NUL.
+//  - Table-driven: one lookup in a 256-entry table per byte. 16 bytes at a
+//    time on SSE2 (every Win32 build), with pshufb when built for SSSE3/AVX2.
 // -----------------------------------------------------------------------------
-inline std::string hex_dump(std::span<const std::byte> data, size_t max_len = 64)
+constexpr std::size_t encoded_size(std::size_t n)
 {
-  std::ostringstream oss;
-  oss << std::hex << std::uppercase << std::setfill('0');
+  return 3 * n;
+}
 
-  const size_t take = (max_len > 0) ? (std::min)(max_len, data.size()) : data.size();
+namespace detail
+{
 
-  for (size_t i = 0; i < take; ++i)
+// "00" "01" ... "FF"
+inline constexpr std::array<char, 512> kPairs = []
+{
+  constexpr char digits[] = "0123456789ABCDEF";
+  std::array<char, 512> t{};
+  for (std::size_t i = 0; i < 256; ++i)
   {
-    const auto v = static_cast<unsigned int>(std::to_integer<unsigned char>(data[i]));
-    oss << std::setw(2) << v << ' ';
+    t[2 * i] = digits[i >> 4];
+    t[2 * i + 1] = digits[i & 0xF];
   }
+  return t;
+}();
+
+inline void encode_scalar(const std::byte* in, std::size_t n, char* out) noexcept
+{
+  for (std::size_t i = 0; i < n; ++i, out += 3)
+  {
+    const char* pair = &kPairs[2 * std::to_integer<std::size_t>(in[i])];
+    out[0] = pair[0];
+    out[1] = pair[1];
+    out[2] = ' ';
+  }
+}
+
+#if ARKAN_HEX_SIMD
+// 16 bytes -> 32 hex digits: p0 = digits of bytes 0..7, p1 = digits of bytes 8..15
+inline void hex_digits16(const std::byte* in, __m128i& p0, __m128i& p1) noexcept
+{
+  const __m128i nib = _mm_set1_epi8(0x0F);
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i letter = _mm_set1_epi8('A' - '0' - 10);
+
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nib);
+  __m128i lo = _mm_and_si128(v, nib);
+  hi = _mm_add_epi8(_mm_add_epi8(hi, zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), letter));
+  lo = _mm_add_epi8(_mm_add_epi8(lo, zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), letter));
+  p0 = _mm_unpacklo_epi8(hi, lo);
+  p1 = _mm_unpackhi_epi8(hi, lo);
+}
+#endif
+
+#if ARKAN_HEX_SIMD == 2
+// pshufb controls spreading digit pairs 3 chars apart, for output chars 0..15, 16..31 and
+// 32..47 (read from digits 0..15, 8..23 and 16..31); 0x80 leaves the space slots zero
+struct SpreadTables
+{
+  alignas(16) uint8_t idx[3][16];
+  alignas(16) uint8_t space[3][16];
+};
+
+inline constexpr SpreadTables kSpread = []
+{
+  SpreadTables t{};
+  constexpr std::size_t base[3] = {0, 8, 16};
+  for (std::size_t v = 0; v < 3; ++v)
+  {
+    for (std::size_t j = 0; j < 16; ++j)
+    {
+      const std::size_t pos = 16 * v + j;
+      const std::size_t r = pos % 3;
+      t.idx[v][j] = r == 2 ? 0x80 : static_cast<uint8_t>(2 * (pos / 3) + r - base[v]);
+      t.space[v][j] = r == 2 ? ' ' : 0;
+    }
+  }
+  return t;
+}();
+
+inline void encode16(const std::byte* in, char* out) noexcept
+{
+  __m128i p0, p1;
+  hex_digits16(in, p0, p1);
+  const __m128i src[3] = {p0, _mm_alignr_epi8(p1, p0, 8), p1};
+  for (int v = 0; v < 3; ++v)
+  {
+    const __m128i idx = _mm_load_si128(reinterpret_cast<const __m128i*>(kSpread.idx[v]));
+    const __m128i sp = _mm_load_si128(reinterpret_cast<const __m128i*>(kSpread.space[v]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16 * v),
+                     _mm_or_si128(_mm_shuffle_epi8(src[v], idx), sp));
+  }
+}
+#elif ARKAN_HEX_SIMD == 1
+// SSE2 has no byte shuffle: widen each pair to "AA  " and store the 4-byte groups 3 chars
+// apart, each one overwriting the previous group's spare space
+inline void encode16(const std::byte* in, char* out) noexcept
+{
+  __m128i p0, p1;
+  hex_digits16(in, p0, p1);
+  const __m128i sp = _mm_set1_epi16(0x2020);
+
+  alignas(16) uint32_t groups[16];
+  _mm_store_si128(reinterpret_cast<__m128i*>(groups + 0), _mm_unpacklo_epi16(p0, sp));
+  _mm_store_si128(reinterpret_cast<__m128i*>(groups + 4), _mm_unpackhi_epi16(p0, sp));
+  _mm_store_si128(reinterpret_cast<__m128i*>(groups + 8), _mm_unpacklo_epi16(p1, sp));
+  _mm_store_si128(reinterpret_cast<__m128i*>(groups + 12), _mm_unpackhi_epi16(p1, sp));
+  for (int i = 0; i < 15; ++i) std::memcpy(out + 3 * i, &groups[i], 4);
+  std::memcpy(out + 45, &groups[15], 3);
+}
+#endif
+
+}  // namespace detail
+
+inline std::size_t encode(std::span<const std::byte> in, char* out) noexcept
+{
+  std::size_t i = 0;
+#if ARKAN_HEX_SIMD
+  for (; i + 16 <= in.size(); i += 16) detail::encode16(in.data() + i, out + 3 * i);
+#endif
+  detail::encode_scalar(in.data() + i, in.size() - i, out + 3 * i);
+  return encoded_size(in.size());
+}
+
+// -----------------------------------------------------------------------------
+// dump_to(data, out, max_len)
+//  - hex_dump() into a caller buffer of at least dump_size(data.size(), max_len)
+//    chars; returns the chars written (no NUL).
+// -----------------------------------------------------------------------------
+constexpr std::size_t dump_size(std::size_t n, std::size_t max_len = 64)
+{
+  const std::size_t take = (max_len > 0 && max_len < n) ? max_len : n;
+  return encoded_size(take) + (take < n ? 40 : 0);  // "...(" + 20 digits + " bytes total)"
+}
+
+inline std::size_t dump_to(std::span<const std::byte> data, char* out, size_t max_len = 64)
+{
+  const size_t take = (max_len > 0) ? (std::min)(max_len, data.size()) : data.size();
+  char* p = out + encode(data.first(take), out);
 
   if (take < data.size())
   {
-    oss << "...(" << data.size() << " bytes total)";
+    static constexpr std::string_view kOpen = "...(";
+    static constexpr std::string_view kClose = " bytes total)";
+    p = std::copy(kOpen.begin(), kOpen.end(), p);
+    p = std::to_chars(p, p + 20, static_cast<unsigned long long>(data.size())).ptr;
+    p = std::copy(kClose.begin(), kClose.end(), p);
   }
+  return static_cast<std::size_t>(p - out);
+}
 
-  return oss.str();
+// -----------------------------------------------------------------------------
+// hex_dump(data, max_len)
+// -----------------------------------------------------------------------------
+inline std::string hex_dump(std::span<const std::byte> data, size_t max_len = 64)
+{
+  std::string out(dump_size(data.size(), max_len), '\0');
+  out.resize(dump_to(data, out.data(), max_len));
+  return out;
 }
 
 // overload for const std::byte* (handy when calling with vector<std::byte>.data())
@@ -97,9 +260,11 @@ inline std::string to_hex_ptr(uintptr_t p)
 inline std::string make_line(const char* tag, std::span<const std::byte> sp, size_t max = 32)
 {
   std::string line;
-  line.reserve(64 + max * 3);
+  line.reserve(64 + dump_size(sp.size(), max));
   line.append(tag).append(" n=").append(std::to_string(sp.size())).append(": ");
-  line += hex_dump(sp, max);
+  const std::size_t at = line.size();
+  line.resize(at + dump_size(sp.size(), max));
+  line.resize(at + dump_to(sp, line.data() + at, max));
   return line;
 }
 
@@ -0,0 +1,361 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "application/ports/IFlightRecorder.hpp"
+#include "application/ports/IFrameCodec.hpp"
+#include "application/ports/IHook.hpp"
+#include "application/ports/IKoreLink.hpp"
+#include "application/ports/ILogger.hpp"
+#include "application/services/BridgeService.hpp"
+#include "domain/Settings.hpp"
+#include "domain/protocol/Envelope.hpp"
+
+using arkan::relay::application::ports::FlightEvent;
+using arkan::relay::application::ports::FrameReservation;
+using arkan::relay::application::ports::LogLevel;
+using arkan::relay::application::services::BridgeService;
+using arkan::relay::domain::Settings;
+namespace ports = arkan::relay::application::ports;
+namespace env = arkan::relay::domain::protocol::envelope;
+
+using Buf = std::vector<std::byte>;
+
+// ----------------------------- Fakes -----------------------------
+namespace
+{
+// Records every injection, in order, as (kind, bytes)
+struct FakeHook : ports::IHook
+{
+  std::vector<std::pair<char, Buf>> injected;
+
+  bool install() override
+  {
+    return true;
+  }
+  void uninstall() override {}
+  bool try_inject_send(Bytes b) override
+  {
+    injected.emplace_back('S', Buf(b.begin(), b.end()));
+    return true;
+  }
+  bool try_inject_recv(Bytes b) override
+  {
+    injected.emplace_back('R', Buf(b.begin(), b.end()));
+    return true;
+  }
+  void emit_send(Bytes) override {}
+  void emit_recv(Bytes) override {}
+  void notify_socket(SOCKET) override {}
+};
+
+// Keeps frames written for Kore, in order, and whether each came through reserve()/commit()
+struct FakeLink : ports::IKoreLink
+{
+  struct Sent
+  {
+    char kind;
+    Buf payload;
+    bool reserved;
+  };
+  std::vector<Sent> sent;
+  std::function<void(char, std::span<const std::byte>)> deliver;  // Kore -> relay
+  uint32_t features{0};
+  bool reservable{true};
+
+  void connect(const std::string&, uint16_t) override {}
+  void close() override {}
+  void send_frame(char kind, std::span<const std::byte> payload) override
+  {
+    sent.push_back({kind, Buf(payload.begin(), payload.end()), false});
+  }
+  FrameReservation reserve(char kind, std::size_t len) override
+  {
+    if (!reservable) return {};
+    staged_kind_ = kind;
+    staged_.assign(len, std::byte{0});
+    FrameReservation r;
+    r.payload = staged_;
+    r.handle = this;
+    return r;
+  }
+  void commit(FrameReservation& r) override
+  {
+    ASSERT_EQ(r.handle, this);
+    sent.push_back({staged_kind_, staged_, true});
+  }
+  void on_frame(std::function<void(char, std::span<const std::byte>)> cb) override
+  {
+    deliver = std::move(cb);
+  }
+  uint32_t peer_features() const override
+  {
+    return features;
+  }
+
+ private:
+  char staged_kind_{0};
+  Buf staged_;
+};
+
+// "Compresses" by prefixing 0xC0 and reversing; anything else is malformed
+struct FakeCodec : ports::IFrameCodec
+{
+  bool compress(std::span<const std::byte> payload, std::vector<std::byte>& out) override
+  {
+    out.push_back(std::byte{0xC0});
+    out.insert(out.end(), payload.rbegin(), payload.rend());
+    return true;
+  }
+  bool decompress(std::span<const std::byte> block, std::vector<std::byte>& out) override
+  {
+    if (block.empty() || block[0] != std::byte{0xC0}) return false;
+    out.assign(block.rbegin(), block.rend() - 1);
+    return true;
+  }
+};
+
+struct FakeLogger : ports::ILogger
+{
+  std::vector<std::pair<LogLevel, std::string>> lines;
+
+  void init(const Settings&) override {}
+  void app(LogLevel level, const std::string& msg) override
+  {
+    lines.emplace_back(level, msg);
+  }
+  void sock(LogLevel level, std::string_view msg) override
+  {
+    lines.emplace_back(level, std::string(msg));
+  }
+
+  std::size_t count(LogLevel level, const std::string& needle) const
+  {
+    std::size_t n = 0;
+    for (const auto& [l, text] : lines) n += l == level && text.find(needle) != std::string::npos;
+    return n;
+  }
+};
+
+struct FakeRecorder : ports::IFlightRecorder
+{
+  std::vector<std::pair<FlightEvent, Buf>> events;
+  std::vector<std::string> dumps;
+
+  void record(FlightEvent e, std::span<const std::byte> bytes) override
+  {
+    events.emplace_back(e, Buf(bytes.begin(), bytes.end()));
+  }
+  bool dump(const char* reason) override
+  {
+    dumps.emplace_back(reason);
+    return true;
+  }
+};
+
+// ----------------------------- Helpers -----------------------------
+Buf bytes(std::initializer_list<int> v)
+{
+  Buf out;
+  for (int b : v) out.push_back(static_cast<std::byte>(b));
+  return out;
+}
+
+// [kind][len16 LE][payload]
+void put_frame(Buf& out, char kind, const Buf& payload)
+{
+  out.push_back(static_cast<std::byte>(kind));
+  out.push_back(static_cast<std::byte>(payload.size() & 0xFF));
+  out.push_back(static_cast<std::byte>(payload.size() >> 8));
+  out.insert(out.end(), payload.begin(), payload.end());
+}
+
+// [opcode16][inner kind][codec block], as FakeCodec encodes it
+Buf compressed(char inner, const Buf& packet)
+{
+  Buf z(packet.begin(), packet.begin() + 2);
+  z.push_back(static_cast<std::byte>(inner));
+  FakeCodec().compress(packet, z);
+  return z;
+}
+
+// Wires a BridgeService to the fakes and starts it
+struct Bridge
+{
+  FakeHook hook;
+  FakeLink link;
+  FakeCodec codec;
+  FakeLogger log;
+  FakeRecorder recorder;
+  Settings cfg;
+  BridgeService svc;
+
+  explicit Bridge(bool with_recorder = true)
+      : svc(hook, link, codec, log, cfg, with_recorder ? &recorder : nullptr)
+  {
+    svc.start();
+  }
+  ~Bridge()
+  {
+    svc.stop();
+  }
+
+  void from_kore(char kind, const Buf& payload)
+  {
+    link.deliver(kind, payload);
+  }
+};
+}  // namespace
+
+// ----------------------------- Kore -> client -----------------------------
+
+TEST(BridgeService, BatchSubFramesAreInjectedInOrder)
+{
+  Bridge b;
+  ASSERT_TRUE(b.link.deliver);
+
+  Buf batch;
+  put_frame(batch, 'R', bytes({0x8A, 0x00, 0x01}));
+  put_frame(batch, 'S', bytes({0x89, 0x00}));
+  put_frame(batch, 'K', {});
+  put_frame(batch, 'R', bytes({0x8A, 0x00, 0x02}));
+  b.from_kore(env::kBatch, batch);
+
+  ASSERT_EQ(b.hook.injected.size(), 3u);
+  EXPECT_EQ(b.hook.injected[0], std::make_pair('R', bytes({0x8A, 0x00, 0x01})));
+  EXPECT_EQ(b.hook.injected[1], std::make_pair('S', bytes({0x89, 0x00})));
+  EXPECT_EQ(b.hook.injected[2], std::make_pair('R', bytes({0x8A, 0x00, 0x02})));
+
+  // every injection also lands in the flight recorder
+  ASSERT_EQ(b.recorder.events.size(), 3u);
+  EXPECT_EQ(b.recorder.events[1].first, FlightEvent::inject_send);
+}
+
+TEST(BridgeService, MalformedBatchKeepsWhatCameBeforeAndWarns)
+{
+  Bridge b;
+
+  // truncated second sub-frame: the first is still delivered, the rest is dropped
+  Buf batch;
+  put_frame(batch, 'R', bytes({0x8A, 0x00, 0x01}));
+  put_frame(batch, 'R', bytes({0x8A, 0x00, 0x02, 0x03}));
+  batch.pop_back();
+  b.from_kore(env::kBatch, batch);
+
+  ASSERT_EQ(b.hook.injected.size(), 1u);
+  EXPECT_EQ(b.hook.injected[0].second, bytes({0x8A, 0x00, 0x01}));
+  EXPECT_EQ(b.log.count(LogLevel::warn, "malformed"), 1u);
+
+  // a nested batch is malformed too
+  Buf inner, outer;
+  put_frame(inner, 'R', bytes({0x8A, 0x00, 0x09}));
+  put_frame(outer, env::kBatch, inner);
+  b.from_kore(env::kBatch, outer);
+  EXPECT_EQ(b.hook.injected.size(), 1u);
+  EXPECT_EQ(b.log.count(LogLevel::warn, "malformed"), 2u);
+}
+
+TEST(BridgeService, CompressedFramesAreDecodedAndDispatched)
+{
+  Bridge b;
+  const Buf recv = bytes({0xA4, 0x00, 0x10, 0x20, 0x30});
+  const Buf send = bytes({0x89, 0x00, 0x40});
+
+  b.from_kore(env::kCompressed, compressed('R', recv));
+
+  // inside a batch, in order with the plain sub-frames around it
+  Buf batch;
+  put_frame(batch, 'R', bytes({0x8A, 0x00}));
+  put_frame(batch, env::kCompressed, compressed('S', send));
+  put_frame(batch, 'R', bytes({0x8B, 0x00}));
+  b.from_kore(env::kBatch, batch);
+
+  ASSERT_EQ(b.hook.injected.size(), 4u);
+  EXPECT_EQ(b.hook.injected[0], std::make_pair('R', recv));
+  EXPECT_EQ(b.hook.injected[1], std::make_pair('R', bytes({0x8A, 0x00})));
+  EXPECT_EQ(b.hook.injected[2], std::make_pair('S', send));
+  EXPECT_EQ(b.hook.injected[3], std::make_pair('R', bytes({0x8B, 0x00})));
+}
+
+TEST(BridgeService, UndecodableCompressedFramesAreDroppedWithAWarning)
+{
+  Bridge b;
+
+  Buf bad_block = compressed('R', bytes({0xA4, 0x00, 0x10}));
+  bad_block[3] = std::byte{0x00};  // not what the codec wrote
+  b.from_kore(env::kCompressed, bad_block);
+
+  Buf bad_inner = compressed('K', bytes({0xA4, 0x00, 0x10}));  // only S/R may be compressed
+  b.from_kore(env::kCompressed, bad_inner);
+
+  b.from_kore(env::kCompressed, bytes({0xA4, 0x00}));  // shorter than the prefix
+
+  EXPECT_TRUE(b.hook.injected.empty());
+  EXPECT_EQ(b.log.count(LogLevel::warn, "undecodable"), 3u);
+}
+
+TEST(BridgeService, DumpRequestWritesTheFlightRecorder)
+{
+  {
+    Bridge b;
+    b.from_kore(env::kDump, {});
+    ASSERT_EQ(b.recorder.dumps.size(), 1u);
+    EXPECT_EQ(b.recorder.dumps[0], "kore");
+    EXPECT_TRUE(b.hook.injected.empty());
+  }
+  {
+    Bridge b(false);
+    b.from_kore(env::kDump, {});
+    EXPECT_EQ(b.log.count(LogLevel::warn, "recorder is off"), 1u);
+  }
+}
+
+// ----------------------------- client -> Kore -----------------------------
+
+TEST(BridgeService, ReceivedPacketsGoStraightIntoLinkMemoryWhenPossible)
+{
+  Bridge b;
+  ASSERT_TRUE(b.hook.on_recv);
+  const Buf p1 = bytes({0x8A, 0x00, 0x01, 0x02});
+  const Buf p2 = bytes({0x8B, 0x00, 0x03});
+  const Buf p3 = bytes({0x8C, 0x00});
+
+  b.hook.on_recv(p1);
+  b.link.reservable = false;  // staging full: the owned-copy path takes over
+  b.hook.on_recv(p2);
+  b.link.reservable = true;
+  b.hook.on_recv(p3);
+
+  ASSERT_EQ(b.link.sent.size(), 3u);
+  EXPECT_EQ(b.link.sent[0].kind, 'R');
+  EXPECT_EQ(b.link.sent[0].payload, p1);
+  EXPECT_TRUE(b.link.sent[0].reserved);
+  EXPECT_EQ(b.link.sent[1].kind, 'R');
+  EXPECT_EQ(b.link.sent[1].payload, p2);
+  EXPECT_FALSE(b.link.sent[1].reserved);
+  EXPECT_EQ(b.link.sent[2].payload, p3);
+  EXPECT_TRUE(b.link.sent[2].reserved);
+}
+
+TEST(BridgeService, ReceivedPacketsAreCompressedOnlyWhereKoreAgreed)
+{
+  Bridge b;
+  const Buf p = bytes({0xA4, 0x00, 0x10, 0x20});
+
+  b.hook.on_recv(p);
+  b.link.features = env::kFeatCompress;
+  b.hook.on_recv(p);
+
+  ASSERT_EQ(b.link.sent.size(), 2u);
+  EXPECT_EQ(b.link.sent[0].kind, 'R');
+  EXPECT_EQ(b.link.sent[1].kind, env::kCompressed);
+  EXPECT_EQ(b.link.sent[1].payload, compressed('R', p));
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "infrastructure/codec/FrameCodec_Lz.hpp"
+
+using arkan::relay::infrastructure::codec::FrameCodec_Lz;
+
+// ----------------------------- Helpers -----------------------------
+// Inventory-like packet: opcode + `items` 12-byte records that differ in a few bytes
+static std::vector<std::byte> inventory_packet(uint32_t seed, int items)
+{
+  std::vector<std::byte> p{std::byte{0xA4}, std::byte{0x00}};
+  for (int i = 0; i < items; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    const uint8_t rec[12] = {0x01, 0x02, static_cast<uint8_t>((seed >> 16) % 8), 0x00, 0x01,
+                             0x00, 0x00, 0x00, 0x00, static_cast<uint8_t>((seed >> 20) % 3),
+                             0x00, 0x00};
+    for (uint8_t b : rec) p.push_back(static_cast<std::byte>(b));
+  }
+  return p;
+}
+
+// ----------------------------- Tests -----------------------------
+
+TEST(FrameCodecLz, RoundTripsRepetitivePayloads)
+{
+  FrameCodec_Lz codec(64);
+  for (uint32_t seed = 1; seed <= 50; ++seed)
+  {
+    const auto p = inventory_packet(seed, 40);
+    std::vector<std::byte> z, back;
+    ASSERT_TRUE(codec.compress(p, z));
+    EXPECT_LT(z.size(), p.size() * 2 / 3);
+    ASSERT_TRUE(codec.decompress(z, back));
+    EXPECT_EQ(back, p);
+  }
+}
+
+TEST(FrameCodecLz, LeavesSmallAndIncompressiblePayloadsAlone)
+{
+  FrameCodec_Lz codec(256);
+
+  std::vector<std::byte> out{std::byte{0x7E}};
+  EXPECT_FALSE(codec.compress(inventory_packet(1, 10), out));  // 122 bytes < threshold
+  EXPECT_EQ(out.size(), 1u);                                   // caller's prefix untouched
+
+  std::vector<std::byte> noise(1000);
+  uint32_t s = 7;
+  for (auto& b : noise) b = static_cast<std::byte>((s = s * 1664525u + 1013904223u) >> 24);
+  EXPECT_FALSE(codec.compress(noise, out));
+  EXPECT_EQ(out.size(), 1u);
+}
+
+TEST(FrameCodecLz, DictionaryImprovesShortPacketsAndMustMatch)
+{
+  std::vector<std::vector<std::byte>> capture;
+  for (uint32_t seed = 100; seed < 400; ++seed) capture.push_back(inventory_packet(seed, 6));
+  const auto dict = FrameCodec_Lz::train(capture, 4096);
+  ASSERT_FALSE(dict.empty());
+
+  FrameCodec_Lz plain(0), primed(0), other(0);
+  primed.set_dictionary(dict);
+  other.set_dictionary(std::vector<std::byte>(512, std::byte{0x11}));
+
+  std::size_t plain_bytes = 0, primed_bytes = 0;
+  for (uint32_t seed = 1; seed <= 50; ++seed)
+  {
+    const auto p = inventory_packet(seed, 6);
+    std::vector<std::byte> a, b, back;
+    plain_bytes += plain.compress(p, a) ? a.size() : p.size();
+    ASSERT_TRUE(primed.compress(p, b));
+    primed_bytes += b.size();
+
+    ASSERT_TRUE(primed.decompress(b, back));
+    EXPECT_EQ(back, p);
+    EXPECT_FALSE(other.decompress(b, back));  // dictionary id mismatch
+  }
+  EXPECT_LT(primed_bytes, plain_bytes);
+}
+
+TEST(FrameCodecLz, RejectsMalformedBlocks)
+{
+  FrameCodec_Lz codec(0);
+  const auto p = inventory_packet(3, 40);
+  std::vector<std::byte> z, back;
+  ASSERT_TRUE(codec.compress(p, z));
+
+  // every truncation fails cleanly
+  for (std::size_t n = 0; n < z.size(); ++n)
+    EXPECT_FALSE(codec.decompress(std::span<const std::byte>(z.data(), n), back)) << n;
+
+  // a match reaching before the start of the output (no dictionary)
+  const std::vector<std::byte> bad{std::byte{8},    std::byte{0},    std::byte{0}, std::byte{0},
+                                   std::byte{0},    std::byte{0},    std::byte{0x10},
+                                   std::byte{'x'},  std::byte{0x09}, std::byte{0}};
+  EXPECT_FALSE(codec.decompress(bad, back));
+}
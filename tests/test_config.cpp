@@ -2,6 +2,8 @@
 
 #include <filesystem>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include "domain/Settings.hpp"
 #include "infrastructure/config/Config_Toml.hpp"
@@ -26,7 +28,7 @@ TEST(ConfigToml, CreatesWithDefaultsWhenMissing)
   Settings s = impl.load_or_create(cfg.string());
 
   EXPECT_TRUE(fs::exists(cfg));
-  EXPECT_FALSE(s.ports.empty());
+  EXPECT_FALSE(s.kore.ports.empty());
   EXPECT_FALSE(s.appLogFilename.empty());
   EXPECT_FALSE(s.socketLogFilename.empty());
   EXPECT_FALSE(s.logsDir.empty());
@@ -37,16 +39,17 @@ TEST(ConfigToml, ReadsCustomValues)
   auto cfg = tmp_file("custom.toml");
   {
     std::ofstream out(cfg.string());
-    out << "[general]\nports=[7000,7001]\nshowConsole=true\nsaveLog=false\nsaveSocketLog=false\n"
-           "\n[logging]\ndir=\"logs-x\"\napp=\"a.log\"\nsocket=\"s.log\"\n";
+    out << "[kore]\nports=[7000,7001]\n"
+           "\n[logging]\nshowConsole=true\nsaveLog=false\nsaveSocketLog=false\n"
+           "logsDir=\"logs-x\"\nappLogFilename=\"a.log\"\nsocketLogFilename=\"s.log\"\n";
   }
 
   Config_Toml impl;
   Settings s = impl.load_or_create(cfg.string());
 
-  ASSERT_EQ(s.ports.size(), 2u);
-  EXPECT_EQ(s.ports[0], 7000);
-  EXPECT_EQ(s.ports[1], 7001);
+  ASSERT_EQ(s.kore.ports.size(), 2u);
+  EXPECT_EQ(s.kore.ports[0], 7000);
+  EXPECT_EQ(s.kore.ports[1], 7001);
   EXPECT_TRUE(s.showConsole);
   EXPECT_FALSE(s.saveLog);
   EXPECT_FALSE(s.saveSocketLog);
@@ -60,7 +63,7 @@ TEST(ConfigToml, FallbackWhenSectionMissing)
   auto cfg = tmp_file("no-logging.toml");
   {
     std::ofstream out(cfg.string());
-    out << "[general]\nports=[6500]\n";
+    out << "[kore]\nports=[6500]\n";
   }
 
   Config_Toml impl;
@@ -70,3 +73,313 @@ TEST(ConfigToml, FallbackWhenSectionMissing)
   EXPECT_FALSE(s.appLogFilename.empty());
   EXPECT_FALSE(s.socketLogFilename.empty());
 }
+
+// ---------------------------------------------------------------------------
+// Tuning keys: default when absent, explicit value, invalid value keeps the default
+// ---------------------------------------------------------------------------
+
+static Settings load_text(const std::string& name, const std::string& text)
+{
+  auto cfg = tmp_file(name);
+  {
+    std::ofstream out(cfg.string());
+    out << text;
+  }
+  Config_Toml impl;
+  return impl.load_or_create(cfg.string());
+}
+
+TEST(ConfigToml, GeneratedFileParsesBackToDefaults)
+{
+  auto cfg = tmp_file("generated.toml");
+  if (fs::exists(cfg)) fs::remove(cfg);
+  Config_Toml impl;
+  impl.load_or_create(cfg.string());
+
+  const Settings d;
+  Settings s = impl.load_or_create(cfg.string());
+
+  EXPECT_EQ(s.socketLogFormat, d.socketLogFormat);
+  EXPECT_EQ(s.socketSampleEvery, d.socketSampleEvery);
+  EXPECT_EQ(s.socketRateLimit, d.socketRateLimit);
+  EXPECT_EQ(s.flightRecorder, d.flightRecorder);
+  EXPECT_EQ(s.flightRecorderBytes, d.flightRecorderBytes);
+  EXPECT_EQ(s.flightRecorderSeconds, d.flightRecorderSeconds);
+  EXPECT_EQ(s.kore.pool_size, d.kore.pool_size);
+  EXPECT_EQ(s.kore.connect_race, d.kore.connect_race);
+  EXPECT_EQ(s.kore.transport, d.kore.transport);
+  EXPECT_EQ(s.kore.shm_ring_bytes, d.kore.shm_ring_bytes);
+  EXPECT_EQ(s.kore.handshake.enabled, d.kore.handshake.enabled);
+  EXPECT_EQ(s.kore.handshake.timeout_ms, d.kore.handshake.timeout_ms);
+  EXPECT_EQ(s.kore.queue.max_bytes, d.kore.queue.max_bytes);
+  EXPECT_EQ(s.kore.queue.max_frames, d.kore.queue.max_frames);
+  EXPECT_EQ(s.kore.queue.ttl_ms, d.kore.queue.ttl_ms);
+  EXPECT_EQ(s.kore.queue.policy, d.kore.queue.policy);
+  EXPECT_EQ(s.kore.queue.shed_opcodes, d.kore.queue.shed_opcodes);
+  EXPECT_EQ(s.kore.lanes.fallback, d.kore.lanes.fallback);
+  EXPECT_EQ(s.kore.lanes.control, d.kore.lanes.control);
+  EXPECT_EQ(s.kore.lanes.interactive, d.kore.lanes.interactive);
+  EXPECT_EQ(s.kore.lanes.bulk, d.kore.lanes.bulk);
+  EXPECT_EQ(s.kore.lanes.weights, d.kore.lanes.weights);
+  EXPECT_EQ(s.kore.batch.window_us, d.kore.batch.window_us);
+  EXPECT_EQ(s.kore.batch.max_bytes, d.kore.batch.max_bytes);
+  EXPECT_EQ(s.kore.keepalive.interval_ms, d.kore.keepalive.interval_ms);
+  EXPECT_EQ(s.kore.keepalive.min_interval_ms, d.kore.keepalive.min_interval_ms);
+  EXPECT_EQ(s.kore.keepalive.dead_after_ms, d.kore.keepalive.dead_after_ms);
+  EXPECT_EQ(s.kore.replay.buffer_bytes, d.kore.replay.buffer_bytes);
+  EXPECT_EQ(s.kore.spill.enabled, d.kore.spill.enabled);
+  EXPECT_EQ(s.kore.spill.segment_bytes, d.kore.spill.segment_bytes);
+  EXPECT_EQ(s.kore.spill.max_bytes, d.kore.spill.max_bytes);
+  EXPECT_EQ(s.kore.spill.drain_bytes_per_sec, d.kore.spill.drain_bytes_per_sec);
+  EXPECT_EQ(s.relay.ioThreads, d.relay.ioThreads);
+  EXPECT_EQ(s.relay.ioCpus, d.relay.ioCpus);
+  EXPECT_EQ(s.relay.ioSpinUs, d.relay.ioSpinUs);
+  EXPECT_EQ(s.relay.ioHighPriority, d.relay.ioHighPriority);
+  EXPECT_EQ(s.relay.framing, d.relay.framing);
+  EXPECT_EQ(s.relay.compressMin, d.relay.compressMin);
+  EXPECT_EQ(s.relay.dictionary, d.relay.dictionary);
+}
+
+TEST(ConfigToml, TuningKeysDefaultWhenSectionsMissing)
+{
+  Settings s = load_text("no-tuning.toml", "[kore]\nhost=\"10.0.0.1\"\n");
+
+  EXPECT_EQ(s.socketLogFormat, "text");
+  EXPECT_EQ(s.socketSampleEvery, 1u);
+  EXPECT_EQ(s.socketRateLimit, 20u);
+  EXPECT_TRUE(s.flightRecorder);
+  EXPECT_EQ(s.flightRecorderBytes, 8u << 20);
+  EXPECT_EQ(s.flightRecorderSeconds, 60u);
+  EXPECT_EQ(s.kore.pool_size, 1u);
+  EXPECT_EQ(s.kore.connect_race, 1u);
+  EXPECT_EQ(s.kore.transport, "tcp");
+  EXPECT_EQ(s.kore.shm_ring_bytes, 1u << 20);
+  EXPECT_TRUE(s.kore.handshake.enabled);
+  EXPECT_EQ(s.kore.handshake.timeout_ms, 1000);
+  EXPECT_EQ(s.kore.queue.max_bytes, 8u << 20);
+  EXPECT_EQ(s.kore.queue.max_frames, 0u);
+  EXPECT_EQ(s.kore.queue.ttl_ms, 3000);
+  EXPECT_EQ(s.kore.queue.policy, "drop_oldest");
+  EXPECT_TRUE(s.kore.queue.shed_opcodes.empty());
+  EXPECT_EQ(s.kore.lanes.fallback, "interactive");
+  EXPECT_TRUE(s.kore.lanes.control.empty());
+  EXPECT_TRUE(s.kore.lanes.interactive.empty());
+  EXPECT_TRUE(s.kore.lanes.bulk.empty());
+  EXPECT_EQ(s.kore.lanes.weights, (std::vector<unsigned>{8, 4, 1}));
+  EXPECT_EQ(s.kore.batch.window_us, 0);
+  EXPECT_EQ(s.kore.batch.max_bytes, 16u * 1024);
+  EXPECT_EQ(s.kore.keepalive.interval_ms, 5000);
+  EXPECT_EQ(s.kore.keepalive.min_interval_ms, 250);
+  EXPECT_EQ(s.kore.keepalive.dead_after_ms, 15000);
+  EXPECT_EQ(s.kore.replay.buffer_bytes, 0u);
+  EXPECT_FALSE(s.kore.spill.enabled);
+  EXPECT_EQ(s.kore.spill.segment_bytes, 16u << 20);
+  EXPECT_EQ(s.kore.spill.max_bytes, 1u << 30);
+  EXPECT_EQ(s.kore.spill.drain_bytes_per_sec, 4u << 20);
+  EXPECT_EQ(s.relay.ioThreads, 2);
+  EXPECT_TRUE(s.relay.ioCpus.empty());
+  EXPECT_EQ(s.relay.ioSpinUs, 0);
+  EXPECT_FALSE(s.relay.ioHighPriority);
+  EXPECT_EQ(s.relay.framing, "none");
+  EXPECT_EQ(s.relay.compressMin, 256u);
+  EXPECT_TRUE(s.relay.dictionary.empty());
+}
+
+TEST(ConfigToml, ReadsLoggingTuning)
+{
+  Settings s = load_text("logging-tuning.toml",
+                         "[logging]\nsocketLogFormat=\"binary\"\nsampleEvery=10\nrateLimit=0\n"
+                         "flightRecorder=false\nflightRecorderBytes=1024\n"
+                         "flightRecorderSeconds=0\n");
+
+  EXPECT_EQ(s.socketLogFormat, "binary");
+  EXPECT_EQ(s.socketSampleEvery, 10u);
+  EXPECT_EQ(s.socketRateLimit, 0u);
+  EXPECT_FALSE(s.flightRecorder);
+  EXPECT_EQ(s.flightRecorderBytes, 1024u);
+  EXPECT_EQ(s.flightRecorderSeconds, 0u);
+}
+
+TEST(ConfigToml, InvalidLoggingTuningKeepsDefaults)
+{
+  Settings s = load_text("logging-invalid.toml",
+                         "[logging]\nsocketLogFormat=3\nsampleEvery=0\nrateLimit=-1\n"
+                         "flightRecorder=\"yes\"\nflightRecorderBytes=0\n"
+                         "flightRecorderSeconds=-5\n");
+
+  EXPECT_EQ(s.socketLogFormat, "text");
+  EXPECT_EQ(s.socketSampleEvery, 1u);
+  EXPECT_EQ(s.socketRateLimit, 20u);
+  EXPECT_TRUE(s.flightRecorder);
+  EXPECT_EQ(s.flightRecorderBytes, 8u << 20);
+  EXPECT_EQ(s.flightRecorderSeconds, 60u);
+}
+
+TEST(ConfigToml, ReadsKorePoolAndTransport)
+{
+  Settings s = load_text("kore-pool.toml",
+                         "[kore]\nports=[6000,6001]\npool_size=3\nconnect_race=2\n"
+                         "transport=\"shm\"\nshm_ring_bytes=65536\n");
+
+  EXPECT_EQ(s.kore.ports, (std::vector<uint16_t>{6000, 6001}));
+  EXPECT_EQ(s.kore.pool_size, 3u);
+  EXPECT_EQ(s.kore.connect_race, 2u);
+  EXPECT_EQ(s.kore.transport, "shm");
+  EXPECT_EQ(s.kore.shm_ring_bytes, 65536u);
+}
+
+TEST(ConfigToml, InvalidKorePoolAndTransportKeepDefaults)
+{
+  Settings s = load_text("kore-pool-invalid.toml",
+                         "[kore]\nports=[]\npool_size=0\nconnect_race=-2\ntransport=1\n"
+                         "shm_ring_bytes=0\n");
+
+  EXPECT_EQ(s.kore.ports, (std::vector<uint16_t>{5293, 5294, 5295}));
+  EXPECT_EQ(s.kore.pool_size, 1u);
+  EXPECT_EQ(s.kore.connect_race, 1u);
+  EXPECT_EQ(s.kore.transport, "tcp");
+  EXPECT_EQ(s.kore.shm_ring_bytes, 1u << 20);
+}
+
+TEST(ConfigToml, ReadsKoreHandshakeAndQueue)
+{
+  Settings s = load_text("kore-queue.toml",
+                         "[kore.handshake]\nenabled=false\ntimeout_ms=250\n"
+                         "\n[kore.queue]\nmax_bytes=0\nmax_frames=500\nttl_ms=0\n"
+                         "policy=\"drop_class\"\nshed_opcodes=[0x0087, 0x09FD]\n");
+
+  EXPECT_FALSE(s.kore.handshake.enabled);
+  EXPECT_EQ(s.kore.handshake.timeout_ms, 250);
+  EXPECT_EQ(s.kore.queue.max_bytes, 0u);
+  EXPECT_EQ(s.kore.queue.max_frames, 500u);
+  EXPECT_EQ(s.kore.queue.ttl_ms, 0);
+  EXPECT_EQ(s.kore.queue.policy, "drop_class");
+  EXPECT_EQ(s.kore.queue.shed_opcodes, (std::vector<uint16_t>{0x0087, 0x09FD}));
+}
+
+TEST(ConfigToml, InvalidKoreHandshakeAndQueueKeepDefaults)
+{
+  Settings s = load_text("kore-queue-invalid.toml",
+                         "[kore.handshake]\nenabled=\"no\"\ntimeout_ms=0\n"
+                         "\n[kore.queue]\nmax_bytes=-1\nmax_frames=-1\nttl_ms=-1\n"
+                         "policy=false\nshed_opcodes=\"0x0087\"\n");
+
+  EXPECT_TRUE(s.kore.handshake.enabled);
+  EXPECT_EQ(s.kore.handshake.timeout_ms, 1000);
+  EXPECT_EQ(s.kore.queue.max_bytes, 8u << 20);
+  EXPECT_EQ(s.kore.queue.max_frames, 0u);
+  EXPECT_EQ(s.kore.queue.ttl_ms, 3000);
+  EXPECT_EQ(s.kore.queue.policy, "drop_oldest");
+  EXPECT_TRUE(s.kore.queue.shed_opcodes.empty());
+}
+
+TEST(ConfigToml, ReadsKoreLanes)
+{
+  Settings s = load_text("kore-lanes.toml",
+                         "[kore.lanes]\ndefault=\"bulk\"\ncontrol=[0x0072]\n"
+                         "interactive=[0x0089, 0x0437]\nbulk=[0x00B0]\nweights=[16, 2, 1]\n");
+
+  EXPECT_EQ(s.kore.lanes.fallback, "bulk");
+  EXPECT_EQ(s.kore.lanes.control, (std::vector<uint16_t>{0x0072}));
+  EXPECT_EQ(s.kore.lanes.interactive, (std::vector<uint16_t>{0x0089, 0x0437}));
+  EXPECT_EQ(s.kore.lanes.bulk, (std::vector<uint16_t>{0x00B0}));
+  EXPECT_EQ(s.kore.lanes.weights, (std::vector<unsigned>{16, 2, 1}));
+}
+
+TEST(ConfigToml, InvalidKoreLanesEntriesAreSkipped)
+{
+  Settings s = load_text("kore-lanes-invalid.toml",
+                         "[kore.lanes]\ndefault=2\ncontrol=\"0x0072\"\n"
+                         "interactive=[\"x\", 0x0089]\nweights=[0, -3, 5]\n");
+
+  EXPECT_EQ(s.kore.lanes.fallback, "interactive");
+  EXPECT_TRUE(s.kore.lanes.control.empty());
+  EXPECT_EQ(s.kore.lanes.interactive, (std::vector<uint16_t>{0x0089}));
+  EXPECT_EQ(s.kore.lanes.weights, (std::vector<unsigned>{5}));
+}
+
+TEST(ConfigToml, ReadsKoreBatchKeepaliveAndReplay)
+{
+  Settings s = load_text("kore-batch.toml",
+                         "[kore.batch]\nwindow_us=200\nmax_bytes=4096\n"
+                         "\n[kore.keepalive]\ninterval_ms=1000\nmin_interval_ms=100\n"
+                         "dead_after_ms=0\n"
+                         "\n[kore.replay]\nbuffer_bytes=1048576\n");
+
+  EXPECT_EQ(s.kore.batch.window_us, 200);
+  EXPECT_EQ(s.kore.batch.max_bytes, 4096u);
+  EXPECT_EQ(s.kore.keepalive.interval_ms, 1000);
+  EXPECT_EQ(s.kore.keepalive.min_interval_ms, 100);
+  EXPECT_EQ(s.kore.keepalive.dead_after_ms, 0);
+  EXPECT_EQ(s.kore.replay.buffer_bytes, 1048576u);
+}
+
+TEST(ConfigToml, InvalidKoreBatchKeepaliveAndReplayKeepDefaults)
+{
+  Settings s = load_text("kore-batch-invalid.toml",
+                         "[kore.batch]\nwindow_us=-1\nmax_bytes=0\n"
+                         "\n[kore.keepalive]\ninterval_ms=0\nmin_interval_ms=-10\n"
+                         "dead_after_ms=-1\n"
+                         "\n[kore.replay]\nbuffer_bytes=-1\n");
+
+  EXPECT_EQ(s.kore.batch.window_us, 0);
+  EXPECT_EQ(s.kore.batch.max_bytes, 16u * 1024);
+  EXPECT_EQ(s.kore.keepalive.interval_ms, 5000);
+  EXPECT_EQ(s.kore.keepalive.min_interval_ms, 250);
+  EXPECT_EQ(s.kore.keepalive.dead_after_ms, 15000);
+  EXPECT_EQ(s.kore.replay.buffer_bytes, 0u);
+}
+
+TEST(ConfigToml, ReadsKoreSpill)
+{
+  Settings s = load_text("kore-spill.toml",
+                         "[kore.spill]\nenabled=true\nsegment_bytes=1048576\nmax_bytes=0\n"
+                         "drain_bytes_per_sec=65536\n");
+
+  EXPECT_TRUE(s.kore.spill.enabled);
+  EXPECT_EQ(s.kore.spill.segment_bytes, 1048576u);
+  EXPECT_EQ(s.kore.spill.max_bytes, 0u);
+  EXPECT_EQ(s.kore.spill.drain_bytes_per_sec, 65536u);
+}
+
+TEST(ConfigToml, InvalidKoreSpillKeepsDefaults)
+{
+  Settings s = load_text("kore-spill-invalid.toml",
+                         "[kore.spill]\nenabled=\"true\"\nsegment_bytes=0\nmax_bytes=-1\n"
+                         "drain_bytes_per_sec=0\n");
+
+  EXPECT_FALSE(s.kore.spill.enabled);
+  EXPECT_EQ(s.kore.spill.segment_bytes, 16u << 20);
+  EXPECT_EQ(s.kore.spill.max_bytes, 1u << 30);
+  EXPECT_EQ(s.kore.spill.drain_bytes_per_sec, 4u << 20);
+}
+
+TEST(ConfigToml, ReadsRelayTuning)
+{
+  Settings s = load_text("relay.toml",
+                         "[relay]\nioThreads=4\nioCpus=[2, 3]\nioSpinUs=50\nioHighPriority=true\n"
+                         "framing=\"lz\"\ncompressMin=0\ndictionary=\"ro.dict\"\n");
+
+  EXPECT_EQ(s.relay.ioThreads, 4);
+  EXPECT_EQ(s.relay.ioCpus, (std::vector<int>{2, 3}));
+  EXPECT_EQ(s.relay.ioSpinUs, 50);
+  EXPECT_TRUE(s.relay.ioHighPriority);
+  EXPECT_EQ(s.relay.framing, "lz");
+  EXPECT_EQ(s.relay.compressMin, 0u);
+  EXPECT_EQ(s.relay.dictionary, "ro.dict");
+}
+
+TEST(ConfigToml, InvalidRelayTuningKeepsDefaults)
+{
+  Settings s = load_text("relay-invalid.toml",
+                         "[relay]\nioThreads=65\nioCpus=[-1, 1]\nioSpinUs=2000000\n"
+                         "ioHighPriority=\"on\"\nframing=true\ncompressMin=-1\ndictionary=7\n");
+
+  EXPECT_EQ(s.relay.ioThreads, 2);
+  EXPECT_EQ(s.relay.ioCpus, (std::vector<int>{1}));
+  EXPECT_EQ(s.relay.ioSpinUs, 0);
+  EXPECT_FALSE(s.relay.ioHighPriority);
+  EXPECT_EQ(s.relay.framing, "none");
+  EXPECT_EQ(s.relay.compressMin, 256u);
+  EXPECT_TRUE(s.relay.dictionary.empty());
+}
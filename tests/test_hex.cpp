@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "shared/hex/Hex.hpp"
+
+namespace hex = arkan::relay::shared::hex;
+
+namespace
+{
+
+// What hex_dump produced before the encoder: printf's "%02X " per byte
+std::string reference(const std::vector<std::byte>& v, std::size_t max_len)
+{
+  const std::size_t take = (max_len > 0 && max_len < v.size()) ? max_len : v.size();
+  std::string s;
+  char b[48];
+  for (std::size_t i = 0; i < take; ++i)
+  {
+    std::snprintf(b, sizeof(b), "%02X ", std::to_integer<unsigned>(v[i]));
+    s += b;
+  }
+  if (take < v.size())
+  {
+    std::snprintf(b, sizeof(b), "...(%zu bytes total)", v.size());
+    s += b;
+  }
+  return s;
+}
+
+}  // namespace
+
+TEST(Hex, EncodesEveryByteValueAtEveryLengthAndOffset)
+{
+  std::vector<std::byte> all(256 + 64);
+  for (std::size_t i = 0; i < all.size(); ++i) all[i] = static_cast<std::byte>((i * 7) & 0xFF);
+
+  // lengths around the 16-byte blocks, starting at unaligned offsets; guard bytes catch overruns
+  for (std::size_t off = 0; off < 3; ++off)
+  {
+    for (std::size_t n = 0; n <= 100; ++n)
+    {
+      const std::vector<std::byte> in(all.begin() + off, all.begin() + off + n);
+      std::string out(hex::encoded_size(n) + 4, '#');
+      EXPECT_EQ(hex::encode(in, out.data()), hex::encoded_size(n));
+      EXPECT_EQ(out.substr(0, hex::encoded_size(n)), reference(in, 0)) << "n=" << n;
+      EXPECT_EQ(out.substr(hex::encoded_size(n)), "####") << "n=" << n;
+    }
+  }
+
+  std::vector<std::byte> bytes(256);
+  for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<std::byte>(i);
+  EXPECT_EQ(hex::hex_dump(bytes, 0), reference(bytes, 0));
+}
+
+TEST(Hex, DumpCutsAtMaxLenAndFitsDumpSize)
+{
+  std::vector<std::byte> v(1000, std::byte{0xAB});
+  for (std::size_t max : {std::size_t{0}, std::size_t{1}, std::size_t{16}, std::size_t{64}})
+  {
+    EXPECT_EQ(hex::hex_dump(v, max), reference(v, max));
+    EXPECT_LE(hex::hex_dump(v, max).size(), hex::dump_size(v.size(), max));
+  }
+  EXPECT_EQ(hex::hex_dump(std::span<const std::byte>{}), "");
+  EXPECT_EQ(hex::make_line("[RECV]", std::span<const std::byte>(v.data(), 3), 2),
+            "[RECV] n=3: AB AB ...(3 bytes total)");
+}
@@ -1,18 +1,28 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <boost/asio.hpp>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <future>
 #include <mutex>
+#include <new>
 #include <queue>
+#include <set>
 #include <string_view>
 #include <thread>
 #include <vector>
 
 #include "application/ports/ILogger.hpp"
+#include "domain/protocol/Envelope.hpp"
+#include "infrastructure/link/FragmentAssembler.hpp"
 #include "infrastructure/link/KoreLink_Asio.hpp"
+#include "infrastructure/net/IoPool.hpp"
 
 using tcp = boost::asio::ip::tcp;
 
@@ -29,12 +39,46 @@ static inline uint16_t get_u16_le(const std::byte* p)
          (static_cast<uint16_t>(std::to_integer<unsigned char>(p[1])) << 8);
 }
 
+static inline void put_u32_le(std::byte* dst, uint32_t v)
+{
+  for (int i = 0; i < 4; ++i) dst[i] = static_cast<std::byte>((v >> (8 * i)) & 0xFF);
+}
+
+static inline uint32_t get_u32_le(const std::byte* p)
+{
+  uint32_t v = 0;
+  for (int i = 0; i < 4; ++i) v |= std::to_integer<uint32_t>(p[i]) << (8 * i);
+  return v;
+}
+
 static std::vector<std::byte> bytes_from(const std::string& s)
 {
   return std::vector<std::byte>(reinterpret_cast<const std::byte*>(s.data()),
                                 reinterpret_cast<const std::byte*>(s.data()) + s.size());
 }
 
+// ----------------------------- Allocation counting -----------------------------
+// Counts heap allocations made by threads that set t_count_allocs
+static std::atomic<uint64_t> g_allocs{0};
+static thread_local bool t_count_allocs = false;
+
+void* operator new(std::size_t n)
+{
+  if (t_count_allocs) g_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
 // ----------------------------- Test Logger (no-op) -----------------------------
 struct TestLogger : arkan::relay::application::ports::ILogger
 {
@@ -42,19 +86,40 @@ struct TestLogger : arkan::relay::application::ports::ILogger
   void init(const arkan::relay::domain::Settings&) override {}
   void app(LogLevel, const std::string&) override {}
   void sock(LogLevel, std::string_view) override {}
+  bool enabled(LogLevel) const override
+  {
+    return false;
+  }
 };
 
+// Waits until `n` 'H' answers reached the link: until then its frames are held back and its
+// optional features are off
+static bool wait_handshake(const arkan::relay::infrastructure::link::KoreLink_Asio& link,
+                           uint64_t n = 1)
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (link.stats().hellos < n)
+  {
+    if (std::chrono::steady_clock::now() >= deadline) return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
 // ----------------------------- Fake Kore server -----------------------------
 class FakeKoreServer
 {
  public:
   FakeKoreServer() : io_(), acceptor_(io_), socket_(io_) {}
 
-  uint16_t start()
+  // `recv_buffer` != 0 shrinks the accepted socket's receive buffer (see pause_reading())
+  uint16_t start(int recv_buffer = 0)
   {
     tcp::endpoint ep{boost::asio::ip::make_address("127.0.0.1"), 0};
     acceptor_.open(ep.protocol());
     acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    if (recv_buffer != 0)
+      acceptor_.set_option(boost::asio::socket_base::receive_buffer_size(recv_buffer));
     acceptor_.bind(ep);
     acceptor_.listen();
 
@@ -82,8 +147,12 @@ class FakeKoreServer
 
   void stop()
   {
+    stopping_ = true;
     try
     {
+      // shutdown first: close() alone does not wake the blocked read in read_loop_()
+      boost::system::error_code ec;
+      socket_.shutdown(tcp::socket::shutdown_both, ec);
       socket_.close();
     }
     catch (...)
@@ -114,7 +183,41 @@ class FakeKoreServer
     buf[0] = static_cast<std::byte>(kind);
     put_u16_le(buf.data() + 1, n);
     if (n) std::memcpy(buf.data() + 3, payload.data(), n);
-    boost::asio::write(socket_, boost::asio::buffer(buf));
+    send_raw(buf);
+  }
+
+  // Writes raw bytes as-is (lets tests coalesce or split frames on the wire)
+  void send_raw(std::span<const std::byte> bytes)
+  {
+    std::lock_guard<std::mutex> lk(wm_);
+    boost::asio::write(socket_, boost::asio::buffer(bytes.data(), bytes.size()));
+  }
+
+  // A Kore that stops reading: the relay's writes stall once the socket buffers are full.
+  // stop() on a paused server resets the connection (unread data is pending).
+  void pause_reading(bool on)
+  {
+    paused_ = on;
+  }
+
+  // Keepalive probes are echoed like Kore does (and never queued); off = a silent peer
+  void set_echo(bool on)
+  {
+    echo_ = on;
+  }
+
+  // 'H' is answered like Kore does, with these features; off = a Kore that predates 'H'
+  void set_hello(bool answer, uint32_t features = 0xFFFFFFFFu, uint32_t max_frame = 0)
+  {
+    hello_ = answer;
+    features_ = features;
+    max_frame_ = max_frame;
+  }
+
+  // features the relay offered in its last 'H'
+  uint32_t offered() const
+  {
+    return offered_;
   }
 
   bool wait_pop(char& kind, std::vector<std::byte>& payload,
@@ -136,12 +239,29 @@ class FakeKoreServer
     {
       for (;;)
       {
+        while (paused_ && !stopping_) std::this_thread::sleep_for(std::chrono::milliseconds(1));
         std::array<std::byte, 3> hdr{};
         boost::asio::read(socket_, boost::asio::buffer(hdr.data(), hdr.size()));
         char k = static_cast<char>(std::to_integer<unsigned char>(hdr[0]));
         uint16_t n = get_u16_le(hdr.data() + 1);
         std::vector<std::byte> body(n);
         if (n) boost::asio::read(socket_, boost::asio::buffer(body.data(), body.size()));
+        if (k == 'K')
+        {
+          if (echo_) send_frame(k, body);
+          continue;
+        }
+        if (k == 'H')
+        {
+          if (body.size() >= 6) offered_ = get_u32_le(body.data() + 2);
+          if (!hello_) continue;
+          std::array<std::byte, 10> p{};
+          put_u16_le(p.data(), 1);
+          put_u32_le(p.data() + 2, features_);
+          put_u32_le(p.data() + 6, max_frame_);
+          send_frame('H', p);
+          continue;
+        }
         {
           std::lock_guard<std::mutex> lk(m_);
           q_.emplace(k, std::move(body));
@@ -161,7 +281,14 @@ class FakeKoreServer
   uint16_t port_{0};
   std::thread th_accept_;
 
-  std::mutex m_;
+  std::mutex m_, wm_;
+  std::atomic<bool> echo_{true};
+  std::atomic<bool> paused_{false};
+  std::atomic<bool> stopping_{false};
+  std::atomic<bool> hello_{true};
+  std::atomic<uint32_t> features_{0xFFFFFFFFu};
+  std::atomic<uint32_t> max_frame_{0};
+  std::atomic<uint32_t> offered_{0};
   std::condition_variable cv_, cv_conn_;
   bool connected_ = false;
   std::queue<std::pair<char, std::vector<std::byte>>> q_;
@@ -174,8 +301,8 @@ TEST(KoreLinkAsio, SendsFramesToServer)
   FakeKoreServer server;
   const uint16_t port = server.start();
 
-  // Link (default constructor in the current scenario)
-  arkan::relay::infrastructure::link::KoreLink_Asio link;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
 
   // Configure candidates and connect
   const std::string host = "127.0.0.1";
@@ -185,15 +312,15 @@ TEST(KoreLinkAsio, SendsFramesToServer)
   // Wait for server accept
   ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
 
-  // Send an 'S' frame
+  // Send an 'R' frame ('S' frames are not forwarded to Kore)
   auto payload = bytes_from("hello");
-  link.send_frame('S', payload);
+  link.send_frame('R', payload);
 
   // Server must receive the frame
   char kind;
   std::vector<std::byte> got;
   ASSERT_TRUE(server.wait_pop(kind, got));
-  EXPECT_EQ(kind, 'S');
+  EXPECT_EQ(kind, 'R');
   ASSERT_EQ(got.size(), payload.size());
   EXPECT_TRUE(std::equal(got.begin(), got.end(), payload.begin(), payload.end()));
 
@@ -206,7 +333,8 @@ TEST(KoreLinkAsio, ReceivesFramesFromServer)
   FakeKoreServer server;
   const uint16_t port = server.start();
 
-  arkan::relay::infrastructure::link::KoreLink_Asio link;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
 
   std::mutex m;
   std::condition_variable cv;
@@ -247,3 +375,1472 @@ TEST(KoreLinkAsio, ReceivesFramesFromServer)
   link.close();
   server.stop();
 }
+
+TEST(KoreLinkAsio, AcksAreConsumedByTheLinkWithReplayOff)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<char> kinds;
+  link.on_frame(
+      [&](char k, std::span<const std::byte>)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        kinds.push_back(k);
+        cv.notify_one();
+      });
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // an 'A' from a Kore that acks anyway, then a frame for the callback
+  std::array<std::byte, 4> ack{};
+  put_u32_le(ack.data(), 7);
+  server.send_frame('A', ack);
+  server.send_frame('R', bytes_from("after-ack"));
+
+  {
+    std::unique_lock<std::mutex> lk(m);
+    ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(2000), [&] { return !kinds.empty(); }));
+    EXPECT_EQ(kinds, std::vector<char>{'R'});
+  }
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, BurstIsDeliveredInOrder)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // enough data to wrap and grow the send ring while writes are in flight
+  constexpr int kFrames = 2000;
+  for (int i = 0; i < kFrames; ++i)
+  {
+    std::vector<std::byte> p(2 + (i * 37) % 700, static_cast<std::byte>(i & 0xFF));
+    put_u16_le(p.data(), static_cast<uint16_t>(i));
+    link.send_frame('R', p);
+  }
+
+  for (int i = 0; i < kFrames; ++i)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(kind, 'R');
+    ASSERT_GE(got.size(), 2u);
+    EXPECT_EQ(get_u16_le(got.data()), static_cast<uint16_t>(i));
+  }
+
+  const auto st = link.stats();
+  EXPECT_EQ(st.frames_written, static_cast<uint64_t>(kFrames));
+  EXPECT_LE(st.writes, st.frames_written);
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, ReserveCommitFromManyProducers)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // payload = [producer id][seq16][filler...]
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 500;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kProducers; ++t)
+  {
+    producers.emplace_back(
+        [&link, t]
+        {
+          for (int i = 0; i < kPerProducer; ++i)
+          {
+            const std::size_t len = 3 + (i % 200);
+            auto r = link.reserve('R', len);
+            if (r)
+            {
+              r.payload[0] = static_cast<std::byte>(t);
+              put_u16_le(r.payload.data() + 1, static_cast<uint16_t>(i));
+              std::memset(r.payload.data() + 3, 0xAB, len - 3);
+              link.commit(r);
+            }
+            else
+            {
+              std::vector<std::byte> p(len, std::byte{0xAB});
+              p[0] = static_cast<std::byte>(t);
+              put_u16_le(p.data() + 1, static_cast<uint16_t>(i));
+              link.send_frame('R', p);
+            }
+          }
+        });
+  }
+  for (auto& th : producers) th.join();
+
+  std::array<int, kProducers> next{};
+  for (int n = 0; n < kProducers * kPerProducer; ++n)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << n;
+    ASSERT_EQ(kind, 'R');
+    ASSERT_GE(got.size(), 3u);
+    const int t = std::to_integer<int>(got[0]);
+    ASSERT_LT(t, kProducers);
+    EXPECT_EQ(get_u16_le(got.data() + 1), static_cast<uint16_t>(next[t]));
+    ++next[t];
+  }
+
+  // an 'S' reservation is refused (SEND is not forwarded to Kore)
+  EXPECT_FALSE(link.reserve('S', 4));
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, ParsesCoalescedAndSplitFrames)
+{
+  FakeKoreServer server;
+  server.set_echo(false);  // an echo would land between the pieces of a split frame
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<std::pair<char, std::vector<std::byte>>> frames;
+
+  link.on_frame(
+      [&](char k, std::span<const std::byte> p)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        frames.emplace_back(k, std::vector<std::byte>(p.begin(), p.end()));
+        cv.notify_one();
+      });
+
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link));  // the 'H' answer must not land inside a split frame
+
+  // 100 small 'S' frames + one empty 'K' + one 40000-byte 'S', all in a single buffer
+  std::vector<std::byte> wire;
+  auto append = [&](char k, std::size_t n, std::byte fill)
+  {
+    const std::size_t at = wire.size();
+    wire.resize(at + 3 + n, fill);
+    wire[at] = static_cast<std::byte>(k);
+    put_u16_le(wire.data() + at + 1, static_cast<uint16_t>(n));
+  };
+  for (int i = 0; i < 100; ++i) append('S', 4 + i % 8, static_cast<std::byte>(i));
+  append('K', 0, std::byte{0});
+  append('S', 40000, std::byte{0x5A});
+
+  // send it in uneven pieces, splitting headers and payloads across reads
+  const std::size_t cuts[] = {1, 2, 7, 250, 1000, 20000};
+  std::size_t off = 0;
+  for (std::size_t c : cuts)
+  {
+    server.send_raw(std::span<const std::byte>(wire.data() + off, c));
+    off += c;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  server.send_raw(std::span<const std::byte>(wire.data() + off, wire.size() - off));
+
+  std::unique_lock<std::mutex> lk(m);
+  ASSERT_TRUE(
+      cv.wait_for(lk, std::chrono::milliseconds(3000), [&] { return frames.size() == 102u; }));
+
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(frames[i].first, 'S');
+    ASSERT_EQ(frames[i].second.size(), static_cast<std::size_t>(4 + i % 8));
+    EXPECT_EQ(frames[i].second.front(), static_cast<std::byte>(i));
+  }
+  EXPECT_EQ(frames[100].first, 'K');
+  EXPECT_TRUE(frames[100].second.empty());
+  EXPECT_EQ(frames[101].first, 'S');
+  ASSERT_EQ(frames[101].second.size(), 40000u);
+  EXPECT_EQ(frames[101].second.back(), std::byte{0x5A});
+  lk.unlock();
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, PoolSpreadsFramesAndFailsOver)
+{
+  FakeKoreServer s1, s2;
+  const uint16_t p1 = s1.start();
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.pool_size = 2;
+  link.set_options(opt);
+
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({p1, p2});
+  link.connect(host, p1);
+  ASSERT_TRUE(s1.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(s2.wait_connected(std::chrono::milliseconds(2000)));
+
+  // every frame arrives exactly once, on whichever connection carried it
+  auto send_and_collect = [&](int first, int count, bool use_s1) -> std::vector<int>
+  {
+    for (int i = first; i < first + count; ++i)
+    {
+      std::vector<std::byte> p(2 + i % 300, std::byte{0x11});
+      put_u16_le(p.data(), static_cast<uint16_t>(i));
+      link.send_frame('R', p);
+    }
+    std::vector<int> seen;
+    int idle = 0;
+    while (static_cast<int>(seen.size()) < count && idle < 200)
+    {
+      char kind;
+      std::vector<std::byte> got;
+      bool any = false;
+      for (FakeKoreServer* s : {use_s1 ? &s1 : nullptr, &s2})
+      {
+        while (s && s->wait_pop(kind, got, std::chrono::milliseconds(0)))
+        {
+          any = true;
+          if (kind == 'R') seen.push_back(get_u16_le(got.data()));  // skip keepalives
+        }
+      }
+      if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      idle = any ? 0 : idle + 1;
+    }
+    std::sort(seen.begin(), seen.end());
+    return seen;
+  };
+
+  auto seen = send_and_collect(0, 300, true);
+  ASSERT_EQ(seen.size(), 300u);
+  for (int i = 0; i < 300; ++i) EXPECT_EQ(seen[i], i);
+
+  // lose one Kore port: the surviving connection carries everything from now on
+  s1.stop();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (link.stats().failovers == 0 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  ASSERT_EQ(link.stats().failovers, 1u);
+
+  seen = send_and_collect(300, 300, false);
+  ASSERT_EQ(seen.size(), 300u);
+  for (int i = 0; i < 300; ++i) EXPECT_EQ(seen[i], 300 + i);
+
+  link.close();
+  s2.stop();
+}
+
+TEST(KoreLinkAsio, PoolResendsAFailedWriteOnTheOtherConnection)
+{
+  FakeKoreServer s1, s2;
+  const uint16_t p1 = s1.start(4096);
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.pool_size = 2;
+  opt.queue.max_bytes = 0;
+  opt.queue.ttl = std::chrono::milliseconds(0);
+  link.set_options(opt);
+  link.set_candidate_ports({p1, p2});
+  link.connect("127.0.0.1", p1);
+  ASSERT_TRUE(s1.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(s2.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link, 2));
+
+  // Kore #1 stops reading: once its socket buffers are full, a gathered write stalls on it
+  s1.pause_reading(true);
+  constexpr uint64_t kFrames = 8000;
+  for (uint64_t i = 0; i < kFrames; ++i)
+  {
+    std::vector<std::byte> p(1000, std::byte{0x5A});
+    put_u16_le(p.data(), static_cast<uint16_t>(i));
+    link.send_frame('R', p);
+  }
+
+  std::set<uint16_t> seen;
+  auto collect = [&](std::size_t want)
+  {
+    int idle = 0;
+    while (seen.size() < want && idle < 50)
+    {
+      char kind;
+      std::vector<std::byte> got;
+      if (!s2.wait_pop(kind, got, std::chrono::milliseconds(10)))
+      {
+        ++idle;
+        continue;
+      }
+      idle = 0;
+      if (kind == 'R') EXPECT_TRUE(seen.insert(get_u16_le(got.data())).second);
+    }
+  };
+  collect(kFrames);
+
+  // the frames Kore #1's socket accepted are gone with it; the stalled write is not
+  const uint64_t written = link.stats().frames_written;
+  ASSERT_LT(written, kFrames);
+  const std::size_t gone = static_cast<std::size_t>(written) - seen.size();
+
+  s1.stop();
+  collect(kFrames - gone);
+  EXPECT_EQ(seen.size(), kFrames - gone);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (link.stats().frames_written < kFrames && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(link.stats().frames_written, kFrames);
+
+  link.close();
+  s2.stop();
+}
+
+// ----------------------------- Load shedding -----------------------------
+namespace
+{
+// payload = [opcode16][seq16]
+std::vector<std::byte> op_frame(uint16_t opcode, uint16_t seq)
+{
+  std::vector<std::byte> p(4);
+  put_u16_le(p.data(), opcode);
+  put_u16_le(p.data() + 2, seq);
+  return p;
+}
+
+bool wait_stat(arkan::relay::infrastructure::link::KoreLink_Asio& link,
+               uint64_t arkan::relay::infrastructure::link::KoreLink_Asio::Stats::*field,
+               uint64_t want)
+{
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while ((link.stats().*field) < want && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  return (link.stats().*field) == want;
+}
+}  // namespace
+
+TEST(KoreLinkAsio, QueueCapDropsOldestWhileDisconnected)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.queue.max_frames = 10;
+  opt.queue.ttl = std::chrono::milliseconds(0);
+  link.set_options(opt);
+
+  // nothing is connected yet: only the 10 most recent frames may survive
+  for (uint16_t i = 0; i < 100; ++i) link.send_frame('R', op_frame(0x0001, i));
+  ASSERT_TRUE(wait_stat(link, &Stats::shed_overflow, 90));
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  for (uint16_t i = 90; i < 100; ++i)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(get_u16_le(got.data() + 2), i);
+  }
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, OverflowSpillsToDiskAndDrainsInOrder)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / "arkan-relay-spill";
+  fs::remove_all(dir);
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  {
+    TestLogger log;
+    arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+    arkan::relay::application::ports::LinkOptions opt;
+    opt.queue.max_bytes = 16 * 1024;
+    opt.queue.ttl = std::chrono::milliseconds(0);
+    opt.spill.dir = dir.string();
+    opt.spill.segment_bytes = 128 * 1024;  // a few segments' worth below
+    opt.spill.drain_rate = 64u << 20;
+    link.set_options(opt);
+
+    // Kore unreachable: everything past the queue cap goes to the journal, nothing is shed
+    constexpr uint16_t kFrames = 4000;
+    for (uint16_t i = 0; i < kFrames; ++i)
+    {
+      auto p = op_frame(0x0001, i);
+      p.resize(100, std::byte{0x5A});
+      link.send_frame('R', p);
+    }
+    ASSERT_TRUE(wait_stat(link, &Stats::spilled, kFrames - 16 * 1024 / 103));
+    EXPECT_EQ(link.stats().shed_overflow, 0u);
+    EXPECT_GT(link.stats().spill_queued_bytes, 3u * 128 * 1024);
+
+    link.set_candidate_ports({port});
+    link.connect("127.0.0.1", port);
+    ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+    for (uint16_t i = 0; i < kFrames; ++i)
+    {
+      char kind;
+      std::vector<std::byte> got;
+      ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+      ASSERT_EQ(get_u16_le(got.data() + 2), i);
+    }
+    EXPECT_EQ(link.stats().unspilled, link.stats().spilled);
+    EXPECT_EQ(link.stats().spill_queued_bytes, 0u);
+
+    link.close();
+  }
+  server.stop();
+
+  // the journal is scratch: nothing is left behind
+  EXPECT_TRUE(fs::is_empty(dir));
+  fs::remove_all(dir);
+}
+
+TEST(KoreLinkAsio, SpilledFramesKeepTheirAgeAcrossTheJournal)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / "arkan-relay-spill-ttl";
+  fs::remove_all(dir);
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  {
+    TestLogger log;
+    arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+    arkan::relay::application::ports::LinkOptions opt;
+    opt.queue.max_bytes = 4 * 1024;
+    opt.queue.ttl = std::chrono::milliseconds(150);
+    opt.spill.dir = dir.string();
+    opt.spill.drain_rate = 64u << 20;
+    link.set_options(opt);
+
+    // Kore unreachable past the TTL: nothing expires while there is no connection, the overflow
+    // is spilled
+    constexpr uint16_t kOld = 200, kFresh = 50;
+    auto frame = [](uint16_t i)
+    {
+      auto p = op_frame(0x0001, i);
+      p.resize(100, std::byte{0x5A});
+      return p;
+    };
+    for (uint16_t i = 0; i < kOld; ++i) link.send_frame('R', frame(i));
+    ASSERT_TRUE(wait_stat(link, &Stats::spilled, kOld - 4 * 1024 / 103));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    link.send_frame('R', frame(kOld));  // a flush while offline
+    EXPECT_EQ(link.stats().shed_expired, 0u);
+
+    // once Kore is back, the TTL counts from when each frame was first queued, journal or not
+    for (uint16_t i = kOld + 1; i < kOld + kFresh; ++i) link.send_frame('R', frame(i));
+    link.set_candidate_ports({port});
+    link.connect("127.0.0.1", port);
+    ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+    char kind;
+    std::vector<std::byte> got;
+    do
+    {
+      ASSERT_TRUE(server.wait_pop(kind, got));
+    } while (kind != 'R');
+    EXPECT_EQ(get_u16_le(got.data() + 2), kOld);
+    for (uint16_t i = kOld + 1; i < kOld + kFresh; ++i)
+    {
+      ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+      ASSERT_EQ(get_u16_le(got.data() + 2), i);
+    }
+    EXPECT_EQ(link.stats().shed_expired, kOld);
+    EXPECT_EQ(link.stats().spill_queued_bytes, 0u);
+
+    link.close();
+  }
+  server.stop();
+  fs::remove_all(dir);
+}
+
+TEST(KoreLinkAsio, QueueDropsExpiredAndSheddableFrames)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  using arkan::relay::application::ports::ShedPolicy;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.queue.max_frames = 8;
+  opt.queue.ttl = std::chrono::milliseconds(100);
+  opt.queue.policy = ShedPolicy::drop_class;
+  opt.queue.shed_opcodes = {0x0087};
+  link.set_options(opt);
+
+  // stale frames never reach Kore
+  for (uint16_t i = 0; i < 5; ++i) link.send_frame('R', op_frame(0x0001, 1000 + i));
+  std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+  // 5 important + 5 sheddable + 3 important against a cap of 8: every frame past the cap
+  // displaces the oldest queued 0x0087, the important ones are all kept
+  uint16_t seq = 0;
+  for (int i = 0; i < 5; ++i) link.send_frame('R', op_frame(0x0001, seq++));
+  for (int i = 0; i < 5; ++i) link.send_frame('R', op_frame(0x0087, seq++));
+  for (int i = 0; i < 3; ++i) link.send_frame('R', op_frame(0x0001, seq++));
+  ASSERT_TRUE(wait_stat(link, &Stats::shed_expired, 5));
+  ASSERT_TRUE(wait_stat(link, &Stats::shed_overflow, 5));
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  const uint16_t expect[] = {0, 1, 2, 3, 4, 10, 11, 12};
+  for (uint16_t want : expect)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << want;
+    EXPECT_EQ(get_u16_le(got.data() + 2), want);
+  }
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, SheddingTakesFragmentRunsWholeAndSparesControlFrames)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  using arkan::relay::application::ports::ShedPolicy;
+  namespace env = arkan::relay::domain::protocol::envelope;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.queue.max_frames = 6;
+  opt.queue.ttl = std::chrono::milliseconds(0);
+  opt.queue.policy = ShedPolicy::drop_class;
+  opt.queue.shed_opcodes = {0x0087};
+  opt.handshake.enabled = false;  // 'F' allowed before any Kore answered
+  link.set_options(opt);
+  for (int i = 0; i < 200 && link.peer_features() != env::kFeatAll; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // a control frame whose first bytes look like a sheddable opcode, then a 4-fragment run,
+  // then small frames: the run is the oldest game traffic and must go as a whole
+  link.send_frame('N', op_frame(0x0087, 500));
+  auto jumbo = op_frame(0x0001, 600);
+  jumbo.resize(200000, std::byte{0x11});
+  link.send_frame('R', jumbo);
+  for (uint16_t i = 0; i < 4; ++i) link.send_frame('R', op_frame(0x0001, i));
+  ASSERT_TRUE(wait_stat(link, &Stats::shed_overflow, 4));
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  std::vector<std::pair<char, uint16_t>> seen;
+  for (int i = 0; i < 5; ++i)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_NE(kind, env::kFragment);
+    seen.emplace_back(kind, get_u16_le(got.data() + 2));
+  }
+  const std::vector<std::pair<char, uint16_t>> expect{
+      {'N', 500}, {'R', 0}, {'R', 1}, {'R', 2}, {'R', 3}};
+  EXPECT_EQ(seen, expect);
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, InteractiveLaneOvertakesBulkBacklog)
+{
+  using arkan::relay::application::ports::Lane;
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.lanes.fallback = Lane::interactive;
+  opt.lanes.opcodes = {{0x0BBB, Lane::bulk}};
+  link.set_options(opt);
+
+  // a bulk backlog builds up while disconnected, then one interactive frame arrives
+  constexpr uint16_t kBulk = 200;
+  for (uint16_t i = 0; i < kBulk; ++i)
+  {
+    auto p = op_frame(0x0BBB, i);
+    p.resize(1000, std::byte{0x42});
+    link.send_frame('R', p);
+  }
+  link.send_frame('R', op_frame(0x0001, 0xFFFF));
+
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  char kind;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(server.wait_pop(kind, got));
+  EXPECT_EQ(get_u16_le(got.data()), 0x0001);
+
+  // the bulk lane itself stays in order and is not starved
+  for (uint16_t i = 0; i < kBulk; ++i)
+  {
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "bulk frame " << i;
+    EXPECT_EQ(get_u16_le(got.data()), 0x0BBB);
+    EXPECT_EQ(get_u16_le(got.data() + 2), i);
+  }
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, BatchWindowPacksFramesIntoBatchFrames)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link));
+
+  // Collects `n` 'R' frames (unpacking batches), returns how many wire frames carried them
+  auto collect = [&](uint16_t first, uint16_t n)
+  {
+    std::size_t wire = 0;
+    uint16_t next = first;
+    auto check = [&](char k, std::span<const std::byte> p)
+    {
+      if (k != 'R') return;
+      ASSERT_GE(p.size(), 2u);
+      EXPECT_EQ(get_u16_le(p.data()), next);
+      ++next;
+    };
+    while (next != first + n)
+    {
+      char kind;
+      std::vector<std::byte> got;
+      if (!server.wait_pop(kind, got)) break;
+      ++wire;
+      if (kind == 'B')
+        EXPECT_TRUE(arkan::relay::domain::protocol::envelope::for_each_subframe(got, check));
+      else
+        check(kind, got);
+    }
+    EXPECT_EQ(next, first + n);
+    return wire;
+  };
+  auto send = [&](uint16_t i, std::size_t len)
+  {
+    std::vector<std::byte> p(len, std::byte{0x42});
+    put_u16_le(p.data(), i);
+    link.send_frame('R', p);
+  };
+
+  // window expiry: a burst leaves as a handful of 'B' frames instead of one write per frame
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.batch.window = std::chrono::milliseconds(20);
+  opt.batch.max_bytes = 0;
+  link.set_options(opt);
+  for (uint16_t i = 0; i < 100; ++i) send(i, 64);
+  EXPECT_LT(collect(0, 100), 10u);
+
+  // the counter is bumped by the write completion, which may trail the peer's read
+  for (int i = 0; i < 100 && link.stats().batches == 0; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_GE(link.stats().batches, 1u);
+
+  // byte threshold: with a window far beyond the test timeout the write only goes out once
+  // max_bytes are queued, i.e. with the 40th frame, as a single batch
+  opt.batch.window = std::chrono::seconds(60);
+  opt.batch.max_bytes = 40 * (3 + 100);
+  link.set_options(opt);
+  for (uint16_t i = 100; i < 140; ++i) send(i, 100);
+  EXPECT_EQ(collect(100, 40), 1u);
+
+  link.close();
+  server.stop();
+}
+
+// ----------------------------- Jumbo frames -----------------------------
+
+TEST(KoreLinkAsio, JumboFramesTravelAsFragmentRuns)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<std::pair<char, std::vector<std::byte>>> delivered;
+  link.on_frame(
+      [&](char k, std::span<const std::byte> p)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        delivered.emplace_back(k, std::vector<std::byte>(p.begin(), p.end()));
+        cv.notify_one();
+      });
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link));
+
+  auto pattern = [](std::size_t len, uint16_t opcode)
+  {
+    std::vector<std::byte> p(len);
+    for (std::size_t i = 0; i < len; ++i) p[i] = static_cast<std::byte>((i * 7 + 3) & 0xFF);
+    put_u16_le(p.data(), opcode);
+    return p;
+  };
+
+  // outbound: a 200000-byte packet between two small ones arrives whole and in order
+  const auto small1 = pattern(16, 0x0001);
+  const auto jumbo = pattern(200000, 0x0A0D);
+  const auto small2 = pattern(16, 0x0002);
+  link.send_frame('R', small1);
+  link.send_frame('R', jumbo);
+  link.send_frame('R', small2);
+
+  arkan::relay::infrastructure::link::FragmentAssembler fa;
+  std::vector<std::vector<std::byte>> logical;
+  std::size_t fragments = 0;
+  while (logical.size() < 3)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got));
+    std::span<const std::byte> out = got;
+    if (kind == env::kFragment)
+    {
+      ++fragments;
+      ASSERT_LE(got.size(), env::kMaxPayload);
+      if (!fa.feed(got, kind, out)) continue;
+    }
+    EXPECT_EQ(kind, 'R');
+    logical.emplace_back(out.begin(), out.end());
+  }
+  EXPECT_EQ(fragments, (jumbo.size() + env::kMaxFragmentChunk - 1) / env::kMaxFragmentChunk);
+  EXPECT_EQ(logical[0], small1);
+  EXPECT_EQ(logical[1], jumbo);
+  EXPECT_EQ(logical[2], small2);
+  EXPECT_EQ(fa.dropped(), 0u);
+  EXPECT_EQ(link.stats().fragmented, 1u);
+
+  // inbound: an orphan fragment is dropped, the following run is delivered as one 'S' frame
+  auto fragment = [&](uint8_t flags, std::span<const std::byte> chunk)
+  {
+    std::vector<std::byte> f{std::byte{'S'}, std::byte{flags}};
+    f.insert(f.end(), chunk.begin(), chunk.end());
+    server.send_frame(env::kFragment, f);
+  };
+  const auto big = pattern(150000, 0x0B0B);
+  fragment(env::kFragLast, std::span<const std::byte>(big).first(100));
+  for (std::size_t off = 0; off < big.size(); off += env::kMaxFragmentChunk)
+  {
+    const std::size_t n = (std::min)(env::kMaxFragmentChunk, big.size() - off);
+    uint8_t flags = 0;
+    if (off == 0) flags |= env::kFragFirst;
+    if (off + n == big.size()) flags |= env::kFragLast;
+    fragment(flags, std::span<const std::byte>(big).subspan(off, n));
+  }
+  server.send_frame('K', {});
+
+  {
+    std::unique_lock<std::mutex> lk(m);
+    ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(2000),
+                            [&] { return delivered.size() >= 2; }));
+    EXPECT_EQ(delivered[0].first, 'S');
+    EXPECT_EQ(delivered[0].second, big);
+    EXPECT_EQ(delivered[1].first, 'K');
+  }
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, JumboFrameQueuedWhileDisconnectedIsDeliveredOnConnect)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  link.set_candidate_ports({port});
+
+  // nothing is agreed yet: the run waits in the queue for a Kore that reads fragments
+  std::vector<std::byte> jumbo(150000);
+  for (std::size_t i = 0; i < jumbo.size(); ++i) jumbo[i] = static_cast<std::byte>(i & 0xFF);
+  put_u16_le(jumbo.data(), 0x0A0D);
+  EXPECT_EQ(link.peer_features(), 0u);
+  link.send_frame('R', jumbo);
+  link.send_frame('R', op_frame(0x0001, 1));
+
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  arkan::relay::infrastructure::link::FragmentAssembler fa;
+  std::vector<std::vector<std::byte>> logical;
+  while (logical.size() < 2)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got));
+    std::span<const std::byte> out = got;
+    if (kind == env::kFragment && !fa.feed(got, kind, out)) continue;
+    EXPECT_EQ(kind, 'R');
+    logical.emplace_back(out.begin(), out.end());
+  }
+  EXPECT_EQ(logical[0], jumbo);
+  EXPECT_EQ(logical[1], op_frame(0x0001, 1));
+  EXPECT_EQ(link.stats().shed_unsupported, 0u);
+
+  link.close();
+  server.stop();
+}
+
+// ----------------------------- Racing connect -----------------------------
+
+TEST(KoreLinkAsio, RacingConnectSkipsDeadPortsWithoutBackoff)
+{
+  FakeKoreServer server;
+  const uint16_t live = server.start();
+
+  // bound but not listening: connects are refused. The connection starts at the lowest
+  // candidate, so two dead ports below the live one would cost two backoff rounds one by one.
+  boost::asio::io_context io;
+  std::vector<std::unique_ptr<tcp::acceptor>> dead;
+  std::vector<uint16_t> ports{live};
+  for (uint16_t p = live - 1; p > 1024 && ports.size() < 3; --p)
+  {
+    auto a = std::make_unique<tcp::acceptor>(io);
+    boost::system::error_code ec;
+    a->open(tcp::v4(), ec);
+    a->bind(tcp::endpoint{boost::asio::ip::make_address("127.0.0.1"), p}, ec);
+    if (ec) continue;
+    ports.push_back(p);
+    dead.push_back(std::move(a));
+  }
+  ASSERT_EQ(ports.size(), 3u);
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::ReconnectPolicy pol;
+  pol.initial = std::chrono::milliseconds(3000);
+  pol.jitter_p = 0.0;
+  link.set_reconnect_policy(pol);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.connect_race = 3;
+  link.set_options(opt);
+
+  // "localhost" is resolved once for all three attempts
+  link.set_candidate_ports(ports);
+  link.connect("localhost", live);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(1500)));
+  EXPECT_EQ(link.stats().resolves, 1u);
+
+  link.send_frame('R', bytes_from("first"));
+  char kind;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(server.wait_pop(kind, got));
+  EXPECT_EQ(kind, 'R');
+  EXPECT_EQ(got, bytes_from("first"));
+
+  link.close();
+  server.stop();
+}
+
+// ----------------------------- Keepalive -----------------------------
+
+TEST(KoreLinkAsio, KeepaliveMeasuresRttAndDropsSilentPeer)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.keepalive.interval = std::chrono::milliseconds(100);
+  opt.keepalive.min_interval = std::chrono::milliseconds(20);
+  opt.keepalive.dead_after = std::chrono::milliseconds(300);
+  link.set_options(opt);
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // probes go out on an idle link and every echo is one RTT sample
+  for (int i = 0; i < 200 && link.stats().rtt_samples < 3; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_GE(link.stats().rtt_samples, 3u);
+  EXPECT_LT(link.stats().srtt_us, 100000u);  // loopback
+  EXPECT_EQ(link.stats().dead_peers, 0u);
+
+  // a peer that stops answering is dropped within dead_after (plus one probe timeout)
+  server.set_echo(false);
+  const auto t0 = std::chrono::steady_clock::now();
+  while (link.stats().dead_peers == 0 &&
+         std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(2000))
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(link.stats().dead_peers, 1u);
+  EXPECT_LT(std::chrono::steady_clock::now() - t0, std::chrono::milliseconds(600));
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, UnackedFramesAreReplayedAfterReconnect)
+{
+  using Stats = arkan::relay::infrastructure::link::KoreLink_Asio::Stats;
+  FakeKoreServer s1, s2;
+  const uint16_t p1 = s1.start();
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.replay.buffer_bytes = 64 * 1024;
+  link.set_options(opt);
+  arkan::relay::application::ports::ReconnectPolicy rp;
+  rp.initial = std::chrono::milliseconds(20);
+  rp.jitter_p = 0.0;
+  link.set_reconnect_policy(rp);
+
+  // ports are tried in ascending order: `first` gets the connection, `second` the reconnect
+  FakeKoreServer& first = p1 < p2 ? s1 : s2;
+  FakeKoreServer& second = p1 < p2 ? s2 : s1;
+  link.set_candidate_ports({p1, p2});
+  link.connect("127.0.0.1", p1);
+  ASSERT_TRUE(first.wait_connected(std::chrono::milliseconds(2000)));
+
+  // 'Q' = [session32][stream16][next_seq32]
+  auto expect_sequence = [](FakeKoreServer& s, uint32_t next) -> uint32_t
+  {
+    char kind = 0;
+    std::vector<std::byte> p;
+    EXPECT_TRUE(s.wait_pop(kind, p));
+    EXPECT_EQ(kind, 'Q');
+    if (p.size() != 10) return 0;
+    EXPECT_EQ(get_u16_le(p.data() + 4), 0u);
+    EXPECT_EQ(get_u16_le(p.data() + 6) | (uint32_t{get_u16_le(p.data() + 8)} << 16), next);
+    return get_u16_le(p.data()) | (uint32_t{get_u16_le(p.data() + 2)} << 16);
+  };
+  auto expect_frame = [](FakeKoreServer& s, uint16_t id)
+  {
+    char kind = 0;
+    std::vector<std::byte> p;
+    ASSERT_TRUE(s.wait_pop(kind, p));
+    EXPECT_EQ(kind, 'R');
+    ASSERT_EQ(p.size(), 2u);
+    EXPECT_EQ(get_u16_le(p.data()), id);
+  };
+  auto send = [&](uint16_t id)
+  {
+    std::array<std::byte, 2> p{};
+    put_u16_le(p.data(), id);
+    link.send_frame('R', p);
+  };
+
+  const uint32_t session = expect_sequence(first, 1);
+  for (uint16_t i = 0; i < 10; ++i) send(i);
+  for (uint16_t i = 0; i < 10; ++i) expect_frame(first, i);
+
+  // Kore processed frames 1..4 (ids 0..3) before the connection dropped
+  std::array<std::byte, 4> ack{};
+  put_u16_le(ack.data(), 4);
+  first.send_frame('A', ack);
+  ASSERT_TRUE(wait_stat(link, &Stats::acked, 4));
+  first.stop();
+
+  // the next connection resumes at seq 5: ids 4..9 again, then new frames
+  ASSERT_TRUE(second.wait_connected(std::chrono::milliseconds(2000)));
+  EXPECT_EQ(expect_sequence(second, 5), session);
+  for (uint16_t i = 4; i < 10; ++i) expect_frame(second, i);
+  send(10);
+  expect_frame(second, 10);
+  EXPECT_EQ(link.stats().replayed, 6u);
+  EXPECT_EQ(link.stats().replay_evicted, 0u);
+
+  link.close();
+  second.stop();
+}
+
+TEST(KoreLinkAsio, UnackedFramesMoveToTheRestOfThePool)
+{
+  FakeKoreServer s1, s2;
+  s2.set_hello(false);  // held in its handshake: every frame goes to Kore #1 meanwhile
+  const uint16_t p1 = s1.start();
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.pool_size = 2;
+  opt.replay.buffer_bytes = 64 * 1024;
+  opt.handshake.timeout = std::chrono::milliseconds(300);
+  link.set_options(opt);
+  link.set_candidate_ports({p1, p2});
+  link.connect("127.0.0.1", p1);
+  ASSERT_TRUE(s1.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(s2.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link));
+
+  char kind = 0;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(s1.wait_pop(kind, got));
+  EXPECT_EQ(kind, 'Q');
+  for (uint16_t i = 0; i < 10; ++i) link.send_frame('R', op_frame(0x0001, i));
+  for (uint16_t i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(s1.wait_pop(kind, got));
+    EXPECT_EQ(got, op_frame(0x0001, i));
+  }
+
+  // Kore #1 goes away without acknowledging anything: Kore #2 gets the frames, in order,
+  // instead of them waiting for #1 to come back
+  s1.stop();
+  for (uint16_t i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(s2.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(kind, 'R');
+    EXPECT_EQ(got, op_frame(0x0001, i));
+  }
+  link.send_frame('R', op_frame(0x0001, 10));
+  ASSERT_TRUE(s2.wait_pop(kind, got));
+  EXPECT_EQ(got, op_frame(0x0001, 10));
+
+  link.close();
+  s2.stop();
+}
+
+TEST(KoreLinkAsio, CreditFromKoreGatesWrites)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  auto grant = [&](uint32_t bytes, uint32_t frames, uint64_t grants)
+  {
+    std::array<std::byte, 8> p{};
+    for (int i = 0; i < 4; ++i)
+    {
+      p[i] = static_cast<std::byte>((bytes >> (8 * i)) & 0xFF);
+      p[4 + i] = static_cast<std::byte>((frames >> (8 * i)) & 0xFF);
+    }
+    server.send_frame('C', p);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (link.stats().credit_grants < grants && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    ASSERT_EQ(link.stats().credit_grants, grants);
+  };
+  auto expect_frames = [&](uint8_t from, uint8_t to)
+  {
+    for (uint8_t i = from; i < to; ++i)
+    {
+      char kind = 0;
+      std::vector<std::byte> got;
+      ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << int(i);
+      ASSERT_EQ(got.size(), 32u);
+      EXPECT_EQ(std::to_integer<uint8_t>(got[0]), i);
+    }
+    char kind = 0;
+    std::vector<std::byte> extra;
+    EXPECT_FALSE(server.wait_pop(kind, extra, std::chrono::milliseconds(100)));
+  };
+
+  // a frame grant alone leaves bytes unlimited
+  grant(0, 3, 1);
+  for (uint8_t i = 0; i < 10; ++i)
+  {
+    std::vector<std::byte> p(32, std::byte{0});
+    p[0] = static_cast<std::byte>(i);
+    link.send_frame('R', p);
+  }
+  expect_frames(0, 3);
+  EXPECT_GE(link.stats().credit_stalls, 1u);
+
+  // out of bytes: one whole frame still goes out on a credit smaller than itself
+  grant(1, 100, 2);
+  expect_frames(3, 4);
+
+  grant(1000, 0, 3);
+  expect_frames(4, 10);
+
+  link.close();
+  server.stop();
+}
+
+// ----------------------------- Handshake -----------------------------
+
+TEST(KoreLinkAsio, HandshakeUsesOnlyFeaturesKoreAnnounced)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  FakeKoreServer server;
+  server.set_hello(true, env::kFeatTimestamps, 100);
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.batch.window = std::chrono::milliseconds(20);
+  opt.batch.max_bytes = 0;
+  link.set_options(opt);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link));
+
+  EXPECT_NE(server.offered() & env::kFeatBatch, 0u);
+  EXPECT_NE(server.offered() & env::kFeatFragments, 0u);
+  EXPECT_EQ(link.peer_features(), env::kFeatTimestamps);
+
+  // batching is configured but Kore did not announce 'B': every frame goes out on its own
+  for (uint16_t i = 0; i < 20; ++i) link.send_frame('R', op_frame(0x0001, i));
+  for (uint16_t i = 0; i < 20; ++i)
+  {
+    char kind = 0;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(kind, 'R');
+    EXPECT_EQ(got, op_frame(0x0001, i));
+  }
+  EXPECT_EQ(link.stats().batches, 0u);
+
+  // payloads over Kore's max_frame are refused
+  std::vector<std::byte> big(101, std::byte{0x42});
+  link.send_frame('R', big);
+  big.resize(100);
+  link.send_frame('R', big);
+  char kind = 0;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(server.wait_pop(kind, got));
+  EXPECT_EQ(got.size(), 100u);
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, FramesNeedingAFeatureOnlyReachAKoreThatAgreed)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  FakeKoreServer s1, s2;
+  s2.set_hello(true, env::kFeatTimestamps);  // an older Kore: no 'F', no 'Z'
+  const uint16_t p1 = s1.start();
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.pool_size = 2;
+  opt.handshake.features = env::kFeatCompress;
+  link.set_options(opt);
+  link.set_candidate_ports({p1, p2});
+  link.connect("127.0.0.1", p1);
+  ASSERT_TRUE(s1.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(s2.wait_connected(std::chrono::milliseconds(2000)));
+  ASSERT_TRUE(wait_handshake(link, 2));
+
+  // producers may only rely on what both connections agreed to
+  EXPECT_EQ(link.peer_features(), env::kFeatTimestamps);
+
+  // 'Z' frames are left to the connection that agreed to them
+  for (uint16_t i = 0; i < 20; ++i) link.send_frame('Z', op_frame(0x0001, i));
+  std::vector<uint16_t> seen;
+  char kind = 0;
+  std::vector<std::byte> got;
+  while (seen.size() < 20 && s1.wait_pop(kind, got))
+    if (kind == 'Z') seen.push_back(get_u16_le(got.data() + 2));
+  ASSERT_EQ(seen.size(), 20u);
+  for (uint16_t i = 0; i < 20; ++i) EXPECT_EQ(seen[i], i);
+  while (s2.wait_pop(kind, got, std::chrono::milliseconds(50))) EXPECT_NE(kind, 'Z');
+
+  // with only the older Kore left, they are shed instead of written in a form it cannot read
+  s1.stop();
+  ASSERT_TRUE(wait_stat(link, &arkan::relay::infrastructure::link::KoreLink_Asio::Stats::failovers,
+                        1));
+  EXPECT_EQ(link.peer_features(), env::kFeatTimestamps);
+  link.send_frame('Z', op_frame(0x0001, 20));
+  link.send_frame('R', op_frame(0x0001, 21));
+  do
+  {
+    ASSERT_TRUE(s2.wait_pop(kind, got));
+  } while (kind != 'R');
+  EXPECT_EQ(got, op_frame(0x0001, 21));
+  EXPECT_EQ(link.stats().shed_unsupported, 1u);
+
+  // nothing is agreed while no Kore is connected
+  s2.stop();
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (link.peer_features() != 0 && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(link.peer_features(), 0u);
+
+  link.close();
+}
+
+TEST(KoreLinkAsio, KoreWithoutHelloGetsOriginalEnvelope)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  FakeKoreServer server;
+  server.set_hello(false);
+  const uint16_t port = server.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log);
+  arkan::relay::application::ports::LinkOptions opt;
+  opt.handshake.timeout = std::chrono::milliseconds(100);
+  opt.batch.window = std::chrono::milliseconds(5);
+  link.set_options(opt);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // held back until the answer is given up on, then written as plain frames
+  for (uint16_t i = 0; i < 5; ++i) link.send_frame('R', op_frame(0x0001, i));
+  for (uint16_t i = 0; i < 5; ++i)
+  {
+    char kind = 0;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(kind, 'R');
+    EXPECT_EQ(got, op_frame(0x0001, i));
+  }
+  EXPECT_EQ(link.stats().hello_timeouts, 1u);
+  EXPECT_EQ(link.stats().hellos, 0u);
+  EXPECT_EQ(link.peer_features(), 0u);
+
+  // without 'F' the original 65535-byte limit applies: the run is shed, not written
+  link.send_frame('R', std::vector<std::byte>(env::kMaxPayload + 1, std::byte{0x42}));
+  link.send_frame('R', op_frame(0x0001, 5));
+  char kind = 0;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(server.wait_pop(kind, got));
+  EXPECT_EQ(got, op_frame(0x0001, 5));
+  EXPECT_EQ(link.stats().fragmented, 1u);
+  EXPECT_EQ(link.stats().shed_unsupported, 2u);  // both fragments of the run
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, LinksShareAnIoPool)
+{
+  FakeKoreServer s1, s2;
+  const uint16_t p1 = s1.start();
+  const uint16_t p2 = s2.start();
+
+  TestLogger log;
+  arkan::relay::infrastructure::net::IoPool pool(3);
+  ASSERT_EQ(pool.size(), 3u);
+
+  std::atomic<int> got{0};
+  std::atomic<bool> off_pool{false};
+  auto count = [&](char k, std::span<const std::byte>)
+  {
+    if (k != 'R') return;
+    if (!pool.running_in_this_thread()) off_pool = true;
+    ++got;
+  };
+
+  {
+    arkan::relay::infrastructure::link::KoreLink_Asio a(log, pool), b(log, pool);
+    a.on_frame(count);
+    b.on_frame(count);
+
+    const std::string host = "127.0.0.1";
+    a.set_candidate_ports({p1});
+    b.set_candidate_ports({p2});
+    a.connect(host, p1);
+    b.connect(host, p2);
+    ASSERT_TRUE(s1.wait_connected(std::chrono::milliseconds(2000)));
+    ASSERT_TRUE(s2.wait_connected(std::chrono::milliseconds(2000)));
+
+    const auto payload = bytes_from("pooled");
+    for (int i = 0; i < 50; ++i)
+    {
+      s1.send_frame('R', payload);
+      s2.send_frame('R', payload);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (got < 100 && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(got, 100);
+
+    // both links still have writes in flight when they go out of scope
+    std::vector<std::byte> bulk(4096, std::byte{0x5A});
+    for (int i = 0; i < 200; ++i)
+    {
+      a.send_frame('R', bulk);
+      b.send_frame('R', bulk);
+    }
+  }
+  EXPECT_FALSE(off_pool);
+
+  // the pool outlives its links and keeps serving other work
+  std::promise<void> ran;
+  boost::asio::post(pool.executor(), [&] { ran.set_value(); });
+  EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+  s1.stop();
+  s2.stop();
+}
+
+TEST(KoreLinkAsio, SteadyStateForwardingDoesNotAllocate)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  // the link's only I/O thread counts its allocations, the test thread counts send_frame()'s
+  arkan::relay::infrastructure::net::IoPool pool(1);
+  std::promise<void> armed;
+  boost::asio::post(pool.executor(),
+                    [&]
+                    {
+                      t_count_allocs = true;
+                      armed.set_value();
+                    });
+  armed.get_future().wait();
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log, pool);
+  std::atomic<int> received{0};
+  link.on_frame(
+      [&](char k, std::span<const std::byte>)
+      {
+        if (k == 'R') ++received;
+      });
+
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // one frame each way per round, so every round is a full write + read cycle on the link
+  const std::vector<std::byte> payload(64, std::byte{0x42});
+  auto rounds = [&](int n)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      const int want = received + 1;
+      t_count_allocs = true;
+      link.send_frame('R', payload);
+      t_count_allocs = false;
+      server.send_frame('R', payload);
+
+      char kind;
+      std::vector<std::byte> got;
+      ASSERT_TRUE(server.wait_pop(kind, got)) << "round " << i;
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+      while (received < want && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+      ASSERT_EQ(received, want) << "round " << i;
+    }
+  };
+
+  // warm-up: buffers and recycled handler blocks reach their steady size
+  rounds(200);
+  g_allocs = 0;
+  rounds(500);
+  EXPECT_EQ(g_allocs.load(), 0u);
+
+  link.close();
+  server.stop();
+}
+
+TEST(KoreLinkAsio, BusyPollPoolReportsEmitToWriteLatency)
+{
+  FakeKoreServer server;
+  const uint16_t port = server.start();
+
+  arkan::relay::infrastructure::net::IoPoolOptions po;
+  po.spin = std::chrono::microseconds(2000);
+  arkan::relay::infrastructure::net::IoPool pool(po);
+
+  TestLogger log;
+  arkan::relay::infrastructure::link::KoreLink_Asio link(log, pool);
+  const std::string host = "127.0.0.1";
+  link.set_candidate_ports({port});
+  link.connect(host, port);
+  ASSERT_TRUE(server.wait_connected(std::chrono::milliseconds(2000)));
+
+  // one frame at a time: every frame is a separate emit -> write sample
+  const auto payload = bytes_from("trickle");
+  for (int i = 0; i < 50; ++i)
+  {
+    link.send_frame('R', payload);
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(server.wait_pop(kind, got)) << "frame " << i;
+  }
+
+  const auto st = link.stats();
+  EXPECT_EQ(st.emit_to_write_samples, 50u);
+  EXPECT_LE(st.emit_to_write_p50_us, st.emit_to_write_p99_us);
+  EXPECT_LT(st.emit_to_write_p99_us, 1000000u);
+
+  link.close();
+  server.stop();
+}
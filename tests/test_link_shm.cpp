@@ -0,0 +1,472 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "application/ports/ILogger.hpp"
+#include "domain/protocol/Envelope.hpp"
+#include "infrastructure/link/FragmentAssembler.hpp"
+#include "infrastructure/link/FrameReader.hpp"
+#include "infrastructure/link/KoreLink_Shm.hpp"
+#include "infrastructure/link/ShmChannel.hpp"
+
+using arkan::relay::infrastructure::link::FragmentAssembler;
+using arkan::relay::infrastructure::link::FrameReader;
+using arkan::relay::infrastructure::link::KoreLink_Shm;
+using arkan::relay::infrastructure::link::ShmChannel;
+
+// ----------------------------- Helpers -----------------------------
+static inline void put_u16_le(std::byte* dst, uint16_t v)
+{
+  dst[0] = static_cast<std::byte>(v & 0xFF);
+  dst[1] = static_cast<std::byte>((v >> 8) & 0xFF);
+}
+
+static inline uint16_t get_u16_le(const std::byte* p)
+{
+  return static_cast<uint16_t>(std::to_integer<unsigned char>(p[0])) |
+         (static_cast<uint16_t>(std::to_integer<unsigned char>(p[1])) << 8);
+}
+
+static std::vector<std::byte> bytes_from(const std::string& s)
+{
+  return std::vector<std::byte>(reinterpret_cast<const std::byte*>(s.data()),
+                                reinterpret_cast<const std::byte*>(s.data()) + s.size());
+}
+
+// ----------------------------- Test Logger (no-op) -----------------------------
+struct TestLogger : arkan::relay::application::ports::ILogger
+{
+  using LogLevel = arkan::relay::application::ports::LogLevel;
+  void init(const arkan::relay::domain::Settings&) override {}
+  void app(LogLevel, const std::string&) override {}
+  void sock(LogLevel, std::string_view) override {}
+};
+
+// ----------------------------- Fake Kore peer -----------------------------
+// Plays Kore's side of the segment: the same ShmChannel opened with Role::kore.
+class FakeKorePeer
+{
+ public:
+  explicit FakeKorePeer(uint16_t port) : name_(KoreLink_Shm::segment_name(port))
+  {
+    ShmChannel::remove(name_);
+  }
+
+  ~FakeKorePeer()
+  {
+    stop();
+    ShmChannel::remove(name_);
+  }
+
+  bool start(std::size_t ring_bytes = ShmChannel::kDefaultRingBytes)
+  {
+    if (!chan_.open(name_, ShmChannel::Role::kore, ring_bytes)) return false;
+    running_ = true;
+    th_read_ = std::thread([this] { read_loop_(); });
+    return true;
+  }
+
+  void stop()
+  {
+    running_ = false;
+    chan_.wake();
+    if (th_read_.joinable()) th_read_.join();
+    chan_.close();
+  }
+
+  // Wait until the relay side is attached (or timeout)
+  bool wait_connected(std::chrono::milliseconds to = std::chrono::milliseconds(2000))
+  {
+    const auto until = std::chrono::steady_clock::now() + to;
+    while (!chan_.peer_attached())
+    {
+      if (std::chrono::steady_clock::now() >= until) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+  }
+
+  void send_frame(char kind, std::span<const std::byte> payload)
+  {
+    std::vector<std::byte> buf(3 + payload.size());
+    buf[0] = static_cast<std::byte>(kind);
+    put_u16_le(buf.data() + 1, static_cast<uint16_t>(payload.size()));
+    if (!payload.empty()) std::memcpy(buf.data() + 3, payload.data(), payload.size());
+    send_raw(buf);
+  }
+
+  // Writes raw bytes as-is (lets tests coalesce or split frames in the ring)
+  void send_raw(std::span<const std::byte> bytes)
+  {
+    std::lock_guard<std::mutex> lk(tx_);
+    while (!chan_.write(bytes)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  bool wait_pop(char& kind, std::vector<std::byte>& payload,
+                std::chrono::milliseconds to = std::chrono::milliseconds(1500))
+  {
+    std::unique_lock<std::mutex> lk(m_);
+    if (!cv_.wait_for(lk, to, [&] { return !q_.empty(); })) return false;
+    auto v = std::move(q_.front());
+    q_.pop();
+    kind = v.first;
+    payload = std::move(v.second);
+    return true;
+  }
+
+  // Stop draining the relay -> Kore ring (lets tests fill it up)
+  void pause(bool p)
+  {
+    paused_ = p;
+    chan_.wake();
+  }
+
+ private:
+  void read_loop_()
+  {
+    FrameReader reader;
+    while (running_)
+    {
+      std::size_t n = 0;
+      if (!paused_)
+      {
+        const auto buf = reader.prepare();
+        n = chan_.read(std::span<std::byte>(static_cast<std::byte*>(buf.data()), buf.size()));
+        reader.commit(n);
+      }
+      if (n == 0)
+      {
+        chan_.wait(std::chrono::milliseconds(20));
+        continue;
+      }
+
+      char k = 0;
+      std::span<const std::byte> p;
+      while (reader.next(k, p))
+      {
+        {
+          std::lock_guard<std::mutex> lk(m_);
+          q_.emplace(k, std::vector<std::byte>(p.begin(), p.end()));
+        }
+        cv_.notify_one();
+      }
+    }
+  }
+
+  std::string name_;
+  ShmChannel chan_;
+  std::thread th_read_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> paused_{false};
+  std::mutex tx_;
+
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::queue<std::pair<char, std::vector<std::byte>>> q_;
+};
+
+// ----------------------------- Tests -----------------------------
+
+TEST(KoreLinkShm, SendsFramesToKore)
+{
+  constexpr uint16_t port = 47101;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start());
+
+  TestLogger log;
+  KoreLink_Shm link(log);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  // 'S' frames are not forwarded to Kore
+  link.send_frame('S', bytes_from("dropped"));
+  auto payload = bytes_from("hello");
+  link.send_frame('R', payload);
+
+  char kind;
+  std::vector<std::byte> got;
+  ASSERT_TRUE(kore.wait_pop(kind, got));
+  EXPECT_EQ(kind, 'R');
+  ASSERT_EQ(got.size(), payload.size());
+  EXPECT_TRUE(std::equal(got.begin(), got.end(), payload.begin(), payload.end()));
+
+  link.close();
+}
+
+TEST(KoreLinkShm, ReceivesFramesFromKore)
+{
+  constexpr uint16_t port = 47102;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start());
+
+  TestLogger log;
+  KoreLink_Shm link(log);
+
+  std::mutex m;
+  std::condition_variable cv;
+  bool got = false;
+  char kind = '?';
+  std::vector<std::byte> data;
+
+  link.on_frame(
+      [&](char k, std::span<const std::byte> p)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        kind = k;
+        data.assign(p.begin(), p.end());
+        got = true;
+        cv.notify_one();
+      });
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  auto payload = bytes_from("from-kore");
+  kore.send_frame('R', payload);
+
+  {
+    std::unique_lock<std::mutex> lk(m);
+    ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(2000), [&] { return got; }));
+  }
+
+  EXPECT_EQ(kind, 'R');
+  ASSERT_EQ(data.size(), payload.size());
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), payload.begin(), payload.end()));
+
+  link.close();
+}
+
+TEST(KoreLinkShm, BacklogKeepsOrderWhileRingIsFull)
+{
+  constexpr uint16_t port = 47103;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start(ShmChannel::kMinRingBytes));
+
+  TestLogger log;
+  KoreLink_Shm link(log, ShmChannel::kMinRingBytes);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  // Kore stalls: far more data than the ring holds has to wait in the backlog
+  kore.pause(true);
+  constexpr int kFrames = 2000;
+  for (int i = 0; i < kFrames; ++i)
+  {
+    std::vector<std::byte> p(2 + (i * 37) % 700, static_cast<std::byte>(i & 0xFF));
+    put_u16_le(p.data(), static_cast<uint16_t>(i));
+    link.send_frame('R', p);
+  }
+  EXPECT_GT(link.stats().backlogged, 0u);
+  kore.pause(false);
+
+  for (int i = 0; i < kFrames; ++i)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(kore.wait_pop(kind, got)) << "frame " << i;
+    EXPECT_EQ(kind, 'R');
+    ASSERT_GE(got.size(), 2u);
+    EXPECT_EQ(get_u16_le(got.data()), static_cast<uint16_t>(i));
+  }
+
+  const auto st = link.stats();
+  EXPECT_EQ(st.frames_written, static_cast<uint64_t>(kFrames));
+  EXPECT_EQ(st.shed_overflow, 0u);
+
+  link.close();
+}
+
+TEST(KoreLinkShm, ManyProducersKeepPerProducerOrder)
+{
+  constexpr uint16_t port = 47104;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start());
+
+  TestLogger log;
+  KoreLink_Shm link(log);
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  // payload = [producer id][seq16][filler...]; reserve() is not offered, callers fall back
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 500;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kProducers; ++t)
+  {
+    producers.emplace_back(
+        [&link, t]
+        {
+          for (int i = 0; i < kPerProducer; ++i)
+          {
+            const std::size_t len = 3 + (i % 200);
+            auto r = link.reserve('R', len);
+            EXPECT_FALSE(r);
+            std::vector<std::byte> p(len, std::byte{0xAB});
+            p[0] = static_cast<std::byte>(t);
+            put_u16_le(p.data() + 1, static_cast<uint16_t>(i));
+            link.send_frame('R', p);
+          }
+        });
+  }
+  for (auto& th : producers) th.join();
+
+  std::array<int, kProducers> next{};
+  for (int n = 0; n < kProducers * kPerProducer; ++n)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(kore.wait_pop(kind, got)) << "frame " << n;
+    ASSERT_EQ(kind, 'R');
+    ASSERT_GE(got.size(), 3u);
+    const int t = std::to_integer<int>(got[0]);
+    ASSERT_LT(t, kProducers);
+    EXPECT_EQ(get_u16_le(got.data() + 1), static_cast<uint16_t>(next[t]));
+    ++next[t];
+  }
+
+  link.close();
+}
+
+TEST(KoreLinkShm, ParsesCoalescedAndSplitFrames)
+{
+  constexpr uint16_t port = 47105;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start());
+
+  TestLogger log;
+  KoreLink_Shm link(log);
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<std::pair<char, std::vector<std::byte>>> frames;
+
+  link.on_frame(
+      [&](char k, std::span<const std::byte> p)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        frames.emplace_back(k, std::vector<std::byte>(p.begin(), p.end()));
+        cv.notify_one();
+      });
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  // 100 small 'S' frames + one empty 'K' + one 40000-byte 'S', published in uneven pieces
+  std::vector<std::byte> wire;
+  auto append = [&](char k, std::size_t n, std::byte fill)
+  {
+    const std::size_t at = wire.size();
+    wire.resize(at + 3 + n, fill);
+    wire[at] = static_cast<std::byte>(k);
+    put_u16_le(wire.data() + at + 1, static_cast<uint16_t>(n));
+  };
+  for (int i = 0; i < 100; ++i) append('S', 4 + i % 8, static_cast<std::byte>(i));
+  append('K', 0, std::byte{0});
+  append('S', 40000, std::byte{0x5A});
+
+  const std::size_t cuts[] = {1, 2, 7, 250, 1000, 20000};
+  std::size_t off = 0;
+  for (std::size_t c : cuts)
+  {
+    kore.send_raw(std::span<const std::byte>(wire.data() + off, c));
+    off += c;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  kore.send_raw(std::span<const std::byte>(wire.data() + off, wire.size() - off));
+
+  std::unique_lock<std::mutex> lk(m);
+  ASSERT_TRUE(
+      cv.wait_for(lk, std::chrono::milliseconds(3000), [&] { return frames.size() == 102u; }));
+
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(frames[i].first, 'S');
+    ASSERT_EQ(frames[i].second.size(), static_cast<std::size_t>(4 + i % 8));
+    EXPECT_EQ(frames[i].second.front(), static_cast<std::byte>(i));
+  }
+  EXPECT_EQ(frames[100].first, 'K');
+  EXPECT_TRUE(frames[100].second.empty());
+  EXPECT_EQ(frames[101].first, 'S');
+  ASSERT_EQ(frames[101].second.size(), 40000u);
+  EXPECT_EQ(frames[101].second.back(), std::byte{0x5A});
+  lk.unlock();
+
+  link.close();
+}
+
+TEST(KoreLinkShm, JumboFramesTravelAsFragmentRuns)
+{
+  namespace env = arkan::relay::domain::protocol::envelope;
+  constexpr uint16_t port = 47106;
+  FakeKorePeer kore(port);
+  ASSERT_TRUE(kore.start(ShmChannel::kMinRingBytes));
+
+  TestLogger log;
+  KoreLink_Shm link(log, ShmChannel::kMinRingBytes);
+
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<std::pair<char, std::vector<std::byte>>> frames;
+  link.on_frame(
+      [&](char k, std::span<const std::byte> p)
+      {
+        std::lock_guard<std::mutex> lk(m);
+        frames.emplace_back(k, std::vector<std::byte>(p.begin(), p.end()));
+        cv.notify_one();
+      });
+
+  link.set_candidate_ports({port});
+  link.connect("127.0.0.1", port);
+  ASSERT_TRUE(kore.wait_connected());
+
+  std::vector<std::byte> big(300000);
+  for (std::size_t i = 0; i < big.size(); ++i) big[i] = static_cast<std::byte>(i * 13 & 0xFF);
+
+  // relay -> Kore: one 'F' run, larger than the ring, reassembled on Kore's side
+  link.send_frame('R', big);
+  FragmentAssembler fa;
+  for (;;)
+  {
+    char kind;
+    std::vector<std::byte> got;
+    ASSERT_TRUE(kore.wait_pop(kind, got));
+    ASSERT_EQ(kind, env::kFragment);
+    std::span<const std::byte> out;
+    if (!fa.feed(got, kind, out)) continue;
+    EXPECT_EQ(kind, 'R');
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), big.begin(), big.end()));
+    break;
+  }
+
+  // Kore -> relay: delivered as a single 'S' frame
+  env::for_each_fragment('S', big,
+                         [&](std::span<const std::byte> head, std::span<const std::byte> chunk)
+                         {
+                           kore.send_raw(head);
+                           kore.send_raw(chunk);
+                         });
+
+  std::unique_lock<std::mutex> lk(m);
+  ASSERT_TRUE(cv.wait_for(lk, std::chrono::milliseconds(3000), [&] { return !frames.empty(); }));
+  EXPECT_EQ(frames.size(), 1u);
+  EXPECT_EQ(frames[0].first, 'S');
+  EXPECT_EQ(frames[0].second, big);
+  lk.unlock();
+
+  link.close();
+}
@@ -1,14 +1,28 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <boost/filesystem.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <thread>
+#include <vector>
 
 #include "application/ports/ILogger.hpp"
 #include "domain/Settings.hpp"
+#include "infrastructure/logging/FlightRecorder.hpp"
 #include "infrastructure/logging/Logger_Spdlog.hpp"
+#include "infrastructure/logging/PacketLog.hpp"
 
+using arkan::relay::application::ports::FlightEvent;
 using arkan::relay::application::ports::LogLevel;
 using arkan::relay::domain::Settings;
+using arkan::relay::infrastructure::logging::FlightRecorder;
 using arkan::relay::infrastructure::logging::Logger_Spdlog;
+using arkan::relay::infrastructure::logging::PacketLog;
+using arkan::relay::infrastructure::logging::PacketRecord;
 namespace fs = boost::filesystem;
 
 static fs::path tmp_dir(const std::string& name)
@@ -39,3 +53,402 @@ TEST(LoggerSpdlog, CreatesFilesAndIsIdempotent)
 
   EXPECT_NO_THROW(log.init(s));
 }
+
+TEST(LoggerSpdlog, DeferredSocketLinesAreGatedAndFormattedLater)
+{
+  Settings s;
+  auto dir = tmp_dir("deferred");
+  s.logsDir = dir.string();
+  s.appLogFilename = "app.log";
+  s.socketLogFilename = "socket.log";
+  s.showConsole = false;
+  s.saveLog = false;
+  s.saveSocketLog = true;
+  fs::remove(dir / "socket.log");
+
+  {
+    Logger_Spdlog log;
+    log.init(s);
+    log.set_level(LogLevel::warn);
+    EXPECT_FALSE(log.enabled(LogLevel::info));
+    EXPECT_TRUE(log.enabled(LogLevel::warn));
+
+    const std::byte bytes[] = {std::byte{0x7D}, std::byte{0x00}, std::byte{0xAB}};
+    log.sockf(LogLevel::info, "skipped {}", 1);
+    log.sockf(LogLevel::warn, "frame kind={} len={} {{x}} [{}]", 'R', 3u,
+              arkan::relay::application::ports::LogHex{bytes});
+  }  // the destructor hands the deferred lines to spdlog
+
+  // spdlog's own async worker writes them out shortly after
+  std::string text;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (text.find("frame kind=") == std::string::npos &&
+         std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::ifstream in((dir / "socket.log").string());
+    text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  EXPECT_EQ(text.find("skipped"), std::string::npos);
+  EXPECT_NE(text.find("frame kind=R len=3 {x} [7D 00 AB ]"), std::string::npos);
+}
+
+TEST(PacketLog, RecordsRoundTripAndRenderAsTextLines)
+{
+  auto dir = tmp_dir("packets");
+  fs::remove_all(dir);
+
+  std::vector<std::byte> big(300);
+  for (std::size_t i = 0; i < big.size(); ++i) big[i] = static_cast<std::byte>(i);
+  const std::byte small[] = {std::byte{0x8A}, std::byte{0x00}, std::byte{0xFF}};
+
+  {
+    PacketLog log;
+    ASSERT_TRUE(log.open(dir.string(), "relay_socket"));
+    log.append('R', 42, small);
+    log.append('S', 42, big);
+    EXPECT_EQ(log.records(), 2u);
+  }
+
+  const auto files = PacketLog::segments(dir.string(), "relay_socket");
+  ASSERT_EQ(files.size(), 1u);
+
+  std::vector<PacketRecord> got;
+  ASSERT_TRUE(PacketLog::read(files[0], [&](const PacketRecord& r) { got.push_back(r); }));
+  ASSERT_EQ(got.size(), 2u);
+
+  EXPECT_EQ(got[0].dir, 'R');
+  EXPECT_EQ(got[0].socket, 42u);
+  EXPECT_EQ(got[0].opcode, 0x008Au);
+  EXPECT_EQ(got[0].length, 3u);
+  const std::string line = PacketLog::render(got[0]);
+  EXPECT_EQ(line.substr(0, 1), "[");
+  EXPECT_NE(line.find("] [socket] [info] RECV \xE2\x86\x90 8A 00 FF "), std::string::npos);
+
+  // cut like the text line; past what the record kept, the total still shows
+  EXPECT_EQ(got[1].length, 300u);
+  EXPECT_EQ(got[1].stored, PacketRecord::kDataBytes);
+  EXPECT_NE(PacketLog::render(got[1], 2).find("SEND \xE2\x86\x92 00 01 ...(300 bytes total)"),
+            std::string::npos);
+  EXPECT_NE(PacketLog::render(got[1], 0).find("E7 ...(300 bytes total)"), std::string::npos);
+}
+
+TEST(PacketLog, RotatesSegmentsAndContinuesAfterEarlierRuns)
+{
+  auto dir = tmp_dir("packets-rotate");
+  fs::remove_all(dir);
+  const std::byte b[] = {std::byte{0x01}, std::byte{0x02}};
+
+  {
+    PacketLog log;
+    ASSERT_TRUE(log.open(dir.string(), "s", 4, 2));
+    for (int i = 0; i < 10; ++i)
+    {
+      log.append('R', static_cast<uint64_t>(i), b);
+      log.prepare();  // the logger's formatter thread does this
+    }
+  }
+  // 10 records in segments of 4: 0..2 written, only the newest 2 kept
+  auto files = PacketLog::segments(dir.string(), "s");
+  ASSERT_EQ(files.size(), 2u);
+  std::vector<uint64_t> sockets;
+  for (const auto& f : files)
+    PacketLog::read(f, [&](const PacketRecord& r) { sockets.push_back(r.socket); });
+  EXPECT_EQ(sockets, (std::vector<uint64_t>{4, 5, 6, 7, 8, 9}));
+
+  // a new run starts a new segment after them
+  {
+    PacketLog log;
+    ASSERT_TRUE(log.open(dir.string(), "s", 4, 2));
+    log.append('S', 100, b);
+  }
+  files = PacketLog::segments(dir.string(), "s");
+  ASSERT_EQ(files.size(), 2u);
+  EXPECT_NE(files[1].find("s-00000003.pkt"), std::string::npos);
+}
+
+TEST(PacketLog, AppendNeverCreatesSegmentsItself)
+{
+  auto dir = tmp_dir("packets-spare");
+  fs::remove_all(dir);
+  const std::byte b[] = {std::byte{0x01}, std::byte{0x02}};
+
+  PacketLog log;
+  ASSERT_TRUE(log.open(dir.string(), "s", 4, 8));
+  EXPECT_EQ(PacketLog::segments(dir.string(), "s").size(), 2u);  // the next one is ready
+
+  // one segment's worth goes into the spare; past that, records wait for prepare() or drop
+  for (int i = 0; i < 10; ++i) log.append('R', static_cast<uint64_t>(i), b);
+  EXPECT_EQ(log.records(), 8u);
+  EXPECT_EQ(log.dropped(), 2u);
+  EXPECT_EQ(PacketLog::segments(dir.string(), "s").size(), 2u);
+
+  log.prepare();
+  log.append('R', 10, b);
+  EXPECT_EQ(log.records(), 9u);
+  EXPECT_EQ(PacketLog::segments(dir.string(), "s").size(), 3u);
+
+  // the unused spare goes with the log
+  log.close();
+  EXPECT_EQ(PacketLog::segments(dir.string(), "s").size(), 3u);
+}
+
+TEST(LoggerSpdlog, BinarySocketFormatWritesPacketRecords)
+{
+  Settings s;
+  auto dir = tmp_dir("binary");
+  fs::remove_all(dir);
+  s.logsDir = dir.string();
+  s.socketLogFilename = "socket.log";
+  s.socketLogFormat = "binary";
+  s.showConsole = false;
+
+  const std::byte b[] = {std::byte{0x7D}, std::byte{0x00}};
+  {
+    Logger_Spdlog log;
+    log.init(s);
+    log.sock_packet(arkan::relay::application::ports::PacketDir::send, 7, b);
+  }
+
+  const auto files = PacketLog::segments(dir.string(), "socket");
+  ASSERT_EQ(files.size(), 1u);
+  std::size_t n = 0;
+  PacketLog::read(files[0], [&](const PacketRecord& r) { n += r.socket == 7 && r.dir == 'S'; });
+  EXPECT_EQ(n, 1u);
+}
+
+namespace
+{
+// socket.log text once the async writers caught up with `expect` lines containing `needle`
+std::string wait_socket_log(const fs::path& file, const std::string& needle, std::size_t expect)
+{
+  std::string text;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  for (;;)
+  {
+    std::ifstream in(file.string());
+    text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    std::size_t n = 0;
+    for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) ++n;
+    if (n >= expect || std::chrono::steady_clock::now() >= deadline) return text;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+}
+
+std::size_t count_of(const std::string& text, const std::string& needle)
+{
+  std::size_t n = 0;
+  for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) ++n;
+  return n;
+}
+
+Settings socket_only(const fs::path& dir)
+{
+  Settings s;
+  s.logsDir = dir.string();
+  s.socketLogFilename = "socket.log";
+  s.showConsole = false;
+  fs::remove(dir / "socket.log");
+  return s;
+}
+}  // namespace
+
+TEST(LoggerSpdlog, StagesLinesFromManyThreadsWithoutLosingThem)
+{
+  auto dir = tmp_dir("staged");
+  Settings s = socket_only(dir);
+  Logger_Spdlog::Stats st;
+  {
+    Logger_Spdlog log;
+    log.init(s);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+      threads.emplace_back(
+          [&log, t]
+          {
+            for (int i = 0; i < 100; ++i)
+            {
+              log.sockf(LogLevel::info, "staged t={} i={}", t, i);
+              if (i % 32 == 31) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+          });
+    for (auto& th : threads) th.join();
+    st = log.stats();
+  }
+  EXPECT_EQ(st.staged_dropped, 0u);
+  EXPECT_EQ(count_of(wait_socket_log(dir / "socket.log", "staged t=", 400), "staged t="), 400u);
+}
+
+TEST(LoggerSpdlog, StagesOfExitedThreadsAreReusedAndSurviveReinit)
+{
+  auto dir = tmp_dir("stage-reuse");
+  Settings s = socket_only(dir);
+  Logger_Spdlog::Stats st;
+  {
+    Logger_Spdlog log;
+    log.init(s);
+
+    // far more threads than stages over time, one at a time
+    for (int t = 0; t < 100; ++t)
+      std::thread([&log, t] { log.sockf(LogLevel::info, "short-lived t={}", t); }).join();
+
+    // a thread keeps its stage across init(): what it logs after it still gets through
+    std::atomic<int> step{0};
+    std::thread kept(
+        [&]
+        {
+          log.sockf(LogLevel::info, "kept before");
+          step = 1;
+          while (step.load() != 2) std::this_thread::yield();
+          log.sockf(LogLevel::info, "kept after");
+        });
+    while (step.load() != 1) std::this_thread::yield();
+    log.init(s);
+    step = 2;
+    kept.join();
+    st = log.stats();
+  }
+  EXPECT_EQ(st.staged_dropped, 0u);
+  const std::string text = wait_socket_log(dir / "socket.log", "kept after", 1);
+  EXPECT_EQ(count_of(text, "short-lived t="), 100u);
+  EXPECT_EQ(count_of(text, "kept before"), 1u);
+  EXPECT_EQ(count_of(text, "kept after"), 1u);
+}
+
+TEST(LoggerSpdlog, RateLimitsWarningsPerSiteAndSamplesInfoLines)
+{
+  auto dir = tmp_dir("limits");
+  Settings s = socket_only(dir);
+  s.socketRateLimit = 3;
+  s.socketSampleEvery = 4;
+  Logger_Spdlog::Stats st;
+  {
+    Logger_Spdlog log;
+    log.init(s);
+    for (int i = 0; i < 10; ++i) log.sockf(LogLevel::warn, "inject failed #{}", i);
+    for (int i = 0; i < 8; ++i) log.sockf(LogLevel::info, "sampled #{}", i);
+    // another site has its own budget
+    log.sockf(LogLevel::warn, "other warning");
+    st = log.stats();
+  }
+  // a second may end mid-burst: 3 get through, or up to 6 across the two windows
+  EXPECT_GE(st.rate_limited, 4u);
+  EXPECT_LE(st.rate_limited, 7u);
+  EXPECT_EQ(st.sampled_out, 6u);
+
+  const std::string text = wait_socket_log(dir / "socket.log", "other warning", 1);
+  EXPECT_EQ(count_of(text, "inject failed #"), 10u - st.rate_limited);
+  EXPECT_EQ(count_of(text, "sampled #"), 2u);
+  EXPECT_NE(text.find("sampled #0"), std::string::npos);
+  EXPECT_NE(text.find("sampled #4"), std::string::npos);
+  EXPECT_EQ(count_of(text, "other warning"), 1u);
+}
+
+namespace
+{
+std::span<const std::byte> bytes_of(const std::string& s)
+{
+  return std::as_bytes(std::span<const char>(s.data(), s.size()));
+}
+
+std::string read_text(const fs::path& file)
+{
+  std::ifstream in(file.string());
+  return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+TEST(FlightRecorder, DumpsEntriesOldestFirst)
+{
+  auto dir = tmp_dir("flight");
+  FlightRecorder rec(0, 0, dir.string());
+  EXPECT_EQ(rec.capacity(), FlightRecorder::kMinBytes);
+
+  const std::vector<std::byte> pkt{std::byte{0x7D}, std::byte{0x00}, std::byte{0xAB}};
+  std::vector<std::byte> big(100);
+  for (std::size_t i = 0; i < big.size(); ++i) big[i] = std::byte(i);
+
+  rec.record(FlightEvent::send, pkt);
+  rec.record(FlightEvent::state, bytes_of("new socket: counter=0"));
+  rec.record(FlightEvent::inject_recv, big);
+  EXPECT_EQ(rec.entries(), 3u);
+
+  const auto file = dir / "dump.txt";
+  ASSERT_TRUE(rec.dump_to(file.string().c_str(), "test"));
+  const std::string text = read_text(file);
+
+  const auto send = text.find("SEND        3 bytes\n  7D 00 AB\n");
+  const auto state = text.find("STATE       new socket: counter=0\n");
+  const auto inject = text.find("INJECT-RECV 100 bytes\n  00 01 02");
+  ASSERT_NE(send, std::string::npos);
+  ASSERT_NE(state, std::string::npos);
+  ASSERT_NE(inject, std::string::npos);
+  EXPECT_LT(send, state);
+  EXPECT_LT(state, inject);
+  // 32 bytes per line: the 100 bytes take four
+  EXPECT_NE(text.find(" 1F\n  20 21"), std::string::npos);
+  EXPECT_NE(text.find("  60 61 62 63\n"), std::string::npos);
+  EXPECT_NE(text.find("reason=test"), std::string::npos);
+  EXPECT_NE(text.find("# 3 entries"), std::string::npos);
+
+  // dump() names its own file after the reason
+  ASSERT_TRUE(rec.dump("kore request"));
+  std::size_t named = 0;
+  for (fs::directory_iterator it(dir), end; it != end; ++it)
+  {
+    const std::string name = it->path().filename().string();
+    named += name.rfind("flight-", 0) == 0 && name.find("-kore_request.txt") != std::string::npos;
+  }
+  EXPECT_GE(named, 1u);
+}
+
+TEST(FlightRecorder, KeepsOnlyTheNewestEntriesOnceFull)
+{
+  auto dir = tmp_dir("flight-wrap");
+  FlightRecorder rec(0, 0, dir.string());
+
+  // 200-byte packets take 4 slots: the 64 KiB ring holds the last 256
+  std::vector<std::byte> pkt(200);
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    std::memcpy(pkt.data(), &i, sizeof(i));
+    rec.record(FlightEvent::recv, pkt);
+  }
+
+  const auto file = dir / "dump.txt";
+  ASSERT_TRUE(rec.dump_to(file.string().c_str(), "wrap"));
+  const std::string text = read_text(file);
+  EXPECT_EQ(count_of(text, "RECV        200 bytes"), 256u);
+  EXPECT_NE(text.find("  E7 03 00 00"), std::string::npos);  // 999, the last one
+  EXPECT_NE(text.find("  E8 02 00 00"), std::string::npos);  // 744, the oldest one kept
+  EXPECT_EQ(text.find("  E7 02 00 00"), std::string::npos);  // 743 is gone
+
+  // an entry larger than a quarter of the ring is cut
+  rec.record(FlightEvent::send, std::vector<std::byte>(40000));
+  ASSERT_TRUE(rec.dump_to(file.string().c_str(), "cut"));
+  EXPECT_NE(read_text(file).find("SEND        40000 bytes (cut)"), std::string::npos);
+}
+
+TEST(FlightRecorder, RecordsFromManyThreads)
+{
+  auto dir = tmp_dir("flight-mt");
+  FlightRecorder rec(1u << 20, 60, dir.string());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back(
+        [&rec, t]
+        {
+          std::vector<std::byte> pkt(static_cast<std::size_t>(10 + t * 30), std::byte(0xA0 + t));
+          for (int i = 0; i < 500; ++i) rec.record(FlightEvent::send, pkt);
+        });
+  for (auto& th : threads) th.join();
+  EXPECT_EQ(rec.entries(), 2000u);
+
+  const auto file = dir / "dump.txt";
+  ASSERT_TRUE(rec.dump_to(file.string().c_str(), "mt"));
+  const std::string text = read_text(file);
+  EXPECT_EQ(count_of(text, "SEND        10 bytes\n  A0 A0"), 500u);
+  EXPECT_EQ(count_of(text, "SEND        100 bytes\n  A3 A3"), 500u);
+  EXPECT_NE(text.find("# 2000 entries"), std::string::npos);
+}
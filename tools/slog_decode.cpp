@@ -0,0 +1,78 @@
+// Offline decoder for the binary socket log (socketLogFormat = "binary").
+//
+// Prints the records of one or more PacketLog segment files as the text lines the socket channel
+// would have written:
+//   [2025-01-31 12:00:00.123] [socket] [info] RECV ← 8A 00 ...(26 bytes total)
+//
+// A directory argument stands for every *.pkt segment in it, oldest first.
+//
+// usage: arkan_relay_slog [--max=64] [--socket] <segment.pkt | logs-dir>...
+//   --max=N   : bytes shown per packet (0 = every byte kept in the record)
+//   --socket  : append " (socket=S opcode=0xOOOO)" to each line
+
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "infrastructure/logging/PacketLog.hpp"
+
+using arkan::relay::infrastructure::logging::PacketLog;
+using arkan::relay::infrastructure::logging::PacketRecord;
+
+int main(int argc, char** argv)
+{
+  std::size_t max_bytes = 64;
+  bool show_socket = false;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const char* a = argv[i];
+    if (std::strncmp(a, "--max=", 6) == 0)
+      max_bytes = std::strtoul(a + 6, nullptr, 10);
+    else if (std::strcmp(a, "--socket") == 0)
+      show_socket = true;
+    else if (boost::filesystem::is_directory(a))
+    {
+      const auto seg = PacketLog::segments(a);
+      files.insert(files.end(), seg.begin(), seg.end());
+    }
+    else
+      files.emplace_back(a);
+  }
+
+  if (files.empty())
+  {
+    std::fprintf(stderr,
+                 "usage: arkan_relay_slog [--max=64] [--socket] <segment.pkt | logs-dir>...\n");
+    return 2;
+  }
+
+  auto print = [&](const PacketRecord& r)
+  {
+    std::string line = PacketLog::render(r, max_bytes);
+    if (show_socket)
+    {
+      char b[64];
+      std::snprintf(b, sizeof(b), " (socket=%llu opcode=0x%04X)",
+                    static_cast<unsigned long long>(r.socket), static_cast<unsigned>(r.opcode));
+      line += b;
+    }
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), stdout);
+  };
+
+  int rc = 0;
+  for (const auto& f : files)
+  {
+    if (!PacketLog::read(f, print))
+    {
+      std::fprintf(stderr, "%s: not a socket log segment\n", f.c_str());
+      rc = 1;
+    }
+  }
+  return rc;
+}